@@ -32,6 +32,7 @@
 
 #include <iostream>
 #include <lsmio/lsmio.hpp>
+#include <vector>
 
 #include "bm_base.hpp"
 
@@ -47,6 +48,7 @@ class BMAdios : public BMBase {
     adios2::Engine _reader;
     adios2::Engine _writer;
     std::string _ioName;
+    std::vector<double> _array;
 
     virtual bool doRead(const std::string key, std::string *value) {
         adios2::Variable<std::string> varKey = _io.InquireVariable<std::string>(key);
@@ -64,6 +66,63 @@ class BMAdios : public BMBase {
         return true;
     }
 
+    // --array-size: every key is a local array of doubles instead of a string value
+    virtual int benchIteration(int iteration, bool opt) {
+        if (gConfigBM.arraySize == 0) return BMBase::benchIteration(iteration, opt);
+
+        int exitCode = 0;
+        int count;
+        long long duration;
+        const adios2::Mode putMode =
+            lsmio::gConfigLSMIO.alwaysFlush ? adios2::Mode::Sync : adios2::Mode::Deferred;
+        std::vector<double> readArray(gConfigBM.arraySize);
+
+        double bytes = (double)gConfigBM.keyCount * gConfigBM.arraySize * sizeof(double);
+        if (useMPI) bytes *= mpiSize;
+
+        _array.resize(gConfigBM.arraySize);
+        for (size_t i = 0; i < _array.size(); i++) _array[i] = mpiRank + i * 0.5;
+
+        writePrepare(opt);
+        if (gConfigBM.useMPIBarrier) MPI_Barrier(MPI_COMM_WORLD);
+        _bm.start();
+        for (count = 0; count < gConfigBM.keyCount; count++) {
+            adios2::Variable<double> var = _io.DefineVariable<double>(
+                _keyPrefix + "array:" + std::to_string(count), {}, {}, {gConfigBM.arraySize});
+            _writer.Put(var, _array.data(), putMode);
+        }
+        doWriteFinalize();
+        if (gConfigBM.useMPIBarrier) MPI_Barrier(MPI_COMM_WORLD);
+        _bm.stop();
+        _bm.addIteration("iwrite", _bm.duration(), bytes, gConfigBM.keyCount);
+        writeCleanup();
+
+        readPrepare(opt);
+        if (gConfigBM.useMPIBarrier) MPI_Barrier(MPI_COMM_WORLD);
+        _bm.start();
+        for (count = 0; count < gConfigBM.keyCount; count++) {
+            adios2::Variable<double> var =
+                _io.InquireVariable<double>(_keyPrefix + "array:" + std::to_string(count));
+            if (!var) break;
+            _reader.Get(var, readArray.data(), adios2::Mode::Sync);
+            if (readArray != _array) break;
+        }
+        doReadFinalize();
+        if (gConfigBM.useMPIBarrier) MPI_Barrier(MPI_COMM_WORLD);
+        _bm.stop();
+
+        duration = _bm.duration();
+        if (count != gConfigBM.keyCount) {
+            LOG(ERROR) << "ERROR: benchIteration(): array read failed." << std::endl;
+            duration = -1;
+            exitCode += 1;
+        }
+        _bm.addIteration("iread", duration, bytes, gConfigBM.keyCount);
+        readCleanup();
+
+        return exitCode;
+    }
+
     virtual int writePrepare(bool opt) {
         std::string fnPrefix = std::string("bm:plugin:") + std::to_string(gConfigBM.useLSMIOPlugin);
         _ioName = fnPrefix + "-writer";
@@ -230,6 +230,7 @@ std::string genOptionsToString() {
               << "\n iterations: " << gConfigBM.iterations
               << "\n segmentCount: " << gConfigBM.segmentCount
               << "\n keyCount: " << gConfigBM.keyCount << "\n valueSize: " << gConfigBM.valueSize
+              << "\n arraySize: " << gConfigBM.arraySize
               << "\n\n useBloomFilter: " << lsmio::gConfigLSMIO.useBloomFilter
               << "\n useSync: " << lsmio::gConfigLSMIO.useSync
               << "\n enableWAL: " << lsmio::gConfigLSMIO.enableWAL
@@ -246,7 +247,26 @@ std::string genOptionsToString() {
               << "\n writeFileSize: " << lsmio::gConfigLSMIO.writeFileSize
               << "\n preAllocate: " << lsmio::gConfigLSMIO.preAllocate
               << "\n disableAggDirStructure: " << lsmio::gConfigLSMIO.disableAggDirStructure
-              << "\n filePoolSize: " << lsmio::gConfigLSMIO.filePoolSize << "\n";
+              << "\n filePoolSize: " << lsmio::gConfigLSMIO.filePoolSize
+              << "\n clientTransport: " << lsmio::gConfigLSMIO.clientTransport
+              << "\n shmRingSize: " << lsmio::gConfigLSMIO.shmRingSize
+              << "\n ranksPerAggregator: " << lsmio::gConfigLSMIO.ranksPerAggregator
+              << "\n aggregatorsPerNode: " << lsmio::gConfigLSMIO.aggregatorsPerNode
+              << "\n numaAwareAggregation: " << lsmio::gConfigLSMIO.numaAwareAggregation
+              << "\n mpiAggType: " << lsmio::gConfigLSMIO.mpiAggType
+              << "\n globalWriters: " << lsmio::gConfigLSMIO.globalWriters
+              << "\n forwardBatchBytes: " << lsmio::gConfigLSMIO.forwardBatchBytes
+              << "\n emulatedNodes: " << lsmio::gConfigLSMIO.emulatedNodes
+              << "\n storeShards: " << lsmio::gConfigLSMIO.storeShards
+              << "\n shardByRank: " << lsmio::gConfigLSMIO.shardByRank
+              << "\n creditBytes: " << lsmio::gConfigLSMIO.creditBytes
+              << "\n creditMessages: " << lsmio::gConfigLSMIO.creditMessages
+              << "\n readCacheBytes: " << lsmio::gConfigLSMIO.readCacheBytes
+              << "\n readCacheData: " << lsmio::gConfigLSMIO.readCacheData
+              << "\n writeRestartIndex: " << lsmio::gConfigLSMIO.writeRestartIndex
+              << "\n traceDir: " << lsmio::gConfigLSMIO.traceDir
+              << "\n metricsDir: " << lsmio::gConfigLSMIO.metricsDir
+              << "\n metricsIntervalMs: " << lsmio::gConfigLSMIO.metricsIntervalMs << "\n";
 
     return optStream.str();
 }
@@ -275,6 +295,8 @@ int BMBase::beginMain(int argc, char **argv) {
                        "size of the value for a key (default: 64K)");
         app.add_option("-s,--segment-count", gConfigBM.segmentCount,
                        "segment count (default: 1024)");
+        app.add_option("--array-size", gConfigBM.arraySize,
+                       "doubles per variable for adios array runs (default: 0, strings)");
 
         app.add_flag("--lsmio-plugin", gConfigBM.useLSMIOPlugin,
                      "use lsmio plugin for adios benchmark (default: no plugin)");
@@ -317,11 +339,61 @@ int BMBase::beginMain(int argc, char **argv) {
                      "enable file pre-allocation (uses write buffer size)");
         app.add_option("--lsmio-pool", lsmio::gConfigLSMIO.filePoolSize,
                        "number of pre-allocated files (default: 4)");
+        bool flag_use_shm = false;
+        app.add_flag("--lsmio-shm", flag_use_shm,
+                     "use shared-memory rings between node-local clients and the aggregator");
+        app.add_option("--lsmio-shm-ring", lsmio::gConfigLSMIO.shmRingSize,
+                       "shared-memory ring size per client (default: 4M)");
+        bool flag_use_adios_comm = false;
+        app.add_flag("--lsmio-adios-transport", flag_use_adios_comm,
+                     "send commands to the aggregator through an ADIOS communicator");
+
+        app.add_option("--lsmio-agg-ratio", lsmio::gConfigLSMIO.ranksPerAggregator,
+                       "ranks per aggregator (default: 0, one aggregator per node)");
+        app.add_option("--lsmio-agg-per-node", lsmio::gConfigLSMIO.aggregatorsPerNode,
+                       "aggregators per node, overrides --lsmio-agg-ratio (default: 0)");
+        app.add_flag("--lsmio-agg-numa", lsmio::gConfigLSMIO.numaAwareAggregation,
+                     "group node-local aggregation by NUMA domain (default: no)");
+        bool flag_hierarchical = false;
+        app.add_flag("--lsmio-hierarchical", flag_hierarchical,
+                     "node leaders forward to global writers (default: no)");
+        app.add_option("--lsmio-global-writers", lsmio::gConfigLSMIO.globalWriters,
+                       "global writers for --lsmio-hierarchical (default: 1)");
+        app.add_option("--lsmio-forward-bytes", lsmio::gConfigLSMIO.forwardBatchBytes,
+                       "bytes per forwarded run (default: 8M)");
+        app.add_option("--lsmio-emulated-nodes", lsmio::gConfigLSMIO.emulatedNodes,
+                       "split ranks into this many pseudo-nodes (default: 0, real nodes)");
+        app.add_option("--lsmio-shards", lsmio::gConfigLSMIO.storeShards,
+                       "stores per aggregator (default: 1)");
+        app.add_flag("--lsmio-shard-by-rank", lsmio::gConfigLSMIO.shardByRank,
+                     "route aggregated keys to shards by source rank (default: hash)");
+        app.add_option("--lsmio-credit-bytes", lsmio::gConfigLSMIO.creditBytes,
+                       "bytes in flight per client, 0 disables (default: 0)");
+        app.add_option("--lsmio-credit-msgs", lsmio::gConfigLSMIO.creditMessages,
+                       "commands in flight per client, 0 disables (default: 0)");
+        app.add_option("--lsmio-read-cache", lsmio::gConfigLSMIO.readCacheBytes,
+                       "per-rank cache of remote reads, 0 disables (default: 4M)");
+        app.add_flag("--lsmio-read-cache-data", lsmio::gConfigLSMIO.readCacheData,
+                     "cache remote data reads too (default: metadata only)");
+        app.add_flag("--lsmio-restart-index", lsmio::gConfigLSMIO.writeRestartIndex,
+                     "write an index to read the data back with any rank count");
+        app.add_option("--lsmio-trace-dir", lsmio::gConfigLSMIO.traceDir,
+                       "write per-rank Chrome trace files of I/O spans to this directory");
+        app.add_option("--lsmio-metrics-dir", lsmio::gConfigLSMIO.metricsDir,
+                       "write per-rank Prometheus metrics files to this directory");
+        app.add_option("--lsmio-metrics-interval", lsmio::gConfigLSMIO.metricsIntervalMs,
+                       "milliseconds between metrics samples (default: 1000)");
 
         app.parse(argc, argv);
 
+        if (flag_use_shm)
+            lsmio::gConfigLSMIO.clientTransport = lsmio::ClientTransport::SharedMemory;
+        if (flag_use_adios_comm)
+            lsmio::gConfigLSMIO.clientTransport = lsmio::ClientTransport::Adios;
+
         lsmio::gConfigLSMIO.mpiAggType =
             flag_mpi_io_world ? lsmio::MPIAggType::Entire : lsmio::MPIAggType::Shared;
+        if (flag_hierarchical) lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Hierarchical;
 
         lsmio::gConfigLSMIO.storageType = lsmio::StorageType::NativeDB;
         if (flag_use_leveldb) 
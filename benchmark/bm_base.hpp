@@ -58,7 +58,7 @@ class BMBase {
 
     int benchRead(long long *duration);
     int benchWrite(long long *duration);
-    int benchIteration(int iteration, bool opt = false);
+    virtual int benchIteration(int iteration, bool opt = false);
 
     virtual bool doRead(const std::string key, std::string *value) = 0;
     virtual bool doWrite(const std::string key, const std::string value) = 0;
@@ -100,6 +100,7 @@ class BMConfig {
 
     int keyCount = 4096;
     int valueSize = 65535;
+    size_t arraySize = 0;  // bm_adios: doubles per array variable, 0 uses string values
 };
 
 std::string genOptionsToString();
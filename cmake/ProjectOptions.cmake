@@ -25,12 +25,14 @@ macro(lsmio_setup_options)
   option(LSMIO_BUILD_BENCHMARKS "Build LSMIO benchmarks" ON)
   option(LSMIO_BUILD_TESTS "Compile LSMIO tests" ON)
   option(LSMIO_ENABLE_COVERAGE "Enable code coverage reporting" OFF)
+  option(LSMIO_ENABLE_TRACE "Compile in hot-path trace points" OFF)
 
   if(NOT PROJECT_IS_TOP_LEVEL)
     mark_as_advanced(
       LSMIO_BUILD_BENCHMARKS
       LSMIO_BUILD_TESTS
       LSMIO_ENABLE_COVERAGE
+      LSMIO_ENABLE_TRACE
     )
   endif()
 
@@ -59,6 +61,7 @@ macro(lsmio_print_build_config)
   message("    Build LSMIO benchmarks: ${LSMIO_BUILD_BENCHMARKS}")
   message("    Compile LSMIO tests: ${LSMIO_BUILD_TESTS}")
   message("    Enable coverage: ${LSMIO_ENABLE_COVERAGE}")
+  message("    Enable trace points: ${LSMIO_ENABLE_TRACE}")
   message("  --")
   message("")
   message("")
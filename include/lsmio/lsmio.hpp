@@ -73,7 +73,8 @@ enum class MPIAggType {
     Shared,
     Entire,
     EntireSerial,
-    Split
+    Split,
+    Hierarchical
 };
 
 /**
@@ -85,6 +86,15 @@ enum class StorageType {
     RocksDB
 };
 
+/**
+ * Enum representing the transports between clients and their aggregator.
+ */
+enum class ClientTransport {
+    MPI,
+    SharedMemory,
+    Adios
+};
+
 /**
  * Configuration class for LSMIO settings.
  */
@@ -94,6 +104,42 @@ class LSMIOConfig {
     StorageType storageType = StorageType::NativeDB;
     /// @brief Default MPI aggregation type.
     MPIAggType mpiAggType = MPIAggType::Shared;
+    /// @brief Client transport (SharedMemory only applies to MPIAggType::Shared).
+    ClientTransport clientTransport = ClientTransport::MPI;
+    /// @brief Size of each shared-memory ring in bytes.
+    int shmRingSize = 4 * 1024 * 1024;
+    /// @brief Ranks served by one aggregator (0: whole node for Shared, 2 for Split).
+    int ranksPerAggregator = 0;
+    /// @brief Aggregators per node for Shared; overrides ranksPerAggregator when > 0.
+    int aggregatorsPerNode = 0;
+    /// @brief Group Shared aggregation by NUMA domain instead of node when supported.
+    bool numaAwareAggregation = false;
+    /// @brief Global writers for Hierarchical, each owning a hash partition of the keys.
+    int globalWriters = 1;
+    /// @brief Bytes a node leader buffers per global writer before forwarding a run.
+    int forwardBatchBytes = 8 * 1024 * 1024;
+    /// @brief Split the world into this many contiguous pseudo-nodes (0: real nodes).
+    int emulatedNodes = 0;
+    /// @brief Stores opened side by side by each aggregator (1: no sharding).
+    int storeShards = 1;
+    /// @brief Route aggregated keys to shards by source rank instead of by hash.
+    bool shardByRank = false;
+    /// @brief Bytes a client may have in flight to its aggregator (0: unlimited, e.g. 64M).
+    int creditBytes = 0;
+    /// @brief Commands a client may have in flight to its aggregator (0: unlimited, e.g. 1024).
+    int creditMessages = 0;
+    /// @brief Bytes of remote metadata reads cached per rank (0: disabled).
+    int readCacheBytes = 4 * 1024 * 1024;
+    /// @brief Flag to also cache remote data reads, not only metadata.
+    bool readCacheData = false;
+    /// @brief Write an index on close so the data can be read back by any number of ranks.
+    bool writeRestartIndex = false;
+    /// @brief Directory for per-rank Chrome trace files of I/O spans (empty: disabled).
+    std::string traceDir = "";
+    /// @brief Directory for per-rank Prometheus text files of live metrics (empty: disabled).
+    std::string metricsDir = "";
+    /// @brief Interval between two metrics samples in milliseconds.
+    int metricsIntervalMs = 1000;
 
     // General settings
     /// @brief Flag to disable creating agg/<rank> subdirectory structure.
@@ -189,6 +235,13 @@ std::string to_string(const MPIAggType v);
  */
 std::string to_string(const StorageType v);
 
+/**
+ * Convert a ClientTransport value to its string representation.
+ * @param v ClientTransport value.
+ * @return String representation of v.
+ */
+std::string to_string(const ClientTransport v);
+
 }  // namespace lsmio
 
 /// Stream overload for MPIAggType.
@@ -197,6 +250,9 @@ std::ostream &operator<<(std::ostream &os, lsmio::MPIAggType v);
 /// Stream overload for StorageType.
 std::ostream &operator<<(std::ostream &os, lsmio::StorageType v);
 
+/// Stream overload for ClientTransport.
+std::ostream &operator<<(std::ostream &os, lsmio::ClientTransport v);
+
 /// Stream overload for MPIAggType (const reference).
 std::ostream &operator<<(std::ostream &os, const lsmio::MPIAggType &v);
 
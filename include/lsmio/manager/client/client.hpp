@@ -36,6 +36,7 @@
 #include <lsmio/lsmio.hpp>
 #include <string>
 #include <thread>  // NOLINT [build/c++11]
+#include <vector>
 
 namespace lsmio {
 
@@ -50,8 +51,12 @@ class KV_CMD {
   public:
     /// @brief Command for retrieving a key-value.
     static const std::string GET;
+    /// @brief Command for retrieving several key-values with one message.
+    static const std::string GET_BATCH;
     /// @brief Command for storing a key-value.
     static const std::string PUT;
+    /// @brief Command for storing several key-values (and metadata) as one batch.
+    static const std::string PUT_BATCH;
     /// @brief Command for deleting a key-value.
     static const std::string DEL;
     /// @brief Command for metadata operations
@@ -62,6 +67,8 @@ class KV_CMD {
     static const std::string READ_BARRIER;
     /// @brief Command for write synchronization.
     static const std::string WRITE_BARRIER;
+    /// @brief Local command asking the store to make room before credits are returned.
+    static const std::string WAIT_CAPACITY;
 };
 
 /**
@@ -75,6 +82,7 @@ class KV_CMD_RETURN {
   public:
     /// @brief Return command after a "get" operation.
     static const std::string GET;
+    static const std::string GET_BATCH;
     static const std::string META_GET;
     static const std::string META_GET_ALL;
     /// @brief Return command after a read barrier.
@@ -86,6 +94,32 @@ class KV_CMD_RETURN {
 /// Dummy key-value string used for unknown or placeholder values.
 const std::string KV_DUMMY = "DUMMY";
 
+/// Tag of blocking commands and their replies.
+const int KV_TAG_BLOCKING = 0;
+/// Range of tags identifying non-blocking requests and their replies.
+const int KV_TAG_REQUEST_MIN = 1;
+const int KV_TAG_REQUEST_MAX = 32000;
+/// Tag of flow-control credits returned by the aggregator.
+const int KV_TAG_CREDIT = 32767;
+
+/**
+ * @class LSMIOSendRequest
+ * @brief Outstanding non-blocking send.
+ *
+ * The request owns the serialized command, so the caller's buffers can be
+ * released as soon as the send has been started.
+ */
+class LSMIOSendRequest {
+  public:
+    virtual ~LSMIOSendRequest() = default;
+
+    /// @return True if the send has completed.
+    virtual bool test() = 0;
+
+    /// @brief Blocks until the send has completed.
+    virtual void wait() = 0;
+};
+
 class LSMIOManager;
 
 /**
@@ -127,6 +161,18 @@ class LSMIOClient {
     /// Column separator character, used in deserialization.
     const char _COL_SEPARATOR_CHAR = ';';
 
+    /// @brief Set once this rank acts as a client of an aggregator.
+    bool _isCreditClient = false;
+    /// @brief Bytes sent to the aggregator and not yet returned as credits.
+    int64_t _creditBytesUsed = 0;
+    /// @brief Commands sent to the aggregator and not yet returned as credits.
+    int64_t _creditMsgsUsed = 0;
+    /// @brief Bytes / commands processed per client but not yet returned (server side).
+    std::vector<int64_t> _owedBytes;
+    std::vector<int64_t> _owedMsgs;
+    /// @brief Commands received by the server loop and not yet dispatched.
+    std::atomic<size_t> _queueDepth = {0};
+
     /**
      * @brief Serializes the provided command, key, and value into a string buffer.
      * @param buf Buffer where the serialized string will be stored.
@@ -145,8 +191,8 @@ class LSMIOClient {
      * @param key Output parameter for the deserialized key.
      * @param value Output parameter for the deserialized value.
      */
-    void deSerializeCmd(const char *buf, const int &len, std::string *command, std::string *key,
-                        std::string *value);
+    void deSerializeCmd(const char *buf, const size_t &len, std::string *command,
+                        std::string *key, std::string *value);
 
     /**
      * @brief Waits for a command to arrive and processes it using the provided callback function.
@@ -158,15 +204,73 @@ class LSMIOClient {
     /// @brief Cancels the waiting state for incoming commands.
     void _cancelWaitForCommand();
 
+    /// @brief Size a command occupies on the wire, used for credit accounting.
+    static int64_t _commandBytes(const std::string &command, const std::string &key,
+                                 const std::string &value);
+
+    /**
+     * @brief Blocks until the aggregator has returned enough credits for a command.
+     * @param rank The aggregator rank.
+     * @param bytes Size of the command.
+     */
+    void _acquireCredits(int rank, int64_t bytes);
+
+    /**
+     * @brief Returns the credits of processed commands (server side).
+     *
+     * Credits are returned once half a window has been processed, or when the
+     * client has nothing queued and may be waiting for them.
+     */
+    void _grantCredits(LSMIOClientCallback func, LSMIOManager *lm,
+                       const std::vector<int> &eolRanks);
+
+    /// @brief Waits for all outstanding credits after the final command (client side).
+    void _drainCredits(int rank);
+
+    /// @brief True if the transport applies credit-based flow control.
+    virtual bool _creditsEnabled() const;
+
+    /// @brief Sends returned credits to a client.
+    virtual void _sendCredits(int rank, int64_t bytes, int64_t msgs);
+
+    /**
+     * @brief Receives returned credits from the aggregator.
+     * @param block Wait for a credit message if none has arrived.
+     * @return True if credits were received.
+     */
+    virtual bool _recvCredits(int rank, bool block, int64_t *bytes, int64_t *msgs);
+
+    /// @brief True if a command from the rank is waiting to be received; transports that
+    /// cannot tell always return true, and the server then waits on every active client.
+    virtual bool _hasPendingCommand(int rank);
+
     /// @brief Virtual function to implement a barrier mechanism.
     virtual void _barrier() = 0;
 
     /**
      * @brief Virtual function to receive data into a buffer.
-     * @param bufSizes Pointer to an integer storing the size of the received buffer.
-     * @return A pointer to the received data.
+     * @param ready Ranks to receive from, indexed by rank.
+     * @param bufSizes Pointer to the sizes of the received buffers.
+     * @param tags Pointer to an integer storing the tag of the received buffer.
+     * @return A pointer to the received data, nullptr if the transport overrides
+     *         _recvCommands instead.
+     */
+    virtual char **_recvToBuffer(const std::vector<int> &ready, size_t *bufSizes, int *tags);
+
+    /**
+     * @brief Receives one command from every rank marked ready.
+     *
+     * The default implementation deserializes the buffers of _recvToBuffer.
+     * Transports that can fill the strings directly override it.
+     * @param ready Ranks to receive from, indexed by rank.
+     * @param commands Output commands indexed by rank.
+     * @param keys Output keys indexed by rank.
+     * @param values Output values indexed by rank.
+     * @param tags Output tags indexed by rank; replies are sent with the same tag.
      */
-    virtual char **_recvToBuffer(int *bufSizes) = 0;
+    virtual void _recvCommands(const std::vector<int> &ready, std::vector<std::string> *commands,
+                               std::vector<std::string> *keys, std::vector<std::string> *values,
+                               std::vector<int> *tags);
 
   public:
     /// @brief Default constructor for LSMIOClient.
@@ -199,6 +303,11 @@ class LSMIOClient {
     /// @brief Starts the client for collective IO operations.
     bool startCollectiveIOClient();
 
+    /// @brief Commands received by the server loop and not yet dispatched.
+    size_t queueDepth() const {
+        return _queueDepth.load(std::memory_order_relaxed);
+    }
+
     /**
      * @brief Stops the server thread for collective IO operations.
      * @return True if the server was stopped successfully, false otherwise.
@@ -218,10 +327,24 @@ class LSMIOClient {
      * @param command The command to send.
      * @param key The key associated with the command.
      * @param value The value associated with the command.
+     * @param tag The tag identifying the request.
      * @return True if the command was sent successfully, false otherwise.
      */
     virtual bool sendCommand(int rank, const std::string &command, const std::string &key,
-                             const std::string &value) = 0;
+                             const std::string &value, int tag = KV_TAG_BLOCKING) = 0;
+
+    /**
+     * @brief Starts sending a command to a specific rank without waiting for it.
+     * @param rank The rank of the target client.
+     * @param command The command to send.
+     * @param key The key associated with the command.
+     * @param value The value associated with the command.
+     * @param tag The tag identifying the request.
+     * @return The outstanding send, or nullptr if the send has already completed.
+     */
+    virtual LSMIOSendRequest *isendCommand(int rank, const std::string &command,
+                                           const std::string &key, const std::string &value,
+                                           int tag);
 
     /**
      * @brief Receives a command from a specific rank.
@@ -229,10 +352,28 @@ class LSMIOClient {
      * @param command The command to receive.
      * @param key The key associated with the command.
      * @param value The value associated with the command.
+     * @param tag The tag identifying the request.
      * @return True if the command was received successfully, false otherwise.
      */
-    virtual bool recvCommand(int rank, std::string *command, std::string *key,
-                             std::string *value) = 0;
+    virtual bool recvCommand(int rank, std::string *command, std::string *key, std::string *value,
+                             int tag = KV_TAG_BLOCKING) = 0;
+
+    /**
+     * @brief Checks without blocking whether a command with the tag can be received.
+     * @param rank The rank of the source client.
+     * @param tag The tag identifying the request.
+     * @return True if recvCommand for the tag will not block.
+     */
+    virtual bool probeCommand(int rank, int tag) = 0;
+
+    /**
+     * @brief Whether the aggregator serves clients that issue different numbers of commands.
+     *
+     * Without it every client has to send the same commands, so client-side shortcuts that
+     * skip a command, such as read cache hits, stay off.
+     * @return True if the transport can tell which clients have a command waiting.
+     */
+    virtual bool allowsUnevenCommands() const;
 };
 
 }  // namespace lsmio
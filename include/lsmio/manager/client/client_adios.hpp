@@ -35,24 +35,75 @@
 #include <adios2/helper/adiosComm.h>
 #include <adios2/helper/adiosCommMPI.h>
 
+#include <string>
+#include <vector>
+
 #include "client.hpp"
 
 namespace lsmio {
 
+/**
+ * @class LSMIOSendRequestAdios
+ * @brief Outstanding Isends of a command's size frame and payload.
+ */
+class LSMIOSendRequestAdios : public LSMIOSendRequest {
+  public:
+    /// Size frame; must not change until the request completes.
+    size_t size = 0;
+    /// Serialized command; must not change until the request completes.
+    std::string buffer;
+    /// Requests of the frame and the payload.
+    std::vector<adios2::helper::Comm::Req> requests;
+
+    ~LSMIOSendRequestAdios() override;
+
+    /// adios2::helper::Comm requests cannot be tested, so this completes the send.
+    bool test() override;
+    void wait() override;
+};
+
+/**
+ * @class LSMIOClientAdios
+ * @brief LSM IO client over an ADIOS-managed communicator.
+ *
+ * Every command is framed as its size followed by the serialized command, both on the
+ * command's tag. The aggregator posts the size receives of the next round before it runs the
+ * callbacks of the current one, and receives the payloads into buffers kept across rounds.
+ */
 class LSMIOClientAdios : public LSMIOClient {
   private:
     adios2::helper::Comm *_comm;
 
+    /// @brief Size frames of the next round, posted ahead (server side).
+    std::vector<size_t> _recvSizes;
+    std::vector<adios2::helper::Comm::Req> _recvSizeReqs;
+    /// @brief Payload buffers reused across rounds (server side).
+    std::vector<std::vector<char>> _recvBuffers;
+    /// @brief Reply buffer reused across calls (client side).
+    std::vector<char> _replyBuffer;
+
+    void _postSizeRecvs(const std::vector<int> &ranks);
+
   protected:
-    void _barrier();
-    char **_recvToBuffer(int *bufSizes);
+    void _barrier() override;
+
+    /**
+     * @brief Receives one command from every ready rank into the reused buffers.
+     */
+    void _recvCommands(const std::vector<int> &ready, std::vector<std::string> *commands,
+                       std::vector<std::string> *keys, std::vector<std::string> *values,
+                       std::vector<int> *tags) override;
 
   public:
-    LSMIOClientAdios(adios2::helper::Comm *comm);
+    explicit LSMIOClientAdios(adios2::helper::Comm *comm);
 
     bool sendCommand(int rank, const std::string &command, const std::string &key,
-                     const std::string &value);
-    bool recvCommand(int rank, std::string *command, std::string *key, std::string *value);
+                     const std::string &value, int tag = KV_TAG_BLOCKING) override;
+    LSMIOSendRequest *isendCommand(int rank, const std::string &command, const std::string &key,
+                                   const std::string &value, int tag) override;
+    bool recvCommand(int rank, std::string *command, std::string *key, std::string *value,
+                     int tag = KV_TAG_BLOCKING) override;
+    bool probeCommand(int rank, int tag) override;
 };
 
 }  // namespace lsmio
@@ -34,11 +34,31 @@
 #include <mpi.h>
 
 #include <string>
+#include <vector>
 
 #include "client.hpp"
 
 namespace lsmio {
 
+/**
+ * @class LSMIOSendRequestMPI
+ * @brief Outstanding MPI_Isends of a command together with the buffers they send from.
+ */
+class LSMIOSendRequestMPI : public LSMIOSendRequest {
+  public:
+    /// Serialized command; must not change until the request completes.
+    std::string buffer;
+    /// Fragment header when the command is sent in fragments.
+    std::string header;
+    /// MPI requests of the header and the fragments, or of the whole command.
+    std::vector<MPI_Request> requests;
+
+    ~LSMIOSendRequestMPI() override;
+
+    bool test() override;
+    void wait() override;
+};
+
 /**
  * @class LSMIOClientMPI
  * @brief MPI implementation of the LSM IO client.
@@ -51,6 +71,33 @@ class LSMIOClientMPI : public LSMIOClient {
     /// Pointer to the MPI communicator.
     MPI_Comm *_mpiComm;
 
+    /// Command of the header announcing a message sent in fragments.
+    const std::string _FRAG_COMMAND = "__FRAG";
+    /// Messages up to this size may be fragment headers and are received eagerly.
+    const int _FRAG_HEADER_MAX = 64;
+
+    /// @brief Largest message sent in one piece: transferSize, capped at INT_MAX.
+    static size_t _fragmentBytes();
+
+    /**
+     * @brief Starts sending a serialized command, in pipelined fragments if it is large.
+     * @param buf Serialized command; must not change until the requests complete.
+     * @param header Storage for the fragment header, same lifetime as buf.
+     * @param reqs Output requests to complete.
+     */
+    void _isendBuffer(const std::string &buf, std::string *header, int rank, int tag,
+                      std::vector<MPI_Request> *reqs);
+
+    /**
+     * @brief Starts receiving a probed message, reassembling it if it is fragmented.
+     * @param bSize Size of the probed message.
+     * @param size Output size of the whole command.
+     * @param reqs Requests to complete before the returned buffer can be used.
+     * @return Buffer of the whole command, owned by the caller.
+     */
+    char *_irecvBuffer(int rank, int tag, int bSize, size_t *size,
+                       std::vector<MPI_Request> *reqs);
+
   protected:
     /**
      * @brief Implements a barrier mechanism using MPI_Barrier.
@@ -58,11 +105,19 @@ class LSMIOClientMPI : public LSMIOClient {
     void _barrier() override;
 
     /**
-     * @brief Receives data from all other MPI processes.
+     * @brief Receives data from the MPI processes marked ready.
+     * @param ready Ranks to receive from, indexed by rank.
      * @param bufSizes Pointer to an integer array storing the sizes of the received buffers.
+     * @param tags Pointer to an integer array storing the tags of the received buffers.
      * @return A pointer to the array of received data buffers.
      */
-    char **_recvToBuffer(int *bufSizes) override;
+    char **_recvToBuffer(const std::vector<int> &ready, size_t *bufSizes, int *tags) override;
+
+    /// @brief Flow control is on when a byte or command window is configured.
+    bool _creditsEnabled() const override;
+    void _sendCredits(int rank, int64_t bytes, int64_t msgs) override;
+    bool _recvCredits(int rank, bool block, int64_t *bytes, int64_t *msgs) override;
+    bool _hasPendingCommand(int rank) override;
 
   public:
     /**
@@ -77,10 +132,18 @@ class LSMIOClientMPI : public LSMIOClient {
      * @param command The command to send.
      * @param key The key associated with the command.
      * @param value The value associated with the command.
+     * @param tag The tag identifying the request.
      * @return True if the command was sent successfully, false otherwise.
      */
     bool sendCommand(int rank, const std::string &command, const std::string &key,
-                     const std::string &value) override;
+                     const std::string &value, int tag = KV_TAG_BLOCKING) override;
+
+    /**
+     * @brief Starts an MPI_Isend of a command to a specific MPI rank.
+     * @return The outstanding send.
+     */
+    LSMIOSendRequest *isendCommand(int rank, const std::string &command, const std::string &key,
+                                   const std::string &value, int tag) override;
 
     /**
      * @brief Receives a command from a specific MPI rank.
@@ -88,9 +151,17 @@ class LSMIOClientMPI : public LSMIOClient {
      * @param command Pointer to the received command string.
      * @param key Pointer to the received key string.
      * @param value Pointer to the received value string.
+     * @param tag The tag identifying the request.
      * @return True if the command was received successfully, false otherwise.
      */
-    bool recvCommand(int rank, std::string *command, std::string *key, std::string *value) override;
+    bool recvCommand(int rank, std::string *command, std::string *key, std::string *value,
+                     int tag = KV_TAG_BLOCKING) override;
+
+    /**
+     * @brief Checks with MPI_Iprobe whether a command with the tag has arrived.
+     */
+    bool probeCommand(int rank, int tag) override;
+    bool allowsUnevenCommands() const override;
 };
 
 }  // namespace lsmio
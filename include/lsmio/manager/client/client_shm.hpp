@@ -0,0 +1,179 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LSMIO_CLIENT_SHM_HPP_
+#define _LSMIO_CLIENT_SHM_HPP_
+
+#include <mpi.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "client.hpp"
+
+namespace lsmio {
+
+/**
+ * @struct ShmRingHeader
+ * @brief Positions of a single-producer/single-consumer byte ring in shared memory.
+ *
+ * Both counters grow monotonically; the ring offset is the counter modulo the
+ * capacity. They are kept on separate cache lines so that the producer and the
+ * consumer do not false-share.
+ */
+struct ShmRingHeader {
+    /// @brief Bytes consumed so far (written by the consumer only).
+    alignas(64) std::atomic<uint64_t> head;
+    /// @brief Bytes produced so far (written by the producer only).
+    alignas(64) std::atomic<uint64_t> tail;
+};
+
+/**
+ * @class ShmRing
+ * @brief Process-local view of a ring living in an MPI shared-memory window.
+ *
+ * Writes and reads are streamed: a record larger than the ring capacity is
+ * transferred in pieces as the other side makes progress.
+ */
+class ShmRing {
+  private:
+    ShmRingHeader *_header = nullptr;
+    char *_data = nullptr;
+    uint64_t _capacity = 0;
+
+  public:
+    ShmRing() = default;
+    ShmRing(void *base, uint64_t capacity);
+
+    /// Reset both positions; only valid before the peer starts using the ring.
+    void reset();
+
+    /// Blocking copy of len bytes into the ring.
+    void write(const void *buf, uint64_t len);
+
+    /// Blocking copy of len bytes out of the ring.
+    void read(void *buf, uint64_t len);
+
+    /// Bytes written by the producer and not yet consumed.
+    uint64_t available() const;
+
+    /// Bytes needed in the window for a ring of the given capacity.
+    static uint64_t footprint(uint64_t capacity);
+};
+
+/**
+ * @class LSMIOClientSHM
+ * @brief Shared-memory implementation of the LSM IO client.
+ *
+ * Every non-aggregator rank owns a request ring (client to aggregator) and a
+ * reply ring (aggregator to client) in a window created with
+ * MPI_Win_allocate_shared. Commands are written into the rings field by field,
+ * so neither side builds an intermediate serialized buffer and no MPI message
+ * is exchanged. The communicator must only contain ranks of a single node.
+ */
+class LSMIOClientSHM : public LSMIOClient {
+  private:
+    /// Pointer to the node-local MPI communicator.
+    MPI_Comm *_mpiComm;
+    /// Rank serving the store; every other rank owns a ring pair.
+    int _aggRank;
+    /// Shared-memory window holding the rings.
+    MPI_Win _win = MPI_WIN_NULL;
+    /// Capacity of each ring in bytes.
+    uint64_t _ringSize;
+    /// Request rings indexed by client rank.
+    std::vector<ShmRing> _reqRings;
+    /// Reply rings indexed by client rank.
+    std::vector<ShmRing> _repRings;
+
+    /// Fixed-size record header preceding the command, key and value bytes.
+    struct RecordHeader {
+        uint32_t cmdLen;
+        uint32_t keyLen;
+        uint64_t valLen;
+        int32_t tag;
+    };
+
+    /// Replies read ahead of the one being waited for, keyed by tag.
+    std::map<int, std::tuple<std::string, std::string, std::string>> _stash;
+
+    /// Blocking read of one whole record.
+    void _readRecord(ShmRing &ring, int *tag, std::string *command, std::string *key,
+                     std::string *value);
+
+    /// Ring to write to / read from when talking to the given rank.
+    ShmRing &_outRing(int rank);
+    ShmRing &_inRing(int rank);
+
+  protected:
+    /**
+     * @brief Implements a barrier mechanism using MPI_Barrier.
+     */
+    void _barrier() override;
+
+    /**
+     * @brief Reads one command from every ready client ring straight into strings.
+     */
+    void _recvCommands(const std::vector<int> &ready, std::vector<std::string> *commands,
+                       std::vector<std::string> *keys, std::vector<std::string> *values,
+                       std::vector<int> *tags) override;
+
+    /// @brief A client ring holds the start of a record.
+    bool _hasPendingCommand(int rank) override;
+
+  public:
+    /**
+     * @brief Constructor; collectively allocates the shared-memory rings.
+     * @param comm Reference to a node-local MPI communicator.
+     * @param ringSize Capacity of each ring in bytes.
+     * @param aggRank Rank of the aggregator in comm.
+     */
+    LSMIOClientSHM(MPI_Comm &comm, uint64_t ringSize, int aggRank = 0);
+
+    /// @brief Destructor; collectively frees the shared-memory window.
+    ~LSMIOClientSHM() override;
+
+    bool sendCommand(int rank, const std::string &command, const std::string &key,
+                     const std::string &value, int tag = KV_TAG_BLOCKING) override;
+
+    bool recvCommand(int rank, std::string *command, std::string *key, std::string *value,
+                     int tag = KV_TAG_BLOCKING) override;
+
+    bool probeCommand(int rank, int tag) override;
+    bool allowsUnevenCommands() const override;
+};
+
+}  // namespace lsmio
+
+#endif  // _LSMIO_CLIENT_SHM_HPP_
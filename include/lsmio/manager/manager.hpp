@@ -38,9 +38,17 @@
 
 #include <lsmio/lsmio.hpp>
 #include <lsmio/manager/client/client.hpp>
+#include <lsmio/manager/metrics.hpp>
+#include <lsmio/manager/read_cache.hpp>
+#include <lsmio/manager/restart.hpp>
+#include <lsmio/manager/stats.hpp>
 #include <lsmio/manager/store/native/store_native.hpp>
+#include <lsmio/manager/store/store_forward.hpp>
 #include <lsmio/manager/store/store_ldb.hpp>
 #include <lsmio/manager/store/store_rdb.hpp>
+#include <lsmio/manager/store/store_sharded.hpp>
+#include <chrono>
+#include <map>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -52,6 +60,12 @@
 
 namespace lsmio {
 
+/// Handle of a non-blocking put or get.
+using LSMIORequest = int;
+
+/// Handle of a request that completed when it was issued.
+const LSMIORequest LSMIO_REQUEST_NULL = 0;
+
 /**
  * @class LSMIOManager
  * @brief Class for managing LSMIO operations.
@@ -62,6 +76,8 @@ class LSMIOManager {
     std::string _dbName;
     /// @brief Directory of the database.
     std::string _dbDir;
+    /// @brief Directory of the database as given, before the aggregation subdirectories.
+    std::string _rootDir;
     /// @brief Path to the database.
     std::string _dbPath;
 
@@ -69,6 +85,14 @@ class LSMIOManager {
     LSMIOStore *_lcStore = nullptr;
     /// @brief Client instance.
     LSMIOClient *_lcMPI = nullptr;
+    /// @brief Cache of remote reads, nullptr on the aggregator or when disabled.
+    LSMIOReadCache *_readCache = nullptr;
+    /// @brief Index of the keys in the local store, nullptr unless writeRestartIndex is set.
+    LSMIORestartIndex *_restartIndex = nullptr;
+    /// @brief Restart index updates published so far, see publishRestartIndex.
+    size_t _restartIndexUpdates = 0;
+    /// @brief World ranks of the aggregation group, indexed by aggregation rank.
+    std::vector<int> _aggWorldRanks;
 
     /// @brief Flag to indicate overwrite.
     bool _isOverWrite = false;
@@ -76,18 +100,25 @@ class LSMIOManager {
     bool _isShared = false;
     /// @brief Flag to indicate shared split mode.
     bool _isSharedSplit = false;
+    /// @brief Remote writes were sent since the last write barrier.
+    bool _isWritePending = false;
+    /// @brief Spans are being collected for the trace file written on close.
+    bool _isTracing = false;
 
-    /// @brief Counter for written bytes.
-    uint64_t _counterWriteBytes = 0;
-    /// @brief Counter for read bytes.
-    uint64_t _counterReadBytes = 0;
-    /// @brief Counter for write operations.
-    uint64_t _counterWriteOps = 0;
-    /// @brief Counter for read operations.
-    uint64_t _counterReadOps = 0;
+    /// @brief Byte / operation counters and latency histograms.
+    LSMIOStats _stats;
+
+    /// @brief Exporter of live metrics, nullptr unless metricsDir is set.
+    LSMIOMetricsExporter *_metrics = nullptr;
+    /// @brief Time and byte counters of the previous metrics sample, for throughput.
+    std::chrono::steady_clock::time_point _metricsTime;
+    uint64_t _metricsWriteBytes = 0;
+    uint64_t _metricsReadBytes = 0;
 
     /// @brief Adios communication instance.
     adios2::helper::Comm *_adiosComm = nullptr;
+    /// @brief Adios communicator of the aggregation group for the Adios transport.
+    adios2::helper::Comm *_aggAdiosComm = nullptr;
     /// @brief MPI communication instance.
     MPI_Comm _mpiComm = 0;
     /// @brief Rank in the world communicator.
@@ -95,12 +126,31 @@ class LSMIOManager {
     /// @brief Size of the world communicator.
     int _worldSize = 1;
 
+    /**
+     * @brief State of an outstanding iput or iget.
+     */
+    struct PendingRequest {
+        /// @brief Outstanding send of the command, nullptr once completed.
+        LSMIOSendRequest *send = nullptr;
+        /// @brief Output of an iget, nullptr for an iput.
+        std::string *value = nullptr;
+        /// @brief Time the request was issued, for the remote round-trip latency.
+        std::chrono::steady_clock::time_point start;
+    };
+
+    /// @brief Outstanding non-blocking requests keyed by their tag.
+    std::map<LSMIORequest, PendingRequest> _pending;
+    /// @brief Next tag to hand out for a non-blocking request.
+    LSMIORequest _nextRequestTag = KV_TAG_REQUEST_MIN;
+
     /// @brief Aggregator communication instance.
     MPI_Comm _aggComm = 0;
     /// @brief Rank in the aggregator communicator.
     int _aggRank = 0;
     /// @brief Size of the aggregator communicator.
     int _aggSize = 1;
+    /// @brief Communicator of the node leaders in hierarchical aggregation.
+    MPI_Comm _globalComm = MPI_COMM_NULL;
 
     /// @brief Static instance of LSMIOManager.
     static LSMIOManager *_lm;
@@ -116,18 +166,55 @@ class LSMIOManager {
      */
     void _init();
 
+    /**
+     * @brief Split the node (or NUMA domain) into aggregation groups.
+     */
+    void _splitNodeComm();
+
+    /**
+     * @brief Open the configured storage backend at the given path.
+     */
+    LSMIOStore *_openBackend(const std::string &dbPath);
+
+    /**
+     * @brief Open the store at the given path, sharded when storeShards > 1.
+     */
+    LSMIOStore *_openStore(const std::string &dbPath);
+
+    /**
+     * @brief Open the store of a node leader that forwards to the global writers.
+     */
+    LSMIOStore *_openForwardStore();
+
     bool _isOpenLocal() const;
     bool _isOpenRemote() const;
     bool _isServeLocal() const;
 
+    LSMIORequest _acquireRequestTag();
+    bool _completeRequest(LSMIORequest request, bool block, bool *success);
+
     std::string _rankedKey(const int rank, const std::string &key) const;
     std::string _rankedKey(const std::string &key) const;
 
+    void _openRestartIndex();
+    void _indexMutation(int rank, const std::string &key, bool meta, bool del);
+
+    /// apply a batch of values and metadata of the rank to the local store
+    bool _storeBatch(int rank, const std::vector<std::tuple<std::string, std::string>> &values,
+                     const std::vector<std::tuple<std::string, std::string>> &metaValues,
+                     bool flush);
+    void _saveRestartIndex();
+
+    void _openMetrics();
+    void _writeMetrics(std::ostream &os);
+
   public:
     /// @brief Aggregation rank constant.
     const int AGGREGATION_RANK = 0;
     /// @brief Infix for aggregation directory.
     const std::string AGGREGATION_DIR_INFIX = "agg";
+    /// @brief Infix for global writer directory.
+    const std::string GLOBAL_DIR_INFIX = "global";
 
     /**
      * @brief Constructor with MPI communicator.
@@ -168,6 +255,17 @@ class LSMIOManager {
      */
     bool get(const std::string &key, std::string *value);
 
+    /**
+     * @brief Get the values of several keys at once.
+     *
+     * Remote ranks ask the aggregator for all uncached keys in one message
+     * instead of one round trip per key. Missing keys yield empty values.
+     * @param keys The keys to look up.
+     * @param values Receives one value per key, in the order of the keys.
+     * @return Returns true if the operation is successful, false otherwise.
+     */
+    bool getBatch(const std::vector<std::string> &keys, std::vector<std::string> *values);
+
     /**
      * @brief Put a value associated with a key into the database.
      *
@@ -180,6 +278,55 @@ class LSMIOManager {
     bool put(const std::string &key, const char *value, std::streamsize n);
     bool put(const std::string &key, const void *ptr, size_t size, size_t count);
 
+    /**
+     * @brief Put several values and metadata entries as one batch.
+     *
+     * Locally the entries go into a single store batch; remote ranks send them
+     * to the aggregator as one message, which the transport fragments if it is large.
+     * @param values The key-value pairs to write.
+     * @param metaValues The metadata key-value pairs to write.
+     * @param flush Whether to flush after the batch.
+     * @return Returns true if the operation is successful, false otherwise.
+     */
+    bool putBatch(const std::vector<std::tuple<std::string, std::string>> &values,
+                  const std::vector<std::tuple<std::string, std::string>> &metaValues,
+                  bool flush);
+
+    /**
+     * @brief Start putting a value without waiting for it to reach the aggregator.
+     *
+     * The value is copied into the request, so the caller may reuse it at once.
+     * @param key The key associated with the value.
+     * @param value The value to write.
+     * @param request Handle to pass to test or wait.
+     * @return Returns true if the operation is successful, false otherwise.
+     */
+    bool iput(const std::string &key, const std::string &value, LSMIORequest *request);
+
+    /**
+     * @brief Start getting a value without waiting for the reply.
+     *
+     * @param key The key associated with the value.
+     * @param value Receives the value; must stay valid until the request completes.
+     * @param request Handle to pass to test or wait.
+     * @return Returns true if the operation is successful, false otherwise.
+     */
+    bool iget(const std::string &key, std::string *value, LSMIORequest *request);
+
+    /**
+     * @brief Check whether a non-blocking request has completed.
+     *
+     * @param request Handle returned by iput or iget.
+     * @param success Set to the outcome of the request once it has completed.
+     * @return Returns true if the request has completed.
+     */
+    bool test(LSMIORequest request, bool *success = nullptr);
+
+    /// wait for one / all outstanding non-blocking requests
+    /// @return bool success
+    bool wait(LSMIORequest request);
+    bool waitAll();
+
     /**
      * @brief Delete a value associated with a key from the database.
      *
@@ -203,15 +350,41 @@ class LSMIOManager {
                     std::string inFix = "");
     bool metaPut(const std::string &key, const std::string &value, bool flush);
 
+    /**
+     * @brief Collective metaGetAll over the aggregation group.
+     *
+     * The aggregator scans the metadata once and scatters each rank its share
+     * in a binary form, instead of serving one META_GET_ALL per rank. Every
+     * rank of the group has to call it; the result matches metaGetAll.
+     *
+     * @param values Receives the metadata entries of this rank.
+     * @return Returns true if the operation is successful, false otherwise.
+     */
+    bool metaGetAllCollective(std::vector<std::tuple<std::string, std::string>> *values);
+
     /// read and write barrier for async operations
     /// @return bool success
     bool readBarrier();
     bool writeBarrier();
 
+    /// whether the clients of an aggregator may send different numbers of commands, see
+    /// LSMIOClient::allowsUnevenCommands; always true without aggregation
+    bool allowsUnevenCommands() const;
+
+    /// on an aggregator, save the restart index entries added since the last call next to
+    /// the index, so readers can find data written so far before the manager is closed;
+    /// call after a writeBarrier of every rank of the aggregation group
+    /// @return bool success
+    bool publishRestartIndex();
+
     void resetCounters();
     void getCounters(uint64_t &writeBytes, uint64_t &readBytes, uint64_t &writeOps,
                      uint64_t &readOps) const;
 
+    /// counters and put / get / barrier / remote / flush latency percentiles
+    LSMIOStatsSnapshot getStats() const;
+    void resetStats();
+
     static LSMIOManager *initialize(const std::string &dbName = "lsmiodb",
                                     const std::string &dbDir = "", const bool overWrite = false,
                                     adios2::helper::Comm *adiosComm = nullptr);
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LSMIO_METRICS_HPP_
+#define _LSMIO_METRICS_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+namespace lsmio {
+
+/**
+ * @class LSMIOMetricsExporter
+ * @brief Background thread writing a Prometheus text-format file at a fixed interval.
+ *
+ * Each sample is written to a temporary file next to the target and renamed over it, so the
+ * node exporter textfile collector never reads a partial file.
+ */
+class LSMIOMetricsExporter {
+  public:
+    /// writes the metrics of one sample
+    using Writer = std::function<void(std::ostream &)>;
+
+  private:
+    std::string _filePath;
+    std::chrono::milliseconds _interval;
+    Writer _writer;
+
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _stop = false;
+
+    void _run();
+
+  public:
+    LSMIOMetricsExporter(const std::string &filePath, int intervalMs, Writer writer);
+    ~LSMIOMetricsExporter();
+
+    /// write one sample now
+    /// @return bool success
+    bool exportNow();
+
+    /// stop the thread after writing a final sample
+    void stop();
+
+    /// write one metric with its HELP and TYPE lines
+    static void writeMetric(std::ostream &os, const std::string &name, const std::string &type,
+                            const std::string &help, const std::string &labels, double value);
+    static void writeMetric(std::ostream &os, const std::string &name, const std::string &type,
+                            const std::string &help, const std::string &labels, uint64_t value);
+
+    /// quote a label value, escaping backslashes, quotes and newlines
+    static std::string labelValue(const std::string &value);
+};
+
+}  // namespace lsmio
+
+#endif
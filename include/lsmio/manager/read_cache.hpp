@@ -0,0 +1,90 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LSMIO_READ_CACHE_HPP_
+#define _LSMIO_READ_CACHE_HPP_
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace lsmio {
+
+/**
+ * @class LSMIOReadCache
+ * @brief Byte-bounded LRU cache of values read from a remote aggregator.
+ *
+ * Not thread-safe; each manager owns one and uses it from the caller's thread.
+ */
+class LSMIOReadCache {
+  private:
+    using Entry = std::pair<std::string, std::string>;
+
+    uint64_t _capacity;
+    uint64_t _sizeBytes = 0;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+
+    /// most recently used first
+    std::list<Entry> _entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> _index;
+
+    void _evict();
+
+  public:
+    explicit LSMIOReadCache(uint64_t capacity);
+
+    /// look up a key and mark it as recently used
+    /// @return bool found
+    bool get(const std::string &key, std::string *value);
+
+    /// insert or replace a value; values larger than the capacity are not kept
+    void put(const std::string &key, const std::string &value);
+
+    /// drop one key / all keys
+    void erase(const std::string &key);
+    void clear();
+
+    uint64_t sizeBytes() const {
+        return _sizeBytes;
+    }
+    uint64_t hits() const {
+        return _hits;
+    }
+    uint64_t misses() const {
+        return _misses;
+    }
+};
+
+}  // namespace lsmio
+
+#endif
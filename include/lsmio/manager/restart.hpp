@@ -0,0 +1,193 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LSMIO_RESTART_HPP_
+#define _LSMIO_RESTART_HPP_
+
+#include <filesystem>
+#include <lsmio/lsmio.hpp>
+#include <lsmio/manager/store/store.hpp>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace lsmio {
+
+/**
+ * @class LSMIORestartIndex
+ * @brief Rank-independent index of the keys held by one aggregator's store.
+ *
+ * Maps each stored key back to the world rank that wrote it and the key that rank used, so a
+ * restart can read the data with a different number of ranks than wrote it.
+ * Thread-safe; the aggregator updates it from the server thread and the caller's thread.
+ */
+class LSMIORestartIndex {
+  public:
+    struct Entry {
+        int writer = 0;
+        bool meta = false;
+        std::string key;
+    };
+
+  private:
+    /// store path relative to the root directory of the database
+    std::string _storePath;
+    StorageType _storageType;
+    int _shards;
+    bool _byRank;
+
+    /// store key -> entry
+    std::map<std::string, Entry> _entries;
+    /// store keys added since the last saveNew
+    std::set<std::string> _unsaved;
+    /// entries removed since the last saveNew, published as deletions
+    std::map<std::string, Entry> _removed;
+    mutable std::mutex _mutex;
+
+    bool _write(const std::string &filePath, const std::set<std::string> *only) const;
+
+  public:
+    LSMIORestartIndex(const std::string &storePath = "",
+                      StorageType storageType = StorageType::NativeDB, int shards = 1,
+                      bool byRank = false);
+
+    void add(const std::string &storeKey, int writer, bool meta, const std::string &key);
+    void remove(const std::string &storeKey);
+
+    /// write the index to a file / read one, merging its entries into this index
+    /// @return bool success
+    bool save(const std::string &filePath) const;
+    bool load(const std::string &filePath);
+
+    /// write only the entries added or removed since the last saveNew, nothing if there are
+    /// none
+    /// @return bool success
+    bool saveNew(const std::string &filePath);
+
+    const std::string &storePath() const {
+        return _storePath;
+    }
+    StorageType storageType() const {
+        return _storageType;
+    }
+    int shards() const {
+        return _shards;
+    }
+    bool byRank() const {
+        return _byRank;
+    }
+    std::map<std::string, Entry> entries() const;
+    /// entries an update file deletes
+    std::map<std::string, Entry> removed() const;
+};
+
+/**
+ * @class LSMIORestartReader
+ * @brief Reads back a database written by any number of ranks through its restart indices.
+ *
+ * Every reader loads all index files and opens the aggregator stores it needs read-only on
+ * first use, so any number of ranks can read any writer's keys in parallel; see sharedReads
+ * for the stores that allow it.
+ * Not thread-safe.
+ */
+class LSMIORestartReader {
+  private:
+    struct Location {
+        size_t store;
+        std::string storeKey;
+    };
+
+    struct StoreInfo {
+        std::string path;
+        StorageType storageType;
+        int shards;
+        bool byRank;
+        LSMIOStore *store = nullptr;
+    };
+
+    std::string _dbDir;
+    std::string _indexDir;
+    /// index files loaded so far with their write times, and the position of each store in
+    /// _stores by its path
+    std::map<std::string, std::filesystem::file_time_type> _loadedIndices;
+    std::map<std::string, size_t> _storeByPath;
+
+    std::vector<StoreInfo> _stores;
+    /// writer rank -> key -> location, for values and metadata
+    std::map<int, std::map<std::string, Location>> _data;
+    std::map<int, std::map<std::string, Location>> _meta;
+
+    void _loadIndices();
+    void _dropStore(size_t store);
+    LSMIOStore *_openStore(StoreInfo &info);
+    bool _get(const std::map<int, std::map<std::string, Location>> &locations, int writer,
+              const std::string &key, std::string *value);
+
+  public:
+    LSMIORestartReader(const std::string &dbName, const std::string &dbDir = "");
+    ~LSMIORestartReader();
+
+    void close();
+
+    /// pick up index updates and data published since the reader was opened or refreshed,
+    /// for reading a database that is still being written (native stores only)
+    void refresh();
+
+    /// world ranks that wrote the database
+    std::vector<int> writers() const;
+
+    /// every store can be opened by several processes at once, which only native stores
+    /// allow: LevelDB and RocksDB lock a store for the process that opens it
+    /// @return bool false also when there is no index
+    bool sharedReads() const;
+
+    /// keys (values and metadata) written by one rank
+    /// @return bool the rank wrote anything
+    bool keys(int writer, std::vector<std::string> *values) const;
+    bool metaKeys(int writer, std::vector<std::string> *values) const;
+
+    bool get(int writer, const std::string &key, std::string *value);
+    bool metaGet(int writer, const std::string &key, std::string *value);
+
+    /// (writer, key) pairs read store by store, in key order within each store
+    /// @return bool every key was found; values of missing keys are left empty
+    bool getBatch(const std::vector<std::tuple<int, std::string>> &keys,
+                  std::vector<std::string> *values);
+};
+
+/// Directory holding the restart index files of a database.
+std::string restartIndexDir(const std::string &dbName, const std::string &dbDir);
+
+}  // namespace lsmio
+
+#endif
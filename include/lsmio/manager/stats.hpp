@@ -0,0 +1,158 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LSMIO_STATS_HPP_
+#define _LSMIO_STATS_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace lsmio {
+
+/**
+ * Enum representing the operations whose latency is recorded.
+ */
+enum class StatOp {
+    Put,
+    Get,
+    Barrier,
+    Remote,
+    Flush,
+    Stall,
+    Count
+};
+
+/**
+ * @brief Latency distribution of one operation, in nanoseconds.
+ *
+ * Percentiles are the upper bound of their histogram bucket (at most 25% above the true value).
+ */
+struct LSMIOLatency {
+    uint64_t count = 0;
+    uint64_t totalNs = 0;
+    uint64_t meanNs = 0;
+    uint64_t p50Ns = 0;
+    uint64_t p99Ns = 0;
+    uint64_t p999Ns = 0;
+    uint64_t maxNs = 0;
+};
+
+/**
+ * @brief Point-in-time copy of the counters and latency distributions.
+ */
+struct LSMIOStatsSnapshot {
+    uint64_t writeBytes = 0;
+    uint64_t readBytes = 0;
+    uint64_t writeOps = 0;
+    uint64_t readOps = 0;
+    std::array<LSMIOLatency, static_cast<size_t>(StatOp::Count)> latency;
+
+    const LSMIOLatency &operator[](StatOp op) const {
+        return latency[static_cast<size_t>(op)];
+    }
+};
+
+/**
+ * @class LSMIOStats
+ * @brief Byte / operation counters and log-bucketed latency histograms.
+ *
+ * Every thread updates its own cache-line aligned shard with relaxed atomics, so application
+ * threads and the collective I/O server thread never contend on a counter. Snapshots sum the
+ * shards and may be taken from any thread while updates continue.
+ */
+class LSMIOStats {
+  public:
+    /// Buckets of a histogram: four linear sub-buckets per power of two.
+    static constexpr size_t BUCKETS = 256;
+    /// Shards threads are spread over.
+    static constexpr size_t SHARDS = 8;
+
+    /// Bucket of a latency and the largest latency it holds.
+    static size_t bucketOf(uint64_t ns);
+    static uint64_t bucketUpperBound(size_t bucket);
+
+  private:
+    struct alignas(64) Histogram {
+        std::atomic<uint64_t> buckets[BUCKETS];
+        std::atomic<uint64_t> sumNs;
+        std::atomic<uint64_t> maxNs;
+    };
+
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> writeBytes;
+        std::atomic<uint64_t> readBytes;
+        std::atomic<uint64_t> writeOps;
+        std::atomic<uint64_t> readOps;
+        Histogram latency[static_cast<size_t>(StatOp::Count)];
+    };
+
+    Shard _shards[SHARDS];
+
+    Shard &_shard();
+
+  public:
+    LSMIOStats();
+
+    void addWrite(uint64_t bytes);
+    void addRead(uint64_t bytes);
+    void record(StatOp op, uint64_t ns);
+
+    LSMIOStatsSnapshot snapshot() const;
+    void reset();
+};
+
+/**
+ * @class LSMIOStatTimer
+ * @brief Records the lifetime of the timer as one latency sample; no-op without stats.
+ */
+class LSMIOStatTimer {
+  private:
+    LSMIOStats *_stats;
+    StatOp _op;
+    std::chrono::steady_clock::time_point _start;
+
+  public:
+    LSMIOStatTimer(LSMIOStats *stats, StatOp op);
+    ~LSMIOStatTimer();
+};
+
+/**
+ * Convert a StatOp value to its string representation.
+ * @param v StatOp value.
+ * @return String representation of the StatOp.
+ */
+std::string to_string(const StatOp v);
+
+}  // namespace lsmio
+
+#endif
@@ -46,7 +46,9 @@ namespace lsmio {
 
 class SSTableManager {
   public:
-    SSTableManager(const std::string& dbPath, size_t filePoolSize, size_t preAllocBytes);
+    // A read-only manager only indexes existing SSTables and never creates new files
+    SSTableManager(const std::string& dbPath, size_t filePoolSize, size_t preAllocBytes,
+                   bool readOnly = false);
     ~SSTableManager();
 
     // Flush a memtable to disk as a new SSTable
@@ -64,12 +66,23 @@ class SSTableManager {
     bool scan(const std::string& prefix, std::map<std::string, std::string>& results,
               std::set<std::string>& deleted_keys);
 
+    // Index what other processes appended to the SSTables since they were last indexed;
+    // meant for read-only managers of a store that is still being written
+    bool refresh();
+
     void close();
 
+    // Number of indexed SSTables, safe to read from any thread
+    size_t tableCount() const {
+        return _table_count.load(std::memory_order_relaxed);
+    }
+
   private:
     std::string _dbPath;
     std::unique_ptr<FilePool> _filePool;
     std::unique_ptr<FileCloser> _fileCloser;
+    // SSTables are written into pre-allocated files, so their size tells nothing
+    bool _preAllocated = false;
 
     struct L0Index {
         std::string path;
@@ -84,13 +97,26 @@ class SSTableManager {
     };
 
     std::atomic<IndexNode*> _head{nullptr};
+    std::atomic<size_t> _table_count{0};
 
     // Helper to read from specific file/offset
     bool readValueAt(const std::string& path, uint64_t offset, const std::string& key,
                      std::string& out_value);
 
+    // Bytes of each SSTable indexed so far, up to the last complete record
+    std::map<std::string, uint64_t> _indexed;
+
+    // SSTables in the directory, oldest first
+    std::vector<std::pair<uint64_t, std::string>> listTables() const;
+
+    // Index the records of an SSTable from offset on; returns the offset after the last one
+    uint64_t indexTable(const std::string& path, uint64_t offset, L0Index& index);
+
+    // Publish an index as the newest SSTable
+    void prependIndex(L0Index&& index);
+
     // Internal recovery
-    void recoverState(size_t filePoolSize, size_t preAllocBytes);
+    void recoverState(size_t filePoolSize, size_t preAllocBytes, bool readOnly);
 };
 
 }  // namespace lsmio
@@ -54,6 +54,7 @@ class LSMIOStoreNative : public LSMIOStore {
     // LSMTree Logic
     size_t _memtable_max_size_bytes;
     size_t _max_immutable_memtables;
+    bool _read_only;
 
     std::unique_ptr<Memtable> _active_memtable;
     std::deque<std::unique_ptr<Memtable>> _immutable_memtables;
@@ -80,7 +81,10 @@ class LSMIOStoreNative : public LSMIOStore {
     bool dbCleanup() override;
 
   public:
-    LSMIOStoreNative(const std::string& dbPath, const bool overWrite = false);
+    // A read-only store serves gets and scans of an existing database, so that many readers can
+    // open it at once (e.g. on restart); mutations fail and nothing is written on close
+    LSMIOStoreNative(const std::string& dbPath, const bool overWrite = false,
+                     const bool readOnly = false);
     ~LSMIOStoreNative() override;
 
     void autoTuneParameters(uint64_t fs_magic);
@@ -93,6 +97,10 @@ class LSMIOStoreNative : public LSMIOStore {
 
     bool readBarrier() override;
     bool writeBarrier() override;
+    bool waitForCapacity() override;
+    bool refresh() override;
+
+    void addGauges(LSMIOStoreGauges* gauges) override;
 
     // Accessors for testing
     size_t getMemtableMaxSize() const {
@@ -32,7 +32,9 @@
 #define _LSMIO_STORE_HPP_
 
 #include <atomic>
+#include <cstdint>
 #include <lsmio/lsmio.hpp>
+#include <lsmio/manager/stats.hpp>
 #include <mutex>
 #include <string>
 
@@ -45,6 +47,16 @@ enum class MutationType {
 
 std::string getMutationType(MutationType mType);
 
+/// FNV-1a hash of a key, stable across builds so that partitions can be found again
+uint64_t hashStoreKey(const std::string& key);
+
+/// occupancy of a store, summed over shards and partitions
+struct LSMIOStoreGauges {
+    uint64_t memtableBytes = 0;
+    uint64_t immutableMemtables = 0;
+    uint64_t sstables = 0;
+};
+
 class LSMIOStore {
   protected:
     std::string _dbPath;
@@ -54,6 +66,9 @@ class LSMIOStore {
 
     const std::string _metaPrefix = "__lsmio_md::";
 
+    /// latency histograms of the owner, nullptr when not recorded
+    LSMIOStats* _stats = nullptr;
+
     std::atomic<uint> _batchSize = {0};
     std::atomic<uint> _batchBytes = {0};
     std::mutex _batchMutex;
@@ -98,10 +113,34 @@ class LSMIOStore {
                             std::string inFix = "");
     virtual bool metaPut(const std::string key, const std::string value, bool flush = true);
 
+    /// prefix of the metadata namespace in the store keys
+    const std::string& metaPrefix() const {
+        return _metaPrefix;
+    }
+
     /// sync barriers
     /// @return bool success
     virtual bool readBarrier() = 0;
     virtual bool writeBarrier() = 0;
+
+    /// pick up what another process wrote to the store since it was opened; stores that
+    /// cannot be read while being written ignore it
+    /// @return bool success
+    virtual bool refresh() {
+        return true;
+    }
+
+    /// block until the store can absorb more writes without stalling
+    /// @return bool success
+    virtual bool waitForCapacity();
+
+    /// record flush latencies into the given stats
+    virtual void setStats(LSMIOStats* stats) {
+        _stats = stats;
+    }
+
+    /// add the current occupancy of the store to the gauges; may be called from any thread
+    virtual void addGauges(LSMIOStoreGauges* gauges) {}
 };
 
 }  // namespace lsmio
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LSMIO_STORE_FORWARD_HPP_
+#define _LSMIO_STORE_FORWARD_HPP_
+
+#include <mpi.h>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "store.hpp"
+
+namespace lsmio {
+
+/// Operations a node leader sends to a global writer.
+enum class ForwardOp : char {
+    Batch,
+    Get,
+    Scan,
+    ReadBarrier,
+    WriteBarrier,
+    End
+};
+
+/**
+ * Store of a node leader in hierarchical aggregation.
+ *
+ * Mutations are buffered in one sorted run per global writer and forwarded
+ * once the run reaches forwardBatchBytes or at a barrier. Each writer owns a
+ * hash partition of the keys and applies the runs to its own store, so the
+ * file system sees a few large sequential streams instead of one per node.
+ * Keys are prefixed with the leader index to keep nodes apart.
+ */
+class LSMIOStoreForward : public LSMIOStore {
+  private:
+    /// A buffered mutation.
+    struct ForwardRecord {
+        MutationType type;
+        std::string value;
+    };
+
+    MPI_Comm _comm;
+    int _rank = 0;
+    int _size = 1;
+    int _writers = 1;
+    std::string _nodePrefix;
+
+    /// store of the partition owned by this rank, nullptr unless a writer
+    LSMIOStore* _partition = nullptr;
+    std::thread _writerThread;
+
+    std::mutex _mutex;
+    std::vector<std::map<std::string, ForwardRecord>> _runs;
+    std::vector<uint64_t> _runBytes;
+    bool _isClosed = false;
+
+    /// start / stop batching
+    /// @return bool success
+    bool startBatch() override;
+    bool stopBatch() override;
+
+    bool _batchMutation(MutationType mType, const std::string key, const std::string value,
+                        bool flush) override;
+
+    /// cleanup the ENTIRE store
+    /// @return bool success
+    bool dbCleanup() override;
+
+    int _writerOf(const std::string& key) const;
+    bool _forwardRun(int writer, bool flush);
+    bool _request(int writer, const std::string& request, std::string* reply);
+    bool _barrier(ForwardOp op);
+    void _serveWriter();
+
+  public:
+    /// Message tags on the leader communicator.
+    static const int FORWARD_TAG_REQUEST = 1;
+    static const int FORWARD_TAG_REPLY = 2;
+
+    /**
+     * @param dbPath Path of the leader, used for logging only.
+     * @param comm Communicator of the node leaders; the first writers ranks are writers.
+     * @param writers Number of global writers.
+     * @param partition Store of the partition owned by this rank, nullptr if not a writer.
+     */
+    LSMIOStoreForward(const std::string& dbPath, MPI_Comm comm, int writers,
+                      LSMIOStore* partition);
+    ~LSMIOStoreForward() override;
+
+    void close() override;
+
+    /// get value given a key
+    /// @return bool success
+    bool get(const std::string key, std::string* value) override;
+    bool getPrefix(const std::string key,
+                   std::vector<std::tuple<std::string, std::string>>* values) override;
+
+    /// sync batching
+    /// @return bool success
+    bool readBarrier() override;
+    bool writeBarrier() override;
+
+    void setStats(LSMIOStats* stats) override;
+    void addGauges(LSMIOStoreGauges* gauges) override;
+};
+
+}  // namespace lsmio
+
+#endif
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LSMIO_STORE_SHARDED_HPP_
+#define _LSMIO_STORE_SHARDED_HPP_
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "store.hpp"
+
+namespace lsmio {
+
+/**
+ * Store that spreads keys over several independent stores.
+ *
+ * Each shard has its own memtables, flush thread and files, so an aggregator
+ * can keep several flush pipelines busy. Keys are routed by hash, or by the
+ * source rank of a ranked "<rank>::<key>" key; barriers run on all shards in
+ * parallel and prefix scans merge the shards back into key order.
+ */
+class LSMIOStoreSharded : public LSMIOStore {
+  private:
+    std::vector<LSMIOStore*> _shards;
+    bool _byRank;
+
+    /// start / stop batching
+    /// @return bool success
+    bool startBatch() override;
+    bool stopBatch() override;
+
+    bool _batchMutation(MutationType mType, const std::string key, const std::string value,
+                        bool flush) override;
+
+    /// cleanup the ENTIRE store
+    /// @return bool success
+    bool dbCleanup() override;
+
+    LSMIOStore* _shardOf(const std::string& key) const;
+
+    template <typename F>
+    bool _forAll(F func);
+
+  public:
+    /**
+     * @param dbPath Path of the sharded store, used for logging only.
+     * @param shards Opened stores to take ownership of.
+     * @param byRank Route ranked keys by their source rank instead of by hash.
+     */
+    LSMIOStoreSharded(const std::string& dbPath, std::vector<LSMIOStore*> shards,
+                      bool byRank = false);
+    ~LSMIOStoreSharded() override;
+
+    void close() override;
+
+    /// get value given a key
+    /// @return bool success
+    bool get(const std::string key, std::string* value) override;
+    bool getPrefix(const std::string key,
+                   std::vector<std::tuple<std::string, std::string>>* values) override;
+
+    /// sync batching
+    /// @return bool success
+    bool readBarrier() override;
+    bool writeBarrier() override;
+    bool waitForCapacity() override;
+    bool refresh() override;
+
+    void setStats(LSMIOStats* stats) override;
+    void addGauges(LSMIOStoreGauges* gauges) override;
+
+    size_t shardCount() const {
+        return _shards.size();
+    }
+};
+
+}  // namespace lsmio
+
+#endif
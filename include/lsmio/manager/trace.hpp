@@ -0,0 +1,205 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LSMIO_TRACE_HPP_
+#define _LSMIO_TRACE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace lsmio {
+
+/**
+ * Enum representing the trace points on the I/O hot paths.
+ */
+enum class TraceEvent : uint16_t {
+    Put,
+    PutBatch,
+    Get,
+    GetBatch,
+    Del,
+    MetaPut,
+    MetaGet,
+    MetaGetAll,
+    IPut,
+    IGet,
+    ReadBarrier,
+    WriteBarrier,
+    Serialize,
+    Deserialize,
+    Send,
+    Recv,
+    ServerCommand,
+    StoreGet,
+    StoreGetPrefix,
+    StoreMutation,
+    Count
+};
+
+/**
+ * @brief One binary trace event; the argument is usually a size in bytes.
+ */
+struct TraceRecord {
+    uint64_t ticks;
+    uint64_t arg;
+    uint32_t aux;
+    TraceEvent event;
+};
+
+/**
+ * @class LSMIOTraceRing
+ * @brief Fixed-size ring of the most recent trace events of one thread.
+ *
+ * Single writer (the owning thread), lock-free readers: a dump copies the records below the
+ * published head, so records overwritten while it runs may be torn.
+ */
+class LSMIOTraceRing {
+  public:
+    static constexpr size_t CAPACITY = 8192;
+
+  private:
+    std::atomic<uint64_t> _head{0};
+    TraceRecord _records[CAPACITY];
+    uint64_t _thread;
+
+  public:
+    explicit LSMIOTraceRing(uint64_t thread) : _thread(thread) {}
+
+    void record(TraceEvent event, uint64_t arg, uint32_t aux, uint64_t ticks) {
+        uint64_t head = _head.load(std::memory_order_relaxed);
+        _records[head & (CAPACITY - 1)] = TraceRecord{ticks, arg, aux, event};
+        _head.store(head + 1, std::memory_order_release);
+    }
+
+    uint64_t thread() const {
+        return _thread;
+    }
+
+    /// copy out the buffered events, oldest first
+    /// @return number of events copied
+    size_t snapshot(TraceRecord *records) const;
+};
+
+/**
+ * @brief One completed span of work; names are string literals.
+ */
+struct SpanRecord {
+    const char *name;
+    uint64_t startNs;
+    uint64_t durationNs;
+    uint64_t arg;
+};
+
+/**
+ * @class LSMIOTrace
+ * @brief Process-wide registry of the per-thread trace rings and span buffers.
+ */
+class LSMIOTrace {
+  private:
+    static std::atomic<bool> _spansEnabled;
+
+  public:
+    /// spans kept per thread before further spans are dropped
+    static constexpr size_t MAX_SPANS = 1 << 20;
+
+    /// record an event in the calling thread's ring
+    static void record(TraceEvent event, uint64_t arg = 0, uint32_t aux = 0);
+
+    /// write the buffered events of all threads as text, one event per line:
+    /// "<ns> <thread> <event> <arg> <aux>"
+    static void dump(std::ostream &os);
+    /// @return bool success
+    static bool dump(const std::string &filePath);
+
+    /// start collecting spans, tagged with the given rank
+    static void enableSpans(int rank);
+    /// stop collecting spans, keeping the ones collected
+    static void disableSpans();
+    static bool spansEnabled() {
+        return _spansEnabled.load(std::memory_order_relaxed);
+    }
+    /// keep a completed span in the calling thread's buffer
+    static void addSpan(const char *name, uint64_t startNs, uint64_t durationNs, uint64_t arg);
+    /// write the collected spans as Chrome trace-event JSON and clear them
+    /// @return bool success
+    static bool writeSpans(const std::string &filePath);
+    static void clearSpans();
+    /// @return wall clock nanoseconds, comparable across ranks
+    static uint64_t nowNs();
+};
+
+/**
+ * @class LSMIOSpan
+ * @brief RAII span from construction to destruction; a no-op unless spans are enabled.
+ */
+class LSMIOSpan {
+  private:
+    const char *_name;
+    uint64_t _arg;
+    uint64_t _start = 0;
+
+  public:
+    explicit LSMIOSpan(const char *name, uint64_t arg = 0) : _name(name), _arg(arg) {
+        if (LSMIOTrace::spansEnabled()) _start = LSMIOTrace::nowNs();
+    }
+    ~LSMIOSpan() {
+        if (_start) LSMIOTrace::addSpan(_name, _start, LSMIOTrace::nowNs() - _start, _arg);
+    }
+
+    LSMIOSpan(const LSMIOSpan &) = delete;
+    LSMIOSpan &operator=(const LSMIOSpan &) = delete;
+};
+
+/**
+ * Convert a TraceEvent value to its string representation.
+ * @param v TraceEvent value.
+ * @return String representation of the TraceEvent.
+ */
+std::string to_string(const TraceEvent v);
+
+}  // namespace lsmio
+
+/// Trace points compile to nothing, arguments included, unless LSMIO_ENABLE_TRACE is defined.
+#ifdef LSMIO_ENABLE_TRACE
+#define LSMIO_TRACE(event, arg) ::lsmio::LSMIOTrace::record(::lsmio::TraceEvent::event, (arg))
+#define LSMIO_TRACE2(event, arg, aux) \
+    ::lsmio::LSMIOTrace::record(::lsmio::TraceEvent::event, (arg), (aux))
+#else
+#define LSMIO_TRACE(event, arg) \
+    do {                        \
+    } while (0)
+#define LSMIO_TRACE2(event, arg, aux) \
+    do {                              \
+    } while (0)
+#endif
+
+#endif
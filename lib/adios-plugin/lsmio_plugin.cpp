@@ -33,7 +33,14 @@
 #include <adios2/helper/adiosSystem.h>
 #include <adios2/helper/adiosType.h>
 
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <iterator>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -52,6 +59,7 @@ LsmioPlugin::LsmioPlugin(core::IO &io, const std::string &name, const Mode mode,
 LsmioPlugin::~LsmioPlugin() {
     LOG(INFO) << "LsmioPlugin::~LsmioPlugin(): " << std::endl;
     if (_lm) delete _lm;
+    if (_restartReader) delete _restartReader;
     LOG(INFO) << "LsmioPlugin::~LsmioPlugin(): completed." << std::endl;
 }
 
@@ -71,14 +79,82 @@ Dims convertStrToDims(const std::string &str) {
     return dims;
 }
 
+/// writer rank of a metadata value, -1 for values written before it was recorded
+int metadataRank(const std::string &value) {
+    size_t pos = 0;
+    for (int field = 0; field < 7; field++) {
+        pos = value.find(';', pos);
+        if (pos == std::string::npos) return -1;
+        pos++;
+    }
+
+    size_t end = value.find(';', pos);
+    if (pos == value.length() || pos == end) return -1;
+    return std::stoi(value.substr(pos, end - pos));
+}
+
+/// a metadata record holds one line per block
+void appendRecordLines(const std::string &record, std::vector<std::string> *values) {
+    std::stringstream sStream(record);
+    std::string value;
+    while (std::getline(sStream, value)) {
+        if (!value.empty()) values->push_back(value);
+    }
+}
+
+int parseAggregationParameter(const std::string &name, const std::string &value) {
+    if (value.empty()) return 0;
+
+    try {
+        int parsed = std::stoi(value);
+        if (parsed >= 0) return parsed;
+    } catch (const std::exception &e) {
+    }
+
+    throw std::invalid_argument("ERROR: LsmioPlugin: Invalid " + name + " parameter provided: " +
+                                value);
+}
+
+/// file the writers commit steps to: the number of committed steps and whether the writers
+/// closed, replaced as a whole so that readers never see it half-written
+std::string stepRecordPath(const std::string &fileName, const std::string &dirName) {
+    return restartIndexDir(fileName, dirName) + "/steps";
+}
+
+bool readStepRecord(const std::string &path, size_t *steps, bool *closed) {
+    std::ifstream file(path);
+    if (!(file >> *steps >> *closed)) {
+        *steps = 0;
+        *closed = false;
+        return false;
+    }
+    return true;
+}
+
 void LsmioPlugin::Init() {
     std::string dirName = "", fileName = "";
     std::string aggregationType = "";
     std::string aggregatorRatio = "";
+    std::string aggregatorsPerNode = "";
+    std::string numaAware = "";
+    std::string globalWriters = "";
+    std::string chunkSize = "";
+    std::string decodeThreads = "";
+    std::string streamReader = "";
+    std::string streamWriter = "";
+    std::string pollingSeconds = "";
     dirName = helper::GetParameter("DirName", m_IO.m_Parameters, false, "Init()");
     fileName = helper::GetParameter("FileName", m_IO.m_Parameters, true, "Init()");
     helper::GetParameter(m_IO.m_Parameters, "AggregationType", aggregationType);
     helper::GetParameter(m_IO.m_Parameters, "AggregatorRatio", aggregatorRatio);
+    helper::GetParameter(m_IO.m_Parameters, "AggregatorsPerNode", aggregatorsPerNode);
+    helper::GetParameter(m_IO.m_Parameters, "NumaAware", numaAware);
+    helper::GetParameter(m_IO.m_Parameters, "GlobalWriters", globalWriters);
+    helper::GetParameter(m_IO.m_Parameters, "ChunkSize", chunkSize);
+    helper::GetParameter(m_IO.m_Parameters, "DecodeThreads", decodeThreads);
+    helper::GetParameter(m_IO.m_Parameters, "StreamReader", streamReader);
+    helper::GetParameter(m_IO.m_Parameters, "StreamWriter", streamWriter);
+    helper::GetParameter(m_IO.m_Parameters, "BeginStepPollingFrequencySecs", pollingSeconds);
     LOG(INFO) << "LsmioPlugin::Init: _dbName: " << _dbName
               << " MPI: " << (m_Comm.IsMPI() ? "YES" : "NO") << " rank: " << m_Comm.Rank()
               << " size: " << m_Comm.Size() << " aggregationType: " << aggregationType
@@ -88,6 +164,49 @@ void LsmioPlugin::Init() {
     if (fileName.empty()) {
         throw std::invalid_argument("ERROR: LsmioPlugin: no FileName parameter provided.");
     }
+    _fileName = fileName;
+    _dirName = dirName;
+
+    _chunkBytes = chunkSize.empty() ? gConfigLSMIO.transferSize
+                                    : parseAggregationParameter("ChunkSize", chunkSize);
+    _chunkBytes = std::max<size_t>(_chunkBytes, 1);
+    _decodeThreads = decodeThreads.empty()
+                         ? std::thread::hardware_concurrency()
+                         : parseAggregationParameter("DecodeThreads", decodeThreads);
+    _decodeThreads = std::max<size_t>(_decodeThreads, 1);
+
+    if (!pollingSeconds.empty()) {
+        try {
+            _pollingSeconds = std::stof(pollingSeconds);
+        } catch (const std::exception &e) {
+            _pollingSeconds = -1.0f;
+        }
+        if (_pollingSeconds <= 0.0f) {
+            throw std::invalid_argument(
+                "ERROR: LsmioPlugin: Invalid BeginStepPollingFrequencySecs parameter provided: " +
+                pollingSeconds);
+        }
+    }
+
+    // the store is still being written: read only through the published restart indices,
+    // step by step as BeginStep finds them committed
+    if (m_OpenMode == adios2::Mode::Read && (streamReader == "true" || streamReader == "1")) {
+        LOG(INFO) << "LsmioPlugin::Init: Opening for streaming..." << std::endl;
+        _isStreaming = true;
+        return;
+    }
+
+    // a database written with restart indices is read through them, without a manager, so
+    // that any number of ranks finds the blocks of every writer; only native stores can be
+    // opened by all readers at once, others are read by the ranks that wrote them
+    const bool isReader =
+        m_OpenMode == adios2::Mode::Read || m_OpenMode == adios2::Mode::ReadRandomAccess;
+    if (isReader && std::filesystem::is_directory(restartIndexDir(fileName, dirName)) &&
+        RestartReader()->sharedReads()) {
+        LOG(INFO) << "LsmioPlugin::Init: Reading through the restart indices..." << std::endl;
+        ReadIndexMetadata();
+        return;
+    }
 
     bool overWrite = false;
     if (m_OpenMode == adios2::Mode::Write || m_OpenMode == adios2::Mode::Append) {
@@ -99,12 +218,27 @@ void LsmioPlugin::Init() {
     }
 
     if (m_Comm.IsMPI()) {
+        int ratio = parseAggregationParameter("AggregatorRatio", aggregatorRatio);
+        int perNode = parseAggregationParameter("AggregatorsPerNode", aggregatorsPerNode);
+        if (!aggregatorRatio.empty()) gConfigLSMIO.ranksPerAggregator = ratio;
+        if (!aggregatorsPerNode.empty()) gConfigLSMIO.aggregatorsPerNode = perNode;
+        if (!numaAware.empty())
+            gConfigLSMIO.numaAwareAggregation = (numaAware == "true" || numaAware == "1");
+        if (!globalWriters.empty())
+            gConfigLSMIO.globalWriters = parseAggregationParameter("GlobalWriters", globalWriters);
+        // readers find the blocks of other ranks in the aggregator stores through the index
+        const bool writeRestartIndex = overWrite || m_OpenMode == adios2::Mode::Append;
+        // a "StreamWriter" also commits every step for readers opened as "StreamReader"
+        _publishSteps = writeRestartIndex && (streamWriter == "true" || streamWriter == "1");
+
         if (aggregationType.empty() || aggregationType == "twolevelshm") {
             gConfigLSMIO.mpiAggType = MPIAggType::Shared;
         } else if (aggregationType == "everyonewritesserial") {
             gConfigLSMIO.mpiAggType = MPIAggType::EntireSerial;
+        } else if (aggregationType == "hierarchical") {
+            gConfigLSMIO.mpiAggType = MPIAggType::Hierarchical;
         } else if (aggregationType == "everyonewrites" || aggregationType == "auto") {
-            if (aggregatorRatio == "2")
+            if (ratio > 1)
                 gConfigLSMIO.mpiAggType = MPIAggType::Split;
             else
                 gConfigLSMIO.mpiAggType = MPIAggType::Entire;
@@ -114,60 +248,353 @@ void LsmioPlugin::Init() {
                 aggregationType);
         }
 
+        // only this manager writes the index, not the others the process opens later
+        const bool savedRestartIndex = gConfigLSMIO.writeRestartIndex;
+        gConfigLSMIO.writeRestartIndex = savedRestartIndex || writeRestartIndex;
         _lm = new LSMIOManager(fileName, dirName, overWrite, &m_Comm);
+        gConfigLSMIO.writeRestartIndex = savedRestartIndex;
     } else {
         _lm = new LSMIOManager(fileName, dirName, overWrite);
     }
 
-    if (m_OpenMode == adios2::Mode::Read) {
-        LOG(INFO) << "LsmioPlugin::Init: Opened for reading..." << std::endl;
+    if (isReader || m_OpenMode == adios2::Mode::Append) {
+        LOG(INFO) << "LsmioPlugin::Init: Reading the metadata..." << std::endl;
 
         std::vector<std::tuple<std::string, std::string>> values;
-        bool success = _lm->metaGetAll(&values);
+        bool success = _lm->metaGetAllCollective(&values);
 
         LOG(INFO) << "LsmioPlugin::Init: variableStoreKey success: [" << success << "]"
                   << std::endl;
 
-        for (const auto &[key, value] : values) {
-            std::string name, typeStr, shapeStr, startStr, countStr;
-
-            std::stringstream sStream(value);
+        ReadVarsFromStore(ShareMetadata(values), isReader);
+    }
 
-            std::getline(sStream, name, ';');
-            std::getline(sStream, typeStr, ';');
-            std::getline(sStream, shapeStr, ';');
-            std::getline(sStream, startStr, ';');
-            std::getline(sStream, countStr);
+    // appending continues after the last step any rank has written
+    if (m_OpenMode == adios2::Mode::Append) {
+        uint64_t steps = _stepCount, maxSteps = 0;
+        m_Comm.Allreduce(&steps, &maxSteps, 1, helper::Comm::Op::Max);
+        _currentStep = maxSteps;
+    }
 
-            auto shape = convertStrToDims(shapeStr);
-            auto start = convertStrToDims(startStr);
-            auto count = convertStrToDims(countStr);
+    LOG(INFO) << "LsmioPlugin::Init: completed..." << std::endl;
+}
 
-            const DataType type = helper::GetDataTypeFromString(typeStr);
-            if (type == DataType::Struct) {
-                // not supported
+std::vector<std::string> LsmioPlugin::ShareMetadata(
+    const std::vector<std::tuple<std::string, std::string>> &values) const {
+    std::vector<std::string> shared;
+
+    // every rank contributes the blocks it wrote, so that all ranks see every block;
+    // values without a writer rank only concern the rank that read them
+    std::string own;
+    for (const auto &[key, record] : values) {
+        // a step record holds one line per block
+        std::stringstream sStream(record);
+        std::string value;
+        while (std::getline(sStream, value)) {
+            if (value.empty()) continue;
+
+            const int rank = metadataRank(value);
+            if (rank < 0 || m_Comm.Size() == 1) {
+                shared.push_back(value);
+            } else if (rank == m_Comm.Rank()) {
+                own += value + "\n";
             }
+        }
+    }
+    if (m_Comm.Size() == 1) return shared;
+
+    const std::vector<size_t> sizes = m_Comm.GatherValues(own.size());
+    std::vector<char> all;
+    if (m_Comm.Rank() == 0) {
+        size_t total = 0;
+        for (size_t size : sizes) total += size;
+        all.resize(total);
+    }
+    m_Comm.GathervArrays(own.data(), own.size(), sizes.data(), sizes.size(), all.data());
+    m_Comm.BroadcastVector(all);
+
+    std::stringstream sStream(std::string(all.begin(), all.end()));
+    std::string value;
+    while (std::getline(sStream, value)) {
+        if (!value.empty()) shared.push_back(value);
+    }
+
+    return shared;
+}
+
+void LsmioPlugin::ReadVarsFromStore(const std::vector<std::string> &values, bool define) {
+    for (const std::string &value : values) {
+        std::string name, typeStr, shapeStr, startStr, countStr, stepStr, chunkStr, rankStr, key,
+            minMax;
+
+        std::stringstream sStream(value);
+
+        std::getline(sStream, name, ';');
+        std::getline(sStream, typeStr, ';');
+        std::getline(sStream, shapeStr, ';');
+        std::getline(sStream, startStr, ';');
+        std::getline(sStream, countStr, ';');
+        std::getline(sStream, stepStr, ';');
+        std::getline(sStream, chunkStr, ';');
+        std::getline(sStream, rankStr, ';');
+        std::getline(sStream, key, ';');
+        std::getline(sStream, minMax);
+
+        // metadata without a step was written before variables were step-versioned
+        size_t step = 0;
+        if (stepStr.empty()) {
+            _unversionedVariables.insert(name);
+        } else {
+            step = std::stoull(stepStr);
+        }
+        _stepCount = std::max(_stepCount, step + 1);
+
+        auto shape = convertStrToDims(shapeStr);
+        auto start = convertStrToDims(startStr);
+        auto count = convertStrToDims(countStr);
+
+        // blocks without a rank were written before arrays were chunked, by this rank
+        const int rank = rankStr.empty() ? m_Comm.Rank() : std::stoi(rankStr);
+        const Dims chunk = convertStrToDims(chunkStr);
+        if (key.empty()) key = StepKey::data(step, name, rank);
+        _variableSteps[name][step].push_back({rank, start, count, chunk, key, minMax});
+
+        if (!define) continue;
+
+        // like the BP engines, a global array is selected whole until the reader selects a box
+        if (!shape.empty() && !chunk.empty()) {
+            start.assign(shape.size(), 0);
+            count = shape;
+        }
+
+        const DataType type = helper::GetDataTypeFromString(typeStr);
+        if (type == DataType::Struct) {
+            // not supported
+        }
 #define declare_template_instantiation(T)          \
     else if (type == helper::GetDataType<T>()) {   \
         AddVariable<T>(name, shape, start, count); \
     }
-            ADIOS2_FOREACH_STDTYPE_1ARG(declare_template_instantiation)
+        ADIOS2_FOREACH_STDTYPE_1ARG(declare_template_instantiation)
 #undef declare_template_instantiation
 
-            LOG(INFO) << "LsmioPlugin::Init: variableStoreKey: " << name << std::endl;
+        LOG(INFO) << "LsmioPlugin::ReadVarsFromStore: " << name << " step: " << step << std::endl;
+    }
+
+    if (!define) return;
+
+    for (const auto &vpair : m_IO.GetVariables()) {
+        auto it = _variableSteps.find(vpair.first);
+        if (it == _variableSteps.end()) continue;
+
+        vpair.second->m_AvailableStepsStart = it->second.begin()->first;
+        vpair.second->m_AvailableStepsCount = it->second.size();
+    }
+}
+
+LSMIORestartReader *LsmioPlugin::RestartReader() {
+    if (!_restartReader) _restartReader = new LSMIORestartReader(_fileName, _dirName);
+    return _restartReader;
+}
+
+void LsmioPlugin::PublishSteps(size_t steps, bool closed) const {
+    if (m_Comm.Rank() != 0) return;
+
+    const std::string path = stepRecordPath(_fileName, _dirName);
+    std::filesystem::create_directories(restartIndexDir(_fileName, _dirName));
+    {
+        std::ofstream file(path + ".tmp", std::ios::trunc);
+        file << steps << " " << closed << std::endl;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(path + ".tmp", path, ec);
+    if (ec) {
+        LOG(ERROR) << "LsmioPlugin::PublishSteps: failed: " << path << ": " << ec.message()
+                   << std::endl;
+    }
+}
+
+StepStatus LsmioPlugin::WaitForStep(const float timeoutSeconds) {
+    // rank 0 polls the step record and the other readers follow its verdict
+    int status = static_cast<int>(StepStatus::OK);
+    if (m_Comm.Rank() == 0) {
+        const std::string path = stepRecordPath(_fileName, _dirName);
+        const auto start = std::chrono::steady_clock::now();
+        while (true) {
+            size_t steps;
+            bool closed;
+            readStepRecord(path, &steps, &closed);
+            if (steps > _currentStep) break;
+            if (closed) {
+                status = static_cast<int>(StepStatus::EndOfStream);
+                break;
+            }
+
+            const std::chrono::duration<float> waited = std::chrono::steady_clock::now() - start;
+            if (timeoutSeconds >= 0.0f && waited.count() >= timeoutSeconds) {
+                status = static_cast<int>(StepStatus::NotReady);
+                break;
+            }
+
+            float sleep = _pollingSeconds;
+            if (timeoutSeconds >= 0.0f) sleep = std::min(sleep, timeoutSeconds - waited.count());
+            std::this_thread::sleep_for(std::chrono::duration<float>(sleep));
         }
     }
+    return static_cast<StepStatus>(m_Comm.BroadcastValue(status));
+}
 
-    LOG(INFO) << "LsmioPlugin::Init: completed..." << std::endl;
+void LsmioPlugin::ReadStepMetadata(size_t step) {
+    LSMIORestartReader *reader = RestartReader();
+    reader->refresh();
+
+    // every writer packs the blocks of a step into numbered records
+    std::vector<std::string> values;
+    for (int writer : reader->writers()) {
+        std::string record;
+        for (size_t i = 0; reader->metaGet(writer, StepKey::meta(step, i), &record); i++) {
+            appendRecordLines(record, &values);
+        }
+    }
+
+    LOG(INFO) << "LsmioPlugin::ReadStepMetadata: step: " << step << " blocks: " << values.size()
+              << std::endl;
+    ReadVarsFromStore(values, true);
+}
+
+void LsmioPlugin::ReadIndexMetadata() {
+    LSMIORestartReader *reader = RestartReader();
+
+    // values without a writer rank were written before it was recorded and, as when read
+    // through the manager, only concern the rank of the same number
+    std::vector<std::string> values;
+    for (int writer : reader->writers()) {
+        std::vector<std::string> keys, lines;
+        reader->metaKeys(writer, &keys);
+        for (const std::string &key : keys) {
+            std::string record;
+            if (reader->metaGet(writer, key, &record)) appendRecordLines(record, &lines);
+        }
+
+        for (std::string &value : lines) {
+            if (metadataRank(value) >= 0 || writer == m_Comm.Rank()) {
+                values.push_back(std::move(value));
+            }
+        }
+    }
+
+    LOG(INFO) << "LsmioPlugin::ReadIndexMetadata: writers: " << reader->writers().size()
+              << " blocks: " << values.size() << std::endl;
+    ReadVarsFromStore(values, true);
+}
+
+bool LsmioPlugin::IsLockstep() const {
+    return _lm && !_lm->allowsUnevenCommands();
+}
+
+std::string LsmioPlugin::DataKey(const std::string &name, size_t step) const {
+    if (_unversionedVariables.count(name)) return name;
+    return StepKey::data(step, name, m_Comm.Rank());
+}
+
+std::vector<size_t> LsmioPlugin::SelectedSteps(const core::VariableBase &variable) const {
+    if (_isStepping) return {_currentStep};
+
+    // the step selection counts the steps the variable was written in, like the BP engines
+    auto it = _variableSteps.find(variable.m_Name);
+    if (it == _variableSteps.end() ||
+        variable.m_StepsStart + variable.m_StepsCount > it->second.size()) {
+        throw std::invalid_argument("ERROR: LsmioPlugin: step selection out of range for " +
+                                    variable.m_Name);
+    }
+
+    std::vector<size_t> steps;
+    auto step = std::next(it->second.begin(), variable.m_StepsStart);
+    for (size_t i = 0; i < variable.m_StepsCount; i++, step++) steps.push_back(step->first);
+    return steps;
 }
 
 StepStatus LsmioPlugin::BeginStep(StepMode mode, const float timeoutSeconds) {
-    LOG(INFO) << "LsmioPlugin::BeginStep(): " << std::endl;
+    LOG(INFO) << "LsmioPlugin::BeginStep(): step: " << _currentStep << std::endl;
+    _isStepping = true;
+
+    if (_isStreaming) {
+        const StepStatus status = WaitForStep(timeoutSeconds);
+        if (status == StepStatus::OK) ReadStepMetadata(_currentStep);
+        return status;
+    }
+
+    if (m_OpenMode == adios2::Mode::Read && _currentStep >= _stepCount) {
+        return StepStatus::EndOfStream;
+    }
+
     return StepStatus::OK;
 }
 
+size_t LsmioPlugin::DoSteps() const {
+    return _stepCount;
+}
+
 void LsmioPlugin::PerformGets() {
-    LOG(INFO) << "LsmioPlugin::PerformGets(): " << std::endl;
+    LOG(INFO) << "LsmioPlugin::PerformGets(): chunks: " << _deferredReads.size() << std::endl;
+    if (m_OpenMode == adios2::Mode::Write || m_OpenMode == adios2::Mode::Append) return;
+
+    // cleared before fetching, so a failed read does not leave stale buffers behind
+    std::vector<ChunkRead> reads;
+    reads.swap(_deferredReads);
+    FetchChunks(&reads);
+}
+
+void LsmioPlugin::FetchChunks(std::vector<ChunkRead> *reads) {
+    if (reads->empty() && !IsLockstep()) return;
+
+    // without a manager every chunk is found through the restart indices by its writer;
+    // the aggregator of a manager only holds the chunks of this rank
+    std::vector<std::string> values;
+    if (!_lm) {
+        std::vector<std::tuple<int, std::string>> keys;
+        for (const ChunkRead &read : *reads) keys.emplace_back(read.writer, read.key);
+        RestartReader()->getBatch(keys, &values);
+    } else {
+        std::vector<std::string> keys;
+        for (const ChunkRead &read : *reads) {
+            if (read.writer != m_Comm.Rank()) {
+                throw std::invalid_argument(
+                    "ERROR: LsmioPlugin: blocks of other ranks are only readable from native "
+                    "stores with restart indices: " +
+                    read.key);
+            }
+            keys.push_back(read.key);
+        }
+        _lm->getBatch(keys, &values);
+    }
+
+    // missing values are left empty and reported below
+    size_t bytes = 0;
+    for (size_t i = 0; i < reads->size(); i++) {
+        if (values[i].empty() && (*reads)[i].required) {
+            throw std::invalid_argument("ERROR: LsmioPlugin: no data for " + (*reads)[i].key);
+        }
+        bytes += values[i].size();
+    }
+
+    // chunks land in disjoint parts of the user buffers, so they are decoded in parallel,
+    // with a thread for every MiB or so
+    const size_t threads = std::min({_decodeThreads, reads->size(), bytes / (1 << 20) + 1});
+    auto decode = [&](size_t first) {
+        for (size_t i = first; i < reads->size(); i += threads) (*reads)[i].decode(values[i]);
+    };
+
+    LOG(INFO) << "LsmioPlugin::FetchChunks(): chunks: " << reads->size() << " bytes: " << bytes
+              << " threads: " << threads << std::endl;
+
+    std::vector<std::future<void>> results;
+    for (size_t t = 1; t < threads; t++) {
+        results.push_back(std::async(std::launch::async, decode, t));
+    }
+    decode(0);
+    for (auto &result : results) result.get();
 }
 
 size_t LsmioPlugin::CurrentStep() const {
@@ -179,7 +606,29 @@ void LsmioPlugin::EndStep() {
     LOG(INFO) << "LsmioPlugin::EndStep(): " << std::endl;
 
     if (m_OpenMode == adios2::Mode::Write || m_OpenMode == adios2::Mode::Append) {
+        CommitSpans();
         PerformPuts();
+        _stepBlocks.clear();
+        _stepBlocksWritten = 0;
+        _stepRecords = 0;
+
+        // a step is committed once the indices of all aggregators cover it
+        if (_publishSteps) {
+            m_Comm.Barrier();
+            _lm->publishRestartIndex();
+            m_Comm.Barrier();
+            PublishSteps(_currentStep + 1, false);
+        }
+    } else {
+        PerformGets();
+
+        // a streaming reader keeps only the blocks of the steps still to come
+        if (_isStreaming) {
+            for (auto it = _variableSteps.begin(); it != _variableSteps.end();) {
+                it->second.erase(_currentStep);
+                it = it->second.empty() ? _variableSteps.erase(it) : std::next(it);
+            }
+        }
     }
 
     _currentStep++;
@@ -187,37 +636,144 @@ void LsmioPlugin::EndStep() {
 
 void LsmioPlugin::DoClose(const int transportIndex) {
     LOG(INFO) << "LsmioPlugin::DoClose(): " << std::endl;
+    CommitSpans();
     PerformPuts();
+    PerformGets();
+
+    // blocks put after the last EndStep make one more step
+    uint64_t steps = _currentStep + (_stepBlocks.empty() ? 0 : 1), maxSteps = steps;
+    if (_publishSteps) m_Comm.Allreduce(&steps, &maxSteps, 1, helper::Comm::Op::Max);
+
     if (_lm) _lm->close();
+    if (_restartReader) _restartReader->close();
+
+    // the full indices are saved on close, so the record follows them
+    if (_publishSteps) {
+        m_Comm.Barrier();
+        PublishSteps(maxSteps, true);
+    }
 }
 
-#define declare(T)                                                                  \
-    void LsmioPlugin::DoGetSync(core::Variable<T> &variable, T *values) {           \
-        LOG(INFO) << "LsmioPlugin::DoGetSync(): " << std::endl;                     \
-        ReadVariable(variable, values);                                             \
-    }                                                                               \
-                                                                                    \
-    void LsmioPlugin::DoGetDeferred(core::Variable<T> &variable, T *values) {       \
-        LOG(INFO) << "LsmioPlugin::DoGetDeferred(): " << std::endl;                 \
-        ReadVariable(variable, values);                                             \
-    }                                                                               \
-                                                                                    \
-    void LsmioPlugin::DoPutSync(core::Variable<T> &variable, const T *values) {     \
-        LOG(INFO) << "LsmioPlugin::DoPutSync(): " << std::endl;                     \
-        WriteVariable(variable, values, adios2::Mode::Sync);                        \
-    }                                                                               \
-                                                                                    \
-    void LsmioPlugin::DoPutDeferred(core::Variable<T> &variable, const T *values) { \
-        LOG(INFO) << "LsmioPlugin::DoPutDeferred(): " << std::endl;                 \
-        WriteVariable(variable, values, adios2::Mode::Deferred);                    \
+#define declare(T)                                                                       \
+    void LsmioPlugin::DoGetSync(core::Variable<T> &variable, T *values) {                \
+        LOG(INFO) << "LsmioPlugin::DoGetSync(): " << std::endl;                          \
+        std::pair<T, T> range;                                                           \
+        ReadVariable(variable, values, ValueRange(variable, &range) ? &range : nullptr); \
+    }                                                                                    \
+                                                                                         \
+    void LsmioPlugin::DoGetDeferred(core::Variable<T> &variable, T *values) {            \
+        LOG(INFO) << "LsmioPlugin::DoGetDeferred(): " << std::endl;                      \
+        GetDeferred(variable, values);                                                   \
+    }                                                                                    \
+                                                                                         \
+    void LsmioPlugin::DoPutSync(core::Variable<T> &variable, const T *values) {          \
+        LOG(INFO) << "LsmioPlugin::DoPutSync(): " << std::endl;                          \
+        WriteVariable(variable, values, adios2::Mode::Sync);                             \
+    }                                                                                    \
+                                                                                         \
+    void LsmioPlugin::DoPutDeferred(core::Variable<T> &variable, const T *values) {      \
+        LOG(INFO) << "LsmioPlugin::DoPutDeferred(): " << std::endl;                      \
+        WriteVariable(variable, values, adios2::Mode::Deferred);                         \
+    }                                                                                    \
+                                                                                         \
+    size_t LsmioPlugin::GetInRange(core::Variable<T> &variable, T *values, T lower,      \
+                                   T upper) {                                            \
+        LOG(INFO) << "LsmioPlugin::GetInRange(): " << std::endl;                         \
+        const std::pair<T, T> range(lower, upper);                                       \
+        return ReadVariable(variable, values, &range);                                   \
     }
 
 ADIOS2_FOREACH_STDTYPE_1ARG(declare)
 #undef declare
 
+#define declare(T)                                                                               \
+    void LsmioPlugin::DoPut(core::Variable<T> &variable, typename core::Variable<T>::Span &span, \
+                            const bool initialize, const T &value) {                             \
+        LOG(INFO) << "LsmioPlugin::DoPut(): " << std::endl;                                      \
+        PutSpan(variable, span, initialize, value);                                              \
+    }
+
+ADIOS2_FOREACH_PRIMITIVE_STDTYPE_1ARG(declare)
+#undef declare
+
+#define declare(T, L)                                                                   \
+    T *LsmioPlugin::DoBufferData_##L(const int bufferIdx, const size_t payloadPosition, \
+                                     const size_t bufferID) noexcept {                  \
+        return reinterpret_cast<T *>(&_spanBuffers[bufferIdx][payloadPosition]);        \
+    }
+
+ADIOS2_FOREACH_PRIMITVE_STDTYPE_2ARGS(declare)
+#undef declare
+
+void LsmioPlugin::CommitSpans() {
+    LOG(INFO) << "LsmioPlugin::CommitSpans(): spans: " << _spanPuts.size() << std::endl;
+
+    for (const SpanPut &put : _spanPuts) {
+        const DataType type = put.variable->m_Type;
+        if (type == DataType::Struct) {
+            // not supported
+        }
+#define declare_template_instantiation(T)        \
+    else if (type == helper::GetDataType<T>()) { \
+        CommitSpan<T>(put);                      \
+    }
+        ADIOS2_FOREACH_PRIMITIVE_STDTYPE_1ARG(declare_template_instantiation)
+#undef declare_template_instantiation
+    }
+    _spanPuts.clear();
+    _spanBuffers.clear();
+}
+
+bool LsmioPlugin::VariableMinMax(const core::VariableBase &variable, const size_t step,
+                                 MinMaxStruct &minMax) {
+    const DataType type = variable.m_Type;
+    if (type == DataType::Struct) {
+        // not supported
+    }
+#define declare_template_instantiation(T)                \
+    else if (type == helper::GetDataType<T>()) {         \
+        return BlocksMinMax<T>(variable, step, &minMax); \
+    }
+    ADIOS2_FOREACH_STDTYPE_1ARG(declare_template_instantiation)
+#undef declare_template_instantiation
+
+    return false;
+}
+
 void LsmioPlugin::PerformPuts() {
-    LOG(INFO) << "LsmioPlugin::PerformPuts(): " << std::endl;
-    WriteVarsFromIO(adios2::Mode::Deferred);
+    std::vector<std::tuple<std::string, std::string>> metaValues;
+
+    LOG(INFO) << "LsmioPlugin::PerformPuts(): deferred: " << _deferredPuts.size()
+              << " pending: " << _pendingValues.size() << std::endl;
+
+    for (const DeferredPut &put : _deferredPuts) {
+        const DataType type = put.variable->m_Type;
+        if (type == DataType::Struct) {
+            // not supported
+        }
+#define declare_template_instantiation(T)                                                       \
+    else if (type == helper::GetDataType<T>()) {                                                \
+        EncodeVariable(put.key, static_cast<const T *>(put.values), put.count, &_pendingValues, \
+                       &_stepBlocks[put.block].minMax);                                         \
+    }
+        ADIOS2_FOREACH_STDTYPE_1ARG(declare_template_instantiation)
+#undef declare_template_instantiation
+    }
+    _deferredPuts.clear();
+
+    WriteVarsFromIO(&metaValues);
+    if (m_OpenMode != adios2::Mode::Write && m_OpenMode != adios2::Mode::Append) return;
+
+    if (_pendingValues.empty() && metaValues.empty() && !IsLockstep()) return;
+
+    // one batch for all variables of the step, then a single barrier
+    bool success = _lm->putBatch(_pendingValues, metaValues, false);
+    success &= _lm->writeBarrier();
+    _pendingValues.clear();
+    if (!success) {
+        throw std::runtime_error("ERROR: LsmioPlugin: failed to write the puts of step " +
+                                 std::to_string(_currentStep));
+    }
 }
 
 /*
@@ -226,31 +782,36 @@ void LsmioPlugin::Flush(const int transportIndex) {
 }
 */
 
-void LsmioPlugin::WriteVarsFromIO(const Mode launch) {
-    bool isSync = (launch == Mode::Sync) ? true : false;
-    std::string keyTypes;
-    bool success;
-
-    LOG(INFO) << "LsmioPlugin::WriteVarsFromIO(): Begin..." << std::endl;
-    const core::VarMap &variables = m_IO.GetVariables();
-    for (const auto &vpair : variables) {
-        const std::string &varName = vpair.first;
-        LOG(INFO) << "LsmioPlugin::WriteVarsFromIO(): " << varName << std::endl;
-
-        const DataType varType = vpair.second->m_Type;
-#define declare_template_instantiation(T)                        \
-    if (varType == helper::GetDataType<T>()) {                   \
-        core::Variable<T> *v = m_IO.InquireVariable<T>(varName); \
-        if (!v) {                                                \
-            return;                                              \
-        }                                                        \
-        keyTypes = WriteVariableInfo(*v);                        \
-        success = _lm->metaPut(v->m_Name, keyTypes, isSync);     \
+void LsmioPlugin::WriteVarsFromIO(std::vector<std::tuple<std::string, std::string>> *metaValues) {
+    std::string record;
+
+    LOG(INFO) << "LsmioPlugin::WriteVarsFromIO(): step: " << _currentStep
+              << " new blocks: " << _stepBlocks.size() - _stepBlocksWritten << std::endl;
+
+    // only blocks put since the last call, packed into one record of the step; blocks
+    // from the first pending span on are still being filled and wait for EndStep
+    const size_t end = _spanPuts.empty() ? _stepBlocks.size() : _spanPuts.front().block;
+    for (size_t i = _stepBlocksWritten; i < end; i++) {
+        const PutBlock &block = _stepBlocks[i];
+        const DataType varType = m_IO.InquireVariableType(block.name);
+#define declare_template_instantiation(T)                           \
+    if (varType == helper::GetDataType<T>()) {                      \
+        core::Variable<T> *v = m_IO.InquireVariable<T>(block.name); \
+        if (!v) {                                                   \
+            continue;                                               \
+        }                                                           \
+        if (!record.empty()) record += "\n";                        \
+        record += WriteVariableInfo(*v, block);                     \
     }
 
         ADIOS2_FOREACH_STDTYPE_1ARG(declare_template_instantiation)
 #undef declare_template_instantiation
     }
+    _stepBlocksWritten = end;
+
+    if (!record.empty()) {
+        metaValues->emplace_back(StepKey::meta(_currentStep, _stepRecords++), record);
+    }
 }
 
 }  // namespace lsmio
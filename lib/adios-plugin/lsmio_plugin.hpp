@@ -38,11 +38,19 @@
 #include <adios2/helper/adiosComm.h>
 #include <adios2/helper/adiosString.h>
 
+#include <deque>
 #include <fstream>
+#include <functional>
 #include <lsmio/lsmio.hpp>
 #include <lsmio/manager/manager.hpp>
+#include <lsmio/manager/restart.hpp>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 using namespace adios2;
 
@@ -54,21 +62,36 @@ class LsmioPlugin : public adios2::plugin::PluginEngineInterface {
                 helper::Comm comm);
     virtual ~LsmioPlugin();
 
-    /** Indicates beginning of a step **/
+    /** Indicates beginning of a step; a "StreamReader" waits up to timeoutSeconds (forever
+     ** when negative) for the writer to commit the step **/
     StepStatus BeginStep(StepMode mode, const float timeoutSeconds = -1.0) override;
 
-    /** Indicates end of a step **/
+    /** Indicates end of a step; a "StreamWriter" commits it for streaming readers **/
     void EndStep() override;
 
     /** Return the current step **/
     size_t CurrentStep() const override;
 
-    /** Execute deferred mode Gets **/
+    /** Execute deferred mode Gets: the chunks of all of them are fetched in batches and
+     ** decoded by "DecodeThreads" threads **/
     void PerformGets() override;
 
     /** Execute deferred mode Puts **/
     void PerformPuts() override;
 
+    /** Min / max of a variable in a step (every step for DefaultSizeT) from the chunk
+     ** statistics, without reading the data; backs Variable::MinMax **/
+    bool VariableMinMax(const core::VariableBase &variable, const size_t step,
+                        MinMaxStruct &minMax) override;
+
+    /** Read a selection like a Sync Get, skipping the chunks whose values all lie outside
+     ** [lower, upper]; elements of skipped chunks keep their previous contents. The public
+     ** ADIOS API gets the same with a "ValueRange.<variable>" parameter of "<lower>:<upper>".
+     ** Returns the number of chunks read. **/
+#define declare(T) size_t GetInRange(core::Variable<T> &variable, T *values, T lower, T upper);
+    ADIOS2_FOREACH_STDTYPE_1ARG(declare)
+#undef declare
+
     /** TODO(sbulut): EnginePlugin fails with Flush() call
      ** Flushes data and metadata to a transport
     void Flush(const int transportIndex = -1) override;
@@ -77,6 +100,9 @@ class LsmioPlugin : public adios2::plugin::PluginEngineInterface {
   protected:
     void Init() override;
 
+    /** Number of steps available to a reader **/
+    size_t DoSteps() const override;
+
 #define declare(T)                                                         \
     void DoGetSync(core::Variable<T> &variable, T *values) override;       \
     void DoGetDeferred(core::Variable<T> &variable, T *values) override;   \
@@ -86,28 +112,195 @@ class LsmioPlugin : public adios2::plugin::PluginEngineInterface {
     ADIOS2_FOREACH_STDTYPE_1ARG(declare)
 #undef declare
 
+    /** Put with an engine-owned buffer: the application fills span.Data() and the
+     ** buffer is handed to the store at EndStep (or Close) **/
+#define declare(T)                                                                  \
+    void DoPut(core::Variable<T> &variable, typename core::Variable<T>::Span &span, \
+               const bool initialize, const T &value) override;
+
+    ADIOS2_FOREACH_PRIMITIVE_STDTYPE_1ARG(declare)
+#undef declare
+
+#define declare(T, L)                                                      \
+    T *DoBufferData_##L(const int bufferIdx, const size_t payloadPosition, \
+                        const size_t bufferID = 0) noexcept override;
+
+    ADIOS2_FOREACH_PRIMITVE_STDTYPE_2ARGS(declare)
+#undef declare
+
     void DoClose(const int transportIndex = -1) override;
 
   private:
+    /// array put in deferred mode, read from the user buffer in PerformPuts
+    struct DeferredPut {
+        core::VariableBase *variable;
+        const void *values;
+        Dims count;
+        std::string key;
+        /// index of the block in _stepBlocks
+        size_t block;
+    };
+
+    /// array put through a Span, read from _spanBuffers at EndStep
+    struct SpanPut {
+        core::VariableBase *variable;
+        Dims count;
+        std::string key;
+        /// index of the block in _stepBlocks
+        size_t block;
+        /// index of the buffer in _spanBuffers
+        size_t buffer;
+        /// the buffer has room for the block header in front of the values
+        bool inPlace;
+    };
+
+    /// writer: a block put in the current step, its metadata is written with the step
+    struct PutBlock {
+        std::string name;
+        Dims start;
+        Dims count;
+        std::string key;
+        /// per-chunk statistics, see ChunkStats
+        std::string minMax;
+    };
+
+    /// reader: a block of a variable as one rank wrote it in one step
+    struct BlockInfo {
+        int rank;
+        Dims start;
+        Dims count;
+        /// chunk shape, empty when the block is stored under a single key
+        Dims chunk;
+        /// key the chunk coordinates are appended to
+        std::string key;
+        std::string minMax;
+    };
+
+    /// reader: a stored value to fetch and how it lands in the user buffer
+    struct ChunkRead {
+        int writer;
+        std::string key;
+        /// a missing value is an error
+        bool required;
+        std::function<void(const std::string &)> decode;
+    };
+
     const std::string _variableStoreKey = "__adios_metadata";
 
     std::string _dbName;
+    std::string _fileName;
+    std::string _dirName;
     LSMIOManager *_lm = nullptr;
+    /// reader of the restart indices, opened on first use; readers without a manager fetch
+    /// every block through it
+    LSMIORestartReader *_restartReader = nullptr;
     size_t _currentStep = 0;
+    /// upper bound on the encoded size of an array chunk
+    size_t _chunkBytes = 0;
+
+    std::vector<DeferredPut> _deferredPuts;
+    /// encoded values waiting for PerformPuts: single values and resolved deferred puts
+    std::vector<std::tuple<std::string, std::string>> _pendingValues;
+
+    /// reader: chunks of deferred gets, fetched and decoded together in PerformGets
+    std::vector<ChunkRead> _deferredReads;
+    /// threads decoding the chunks of one PerformGets
+    size_t _decodeThreads = 1;
+
+    std::vector<SpanPut> _spanPuts;
+    /// engine-owned buffers handed out to spans; a deque, so they never move
+    std::deque<std::string> _spanBuffers;
+
+    std::vector<PutBlock> _stepBlocks;
+    /// leading blocks of _stepBlocks whose metadata has been written, and the records
+    /// written for the current step so far
+    size_t _stepBlocksWritten = 0;
+    size_t _stepRecords = 0;
+    /// reader: blocks of each variable by the step they were written in, and variables
+    /// stored without steps
+    std::map<std::string, std::map<size_t, std::vector<BlockInfo>>> _variableSteps;
+    std::set<std::string> _unversionedVariables;
+    size_t _stepCount = 0;
+    /// set by the first BeginStep; reads then follow the current step
+    bool _isStepping = false;
+
+    /// writer: commit every step for streaming readers
+    bool _publishSteps = false;
+    /// reader: consume steps while the store is still being written, polling for them
+    bool _isStreaming = false;
+    float _pollingSeconds = 1.0f;
+
+    std::vector<std::string> ShareMetadata(
+        const std::vector<std::tuple<std::string, std::string>> &values) const;
+    void ReadVarsFromStore(const std::vector<std::string> &values, bool define);
+    LSMIORestartReader *RestartReader();
+
+    void PublishSteps(size_t steps, bool closed) const;
+    StepStatus WaitForStep(const float timeoutSeconds);
+    void ReadStepMetadata(size_t step);
+    void ReadIndexMetadata();
+
+    /// the aggregator of the manager expects the same commands from all of its clients, so
+    /// every rank sends its batches in PerformPuts and PerformGets even when they are empty;
+    /// single values read at once still differ between ranks, so this only narrows the gap
+    bool IsLockstep() const;
+
+    std::string DataKey(const std::string &name, size_t step) const;
+    std::vector<size_t> SelectedSteps(const core::VariableBase &variable) const;
 
     template <typename T>
     void AddVariable(const std::string &name, Dims shape, Dims start, Dims count);
 
     template <class T>
-    void ReadVariable(core::Variable<T> &variable, T *values);
+    size_t ReadVariable(core::Variable<T> &variable, T *values,
+                        const std::pair<T, T> *range = nullptr);
+
+    template <class T>
+    void GetDeferred(core::Variable<T> &variable, T *values);
+
+    template <class T>
+    size_t PlanRead(core::Variable<T> &variable, T *values, const std::pair<T, T> *range,
+                    std::vector<ChunkRead> *reads);
+
+    template <class T>
+    size_t PlanChunks(core::Variable<T> &variable, const std::vector<BlockInfo> &blocks,
+                      T *values, const std::pair<T, T> *range, std::vector<ChunkRead> *reads);
+
+    void FetchChunks(std::vector<ChunkRead> *reads);
+
+    template <class T>
+    bool ValueRange(const core::Variable<T> &variable, std::pair<T, T> *range) const;
 
-    void WriteVarsFromIO(const Mode launch);
+    template <class T>
+    bool BlocksMinMax(const core::VariableBase &variable, size_t step, MinMaxStruct *minMax) const;
+
+    template <class T>
+    void ReadTextVariable(core::Variable<T> &variable, const std::string &vals, T *values);
+
+    void WriteVarsFromIO(std::vector<std::tuple<std::string, std::string>> *metaValues);
+
+    template <typename T>
+    std::string WriteVariableInfo(core::Variable<T> &variable, const PutBlock &block);
+
+    template <typename T>
+    void EncodeVariable(const std::string &key, const T *values, const Dims &count,
+                        std::vector<std::tuple<std::string, std::string>> *encoded,
+                        std::string *minMax);
 
     template <typename T>
-    std::string WriteVariableInfo(core::Variable<T> &variable);
+    size_t AddPutBlock(core::Variable<T> &variable);
 
     template <typename T>
     void WriteVariable(core::Variable<T> &variable, const T *values, const Mode launch);
+
+    template <typename T>
+    void PutSpan(core::Variable<T> &variable, typename core::Variable<T>::Span &span,
+                 const bool initialize, const T &value);
+
+    void CommitSpans();
+
+    template <typename T>
+    void CommitSpan(const SpanPut &put);
 };
 
 }  // namespace lsmio
@@ -32,6 +32,7 @@
 #define _LSMIO_PLUGIN_TCC_
 
 #include "lsmio_plugin.hpp"
+#include "lsmio_plugin_format.hpp"
 
 namespace lsmio {
 
@@ -56,10 +57,214 @@ void LsmioPlugin::AddVariable(const std::string &name, Dims shape, Dims start, D
 }
 
 template <class T>
-inline void LsmioPlugin::ReadVariable(core::Variable<T> &variable, T *values) {
-    LOG(INFO) << "LsmioPlugin::ReadVariable<T>: " << variable.m_Name << std::endl;
-    std::string vals;
-    bool success = _lm->get(variable.m_Name, &vals);
+inline size_t LsmioPlugin::ReadVariable(core::Variable<T> &variable, T *values,
+                                        const std::pair<T, T> *range) {
+    std::vector<ChunkRead> reads;
+    const size_t chunks = PlanRead(variable, values, range, &reads);
+    FetchChunks(&reads);
+    return chunks;
+}
+
+template <class T>
+inline void LsmioPlugin::GetDeferred(core::Variable<T> &variable, T *values) {
+    std::pair<T, T> range;
+    const std::pair<T, T> *valueRange = ValueRange(variable, &range) ? &range : nullptr;
+
+    // single values are read at once, like the BP engines; arrays wait for PerformGets
+    if (variable.m_SingleValue) {
+        ReadVariable(variable, values, valueRange);
+    } else {
+        PlanRead(variable, values, valueRange, &_deferredReads);
+    }
+}
+
+template <class T>
+inline size_t LsmioPlugin::PlanRead(core::Variable<T> &variable, T *values,
+                                    const std::pair<T, T> *range, std::vector<ChunkRead> *reads) {
+    LOG(INFO) << "LsmioPlugin::PlanRead<T>: " << variable.m_Name << std::endl;
+    const std::vector<size_t> steps = SelectedSteps(variable);
+    const size_t stepSize = helper::GetTotalSize(variable.m_Count);
+    size_t chunks = 0;
+
+    for (size_t i = 0; i < steps.size(); i++) {
+        // a global array is assembled from the chunked blocks of every rank, a local array
+        // is the block this rank wrote or the one picked by a block selection
+        std::vector<BlockInfo> blocks;
+        auto it = _variableSteps.find(variable.m_Name);
+        if (it != _variableSteps.end() && it->second.count(steps[i])) {
+            const std::vector<BlockInfo> &stepBlocks = it->second.at(steps[i]);
+            const bool isLocal = variable.m_Shape.empty();
+            const bool isBlockSelection = variable.m_SelectionType == SelectionType::WriteBlock;
+
+            for (size_t b = 0; b < stepBlocks.size(); b++) {
+                const BlockInfo &block = stepBlocks[b];
+                if (block.chunk.empty()) continue;
+                if (isLocal && isBlockSelection && b != variable.m_BlockID) continue;
+                if (isLocal && !isBlockSelection && block.rank != m_Comm.Rank()) continue;
+
+                blocks.push_back(block);
+                if (isLocal) break;
+            }
+        }
+        if (!blocks.empty()) {
+            chunks += PlanChunks(variable, blocks, values + i * stepSize, range, reads);
+            continue;
+        }
+
+        // a value under a single key of this rank; data written before the binary
+        // encoding is comma-separated text
+        T *stepValues = values + i * stepSize;
+        reads->push_back({m_Comm.Rank(), DataKey(variable.m_Name, steps[i]), true,
+                          [this, &variable, stepValues, stepSize](const std::string &vals) {
+                              if (BlockCodec::isBlock(vals)) {
+                                  BlockCodec::decode(vals, stepValues, stepSize);
+                              } else {
+                                  ReadTextVariable(variable, vals, stepValues);
+                              }
+                          }});
+        chunks++;
+    }
+
+    return chunks;
+}
+
+template <class T>
+inline size_t LsmioPlugin::PlanChunks(core::Variable<T> &variable,
+                                      const std::vector<BlockInfo> &blocks, T *values,
+                                      const std::pair<T, T> *range,
+                                      std::vector<ChunkRead> *reads) {
+    const Dims &selCount = variable.m_Count;
+    const Dims selStart =
+        variable.m_Start.empty() ? Dims(selCount.size(), 0) : Dims(variable.m_Start);
+    size_t chunks = 0;
+
+    // only the chunks overlapping the selection are fetched
+    for (const BlockInfo &block : blocks) {
+        // local array blocks are read whole, from their own origin
+        const Dims blockStart = (block.start.empty() || variable.m_Shape.empty())
+                                    ? Dims(block.count.size(), 0)
+                                    : block.start;
+        Dims start, count, first, last;
+        if (blockStart.size() != selCount.size() ||
+            !ChunkLayout::intersect(blockStart, block.count, selStart, selCount, &start, &count) ||
+            !ChunkLayout::chunkRange(blockStart, block.chunk, start, count, &first, &last)) {
+            continue;
+        }
+
+        // chunks whose values all lie outside the range are not read
+        std::vector<std::pair<T, T>> stats;
+        Dims grid(block.count.size());
+        if constexpr (std::is_arithmetic<T>::value) {
+            if (range) stats = ChunkStats::parse<T>(block.minMax);
+        }
+        for (size_t d = 0; d < grid.size(); d++) {
+            grid[d] = (block.count[d] + block.chunk[d] - 1) / block.chunk[d];
+        }
+
+        Dims coords = first;
+        do {
+            if constexpr (std::is_arithmetic<T>::value) {
+                const size_t index = ChunkLayout::offset(grid, coords);
+                if (index < stats.size() && (stats[index].second < range->first ||
+                                             range->second < stats[index].first)) {
+                    continue;
+                }
+            }
+
+            Dims chunkStart(coords.size()), chunkCount(coords.size());
+            for (size_t d = 0; d < coords.size(); d++) {
+                chunkStart[d] = blockStart[d] + coords[d] * block.chunk[d];
+                chunkCount[d] =
+                    std::min(block.chunk[d], blockStart[d] + block.count[d] - chunkStart[d]);
+            }
+
+            // the selection is captured, so a deferred read keeps the one it was made with
+            reads->push_back({block.rank, StepKey::chunk(block.key, coords), true,
+                              [chunkStart, chunkCount, selStart, selCount,
+                               values](const std::string &data) {
+                                  thread_local std::vector<T> chunkValues;
+                                  chunkValues.resize(ChunkLayout::elements(chunkCount));
+                                  BlockCodec::decode(data, chunkValues.data(), chunkValues.size());
+
+                                  Dims start, count;
+                                  ChunkLayout::intersect(chunkStart, chunkCount, selStart,
+                                                         selCount, &start, &count);
+                                  ChunkLayout::copyBox(
+                                      reinterpret_cast<const char *>(chunkValues.data()),
+                                      chunkStart, chunkCount, reinterpret_cast<char *>(values),
+                                      selStart, selCount, start, count, sizeof(T));
+                              }});
+            chunks++;
+        } while (ChunkLayout::next(first, last, &coords));
+    }
+
+    LOG(INFO) << "LsmioPlugin::PlanChunks<T>: " << variable.m_Name << " chunks: " << chunks
+              << std::endl;
+
+    return chunks;
+}
+
+template <class T>
+inline bool LsmioPlugin::ValueRange(const core::Variable<T> &variable,
+                                    std::pair<T, T> *range) const {
+    if constexpr (std::is_arithmetic<T>::value) {
+        auto it = m_IO.m_Parameters.find("ValueRange." + variable.m_Name);
+        if (it == m_IO.m_Parameters.end()) return false;
+
+        std::vector<std::pair<T, T>> ranges = ChunkStats::parse<T>(it->second);
+        if (ranges.size() != 1) {
+            throw std::invalid_argument(
+                "ERROR: LsmioPlugin: Invalid ValueRange parameter provided: " + it->second);
+        }
+        *range = ranges[0];
+        return true;
+    }
+
+    return false;
+}
+
+template <class T>
+inline bool LsmioPlugin::BlocksMinMax(const core::VariableBase &variable, size_t step,
+                                      MinMaxStruct *minMax) const {
+    if constexpr (std::is_arithmetic<T>::value) {
+        auto it = _variableSteps.find(variable.m_Name);
+        if (it == _variableSteps.end()) return false;
+
+        // DefaultSizeT asks for every step, or the current one while stepping
+        bool found = false;
+        T min{}, max{};
+        for (const auto &[blockStep, blocks] : it->second) {
+            if (step == DefaultSizeT ? (_isStepping && blockStep != _currentStep)
+                                     : blockStep != step) {
+                continue;
+            }
+
+            for (size_t b = 0; b < blocks.size(); b++) {
+                if (variable.m_SelectionType == SelectionType::WriteBlock &&
+                    b != variable.m_BlockID) {
+                    continue;
+                }
+                for (const auto &[lo, hi] : ChunkStats::parse<T>(blocks[b].minMax)) {
+                    min = (!found || lo < min) ? lo : min;
+                    max = (!found || max < hi) ? hi : max;
+                    found = true;
+                }
+            }
+        }
+        if (!found) return false;
+
+        std::memcpy(&minMax->MinUnion, &min, sizeof(T));
+        std::memcpy(&minMax->MaxUnion, &max, sizeof(T));
+        return true;
+    }
+
+    return false;
+}
+
+template <class T>
+inline void LsmioPlugin::ReadTextVariable(core::Variable<T> &variable, const std::string &vals,
+                                          T *values) {
+    LOG(INFO) << "LsmioPlugin::ReadTextVariable<T>: " << variable.m_Name << std::endl;
     if (vals.find(",") == vals.npos) {
         values[0] = helper::StringTo<T>(vals, "");
     } else {
@@ -75,16 +280,25 @@ inline void LsmioPlugin::ReadVariable(core::Variable<T> &variable, T *values) {
 }
 
 template <>
-inline void LsmioPlugin::ReadVariable(core::Variable<std::string> &variable, std::string *values) {
-    LOG(INFO) << "LsmioPlugin::ReadVariable<string>: " << variable.m_Name << std::endl;
-    bool success = _lm->get(variable.m_Name, &(values[0]));
+inline size_t LsmioPlugin::PlanRead(core::Variable<std::string> &variable, std::string *values,
+                                    const std::pair<std::string, std::string> *range,
+                                    std::vector<ChunkRead> *reads) {
+    LOG(INFO) << "LsmioPlugin::PlanRead<string>: " << variable.m_Name << std::endl;
+    const std::vector<size_t> steps = SelectedSteps(variable);
+
+    for (size_t i = 0; i < steps.size(); i++) {
+        std::string *value = values + i;
+        reads->push_back({m_Comm.Rank(), DataKey(variable.m_Name, steps[i]), false,
+                          [value](const std::string &data) { *value = data; }});
+    }
+
+    return steps.size();
 }
 
 template <>
-inline void LsmioPlugin::ReadVariable(core::Variable<char> &variable, char *values) {
-    LOG(INFO) << "LsmioPlugin::ReadVariable<char>: " << variable.m_Name << std::endl;
-    std::string value;
-    bool success = _lm->get(variable.m_Name, &value);
+inline void LsmioPlugin::ReadTextVariable(core::Variable<char> &variable,
+                                          const std::string &value, char *values) {
+    LOG(INFO) << "LsmioPlugin::ReadTextVariable<char>: " << variable.m_Name << std::endl;
     std::vector<std::string> valueArray;
     commaSplit(value, valueArray);
 
@@ -94,11 +308,9 @@ inline void LsmioPlugin::ReadVariable(core::Variable<char> &variable, char *valu
 }
 
 template <>
-inline void LsmioPlugin::ReadVariable(core::Variable<unsigned char> &variable,
-                                      unsigned char *values) {
-    LOG(INFO) << "LsmioPlugin::ReadVariable<unsigned char>: " << variable.m_Name << std::endl;
-    std::string value;
-    bool success = _lm->get(variable.m_Name, &value);
+inline void LsmioPlugin::ReadTextVariable(core::Variable<unsigned char> &variable,
+                                          const std::string &value, unsigned char *values) {
+    LOG(INFO) << "LsmioPlugin::ReadTextVariable<unsigned char>: " << variable.m_Name << std::endl;
     std::vector<std::string> valueArray;
     commaSplit(value, valueArray);
 
@@ -108,10 +320,9 @@ inline void LsmioPlugin::ReadVariable(core::Variable<unsigned char> &variable,
 }
 
 template <>
-inline void LsmioPlugin::ReadVariable(core::Variable<signed char> &variable, signed char *values) {
-    LOG(INFO) << "LsmioPlugin::ReadVariable<signed char>: " << variable.m_Name << std::endl;
-    std::string value;
-    bool success = _lm->get(variable.m_Name, &value);
+inline void LsmioPlugin::ReadTextVariable(core::Variable<signed char> &variable,
+                                          const std::string &value, signed char *values) {
+    LOG(INFO) << "LsmioPlugin::ReadTextVariable<signed char>: " << variable.m_Name << std::endl;
     std::vector<std::string> valueArray;
     commaSplit(value, valueArray);
 
@@ -121,10 +332,9 @@ inline void LsmioPlugin::ReadVariable(core::Variable<signed char> &variable, sig
 }
 
 template <>
-inline void LsmioPlugin::ReadVariable(core::Variable<short> &variable, short *values) {
-    LOG(INFO) << "LsmioPlugin::ReadVariable<short>: " << variable.m_Name << std::endl;
-    std::string value;
-    bool success = _lm->get(variable.m_Name, &value);
+inline void LsmioPlugin::ReadTextVariable(core::Variable<short> &variable,
+                                          const std::string &value, short *values) {
+    LOG(INFO) << "LsmioPlugin::ReadTextVariable<short>: " << variable.m_Name << std::endl;
     std::vector<std::string> valueArray;
     commaSplit(value, valueArray);
 
@@ -134,11 +344,9 @@ inline void LsmioPlugin::ReadVariable(core::Variable<short> &variable, short *va
 }
 
 template <>
-inline void LsmioPlugin::ReadVariable(core::Variable<unsigned short> &variable,
-                                      unsigned short *values) {
-    LOG(INFO) << "LsmioPlugin::ReadVariable<unsigned short>: " << variable.m_Name << std::endl;
-    std::string value;
-    bool success = _lm->get(variable.m_Name, &value);
+inline void LsmioPlugin::ReadTextVariable(core::Variable<unsigned short> &variable,
+                                          const std::string &value, unsigned short *values) {
+    LOG(INFO) << "LsmioPlugin::ReadTextVariable<unsigned short>: " << variable.m_Name << std::endl;
     std::vector<std::string> valueArray;
     commaSplit(value, valueArray);
 
@@ -148,10 +356,9 @@ inline void LsmioPlugin::ReadVariable(core::Variable<unsigned short> &variable,
 }
 
 template <>
-inline void LsmioPlugin::ReadVariable(core::Variable<long double> &variable, long double *values) {
-    LOG(INFO) << "LsmioPlugin::ReadVariable<long double>: " << variable.m_Name << std::endl;
-    std::string value;
-    bool success = _lm->get(variable.m_Name, &value);
+inline void LsmioPlugin::ReadTextVariable(core::Variable<long double> &variable,
+                                          const std::string &value, long double *values) {
+    LOG(INFO) << "LsmioPlugin::ReadTextVariable<long double>: " << variable.m_Name << std::endl;
     std::vector<std::string> valueArray;
     commaSplit(value, valueArray);
 
@@ -166,25 +373,32 @@ inline void LsmioPlugin::ReadVariable(core::Variable<long double> &variable, lon
 }
 
 template <>
-inline void LsmioPlugin::ReadVariable(core::Variable<std::complex<float>> &variable,
-                                      std::complex<float> *values) {
-    LOG(INFO) << "LsmioPlugin::ReadVariable<float>: " << variable.m_Name << std::endl;
-    throw std::invalid_argument("ERROR: std::complex<float> not supported in this engine");
+inline void LsmioPlugin::ReadTextVariable(core::Variable<std::complex<float>> &variable,
+                                          const std::string &value, std::complex<float> *values) {
+    LOG(INFO) << "LsmioPlugin::ReadTextVariable<float>: " << variable.m_Name << std::endl;
+    throw std::invalid_argument("ERROR: text-encoded std::complex<float> not supported");
 }
 
 template <>
-inline void LsmioPlugin::ReadVariable(core::Variable<std::complex<double>> &variable,
-                                      std::complex<double> *values) {
-    LOG(INFO) << "LsmioPlugin::ReadVariable<double>: " << variable.m_Name << std::endl;
-    throw std::invalid_argument("ERROR: std::complex<double> not supported in this engine");
+inline void LsmioPlugin::ReadTextVariable(core::Variable<std::complex<double>> &variable,
+                                          const std::string &value, std::complex<double> *values) {
+    LOG(INFO) << "LsmioPlugin::ReadTextVariable<double>: " << variable.m_Name << std::endl;
+    throw std::invalid_argument("ERROR: text-encoded std::complex<double> not supported");
 }
 
 template <typename T>
-std::string LsmioPlugin::WriteVariableInfo(core::Variable<T> &variable) {
+std::string LsmioPlugin::WriteVariableInfo(core::Variable<T> &variable, const PutBlock &block) {
     std::ostringstream valueStream;
 
+    // single values are stored under one key, arrays in chunks of this shape
+    Dims chunk;
+    if (!variable.m_SingleValue && !block.count.empty()) {
+        chunk = ChunkLayout::chunkShape(block.count, sizeof(T), _chunkBytes);
+    }
+
     valueStream << variable.m_Name << ";" << variable.m_Type << ";" << variable.m_Shape << ";"
-                << variable.m_Start << ";" << variable.m_Count;
+                << block.start << ";" << block.count << ";" << _currentStep << ";" << chunk
+                << ";" << m_Comm.Rank() << ";" << block.key << ";" << block.minMax;
 
     LOG(INFO) << "LsmioPlugin::WriteVariableInfo(): key: " << _variableStoreKey << ": "
               << valueStream.str() << std::endl;
@@ -192,32 +406,151 @@ std::string LsmioPlugin::WriteVariableInfo(core::Variable<T> &variable) {
     return valueStream.str();
 }
 
+template <typename T>
+inline void LsmioPlugin::EncodeVariable(
+    const std::string &key, const T *values, const Dims &count,
+    std::vector<std::tuple<std::string, std::string>> *encoded, std::string *minMax) {
+    std::string value;
+
+    if (count.empty()) {
+        BlockCodec::encode(values, 1, &value);
+        encoded->emplace_back(key, std::move(value));
+        return;
+    }
+    if (ChunkLayout::elements(count) == 0) return;
+
+    // chunks are contiguous in the block, so each one is encoded straight from the user buffer
+    const Dims chunk = ChunkLayout::chunkShape(count, sizeof(T), _chunkBytes);
+    Dims first(count.size(), 0), last(count.size()), coords(count.size(), 0);
+    for (size_t d = 0; d < count.size(); d++) last[d] = (count[d] - 1) / chunk[d];
+
+    do {
+        Dims start(count.size()), chunkCount(count.size());
+        for (size_t d = 0; d < count.size(); d++) {
+            start[d] = coords[d] * chunk[d];
+            chunkCount[d] = std::min(chunk[d], count[d] - start[d]);
+        }
+
+        const T *chunkValues = values + ChunkLayout::offset(count, start);
+        const size_t n = ChunkLayout::elements(chunkCount);
+        if constexpr (std::is_arithmetic<T>::value) {
+            T min, max;
+            ChunkStats::minMax(chunkValues, n, &min, &max);
+            ChunkStats::append(min, max, minMax);
+        }
+
+        BlockCodec::encode(chunkValues, n, &value);
+        encoded->emplace_back(StepKey::chunk(key, coords), std::move(value));
+    } while (ChunkLayout::next(first, last, &coords));
+}
+
+template <>
+inline void LsmioPlugin::EncodeVariable(
+    const std::string &key, const std::string *values, const Dims &count,
+    std::vector<std::tuple<std::string, std::string>> *encoded, std::string *minMax) {
+    encoded->emplace_back(key, values[0]);
+}
+
+template <typename T>
+inline size_t LsmioPlugin::AddPutBlock(core::Variable<T> &variable) {
+    // every put of an array is a block of its own, recorded with the selection it had
+    size_t index = 0;
+    for (const PutBlock &block : _stepBlocks) {
+        if (block.name == variable.m_Name) index++;
+    }
+    const int rank = m_Comm.Rank();
+    const std::string key = variable.m_SingleValue
+                                ? DataKey(variable.m_Name, _currentStep)
+                                : StepKey::block(_currentStep, variable.m_Name, rank, index);
+    _stepBlocks.push_back({variable.m_Name, variable.m_Start, variable.m_Count, key});
+
+    return _stepBlocks.size() - 1;
+}
+
 template <typename T>
 inline void LsmioPlugin::WriteVariable(core::Variable<T> &variable, const T *values,
                                        const Mode launch) {
-    std::ostringstream valueStream;
-    bool isSync = (launch == Mode::Sync) ? true : false;
+    const Dims count = variable.m_SingleValue ? Dims() : variable.m_Count;
+    const size_t block = AddPutBlock(variable);
+    const std::string key = _stepBlocks[block].key;
+    std::string *minMax = &_stepBlocks[block].minMax;
+
+    // single values are copied at once, like the BP engines; arrays stay in the
+    // user buffer until PerformPuts
+    if (launch == Mode::Deferred && !variable.m_SingleValue) {
+        _deferredPuts.push_back({&variable, values, count, key, block});
+        return;
+    }
 
-    for (size_t i = 0; i < variable.SelectionSize(); ++i) {
-        valueStream << values[i];
-        if (i < variable.SelectionSize() - 1) {
-            valueStream << ",";
-        }
+    if (launch == Mode::Deferred) {
+        EncodeVariable(key, values, count, &_pendingValues, minMax);
+        return;
     }
 
-    LOG(INFO) << "LsmioPlugin::WriteVariable<T>: key: " << variable.m_Name << ": "
-              << valueStream.str() << std::endl;
+    std::vector<std::tuple<std::string, std::string>> encoded;
+    EncodeVariable(key, values, count, &encoded, minMax);
 
-    bool success = _lm->put(variable.m_Name, valueStream.str(), isSync);
+    LOG(INFO) << "LsmioPlugin::WriteVariable<T>: " << variable.m_Name
+              << " keys: " << encoded.size() << std::endl;
+
+    if (!_lm->putBatch(encoded, {}, true)) {
+        throw std::runtime_error("ERROR: LsmioPlugin: failed to write " + variable.m_Name);
+    }
 }
 
-template <>
-inline void LsmioPlugin::WriteVariable(core::Variable<std::string> &variable,
-                                       const std::string *values, const Mode launch) {
-    bool isSync = (launch == Mode::Sync) ? true : false;
-    LOG(INFO) << "LsmioPlugin::WriteVariable<string>: key: " << variable.m_Name << ": " << values[0]
-              << std::endl;
-    bool success = _lm->put(variable.m_Name, values[0], isSync);
+template <typename T>
+inline void LsmioPlugin::PutSpan(core::Variable<T> &variable,
+                                 typename core::Variable<T>::Span &span, const bool initialize,
+                                 const T &value) {
+    const Dims count = variable.m_SingleValue ? Dims() : variable.m_Count;
+    const size_t block = AddPutBlock(variable);
+    const size_t elements = ChunkLayout::elements(count);
+
+    // a block that fits in one chunk is allocated as its encoded value: the application
+    // writes behind the header and EndStep hands the buffer over as it is
+    const bool inPlace =
+        !count.empty() && ChunkLayout::chunkShape(count, sizeof(T), _chunkBytes) == count;
+    const size_t position = inPlace ? BlockCodec::HEADER_SIZE : 0;
+
+    _spanBuffers.emplace_back(position + elements * sizeof(T), '\0');
+    if (initialize) {
+        std::fill_n(reinterpret_cast<T *>(&_spanBuffers.back()[position]), elements, value);
+    }
+
+    span.m_BufferIdx = static_cast<int>(_spanBuffers.size() - 1);
+    span.m_PayloadPosition = position;
+    _spanPuts.push_back(
+        {&variable, count, _stepBlocks[block].key, block, _spanBuffers.size() - 1, inPlace});
+
+    // core::Engine keys the spans of a variable by its number of blocks
+    variable.SetBlockInfo(nullptr, _currentStep);
+}
+
+template <typename T>
+inline void LsmioPlugin::CommitSpan(const SpanPut &put) {
+    std::string &buffer = _spanBuffers[put.buffer];
+    std::string *minMax = &_stepBlocks[put.block].minMax;
+
+    if (put.inPlace) {
+        const T *values = reinterpret_cast<const T *>(&buffer[BlockCodec::HEADER_SIZE]);
+        const size_t n = ChunkLayout::elements(put.count);
+        if constexpr (std::is_arithmetic<T>::value) {
+            T min, max;
+            ChunkStats::minMax(values, n, &min, &max);
+            ChunkStats::append(min, max, minMax);
+        }
+
+        BlockCodec::seal<T>(&buffer);
+        _pendingValues.emplace_back(StepKey::chunk(put.key, Dims(put.count.size(), 0)),
+                                    std::move(buffer));
+    } else {
+        EncodeVariable(put.key, reinterpret_cast<const T *>(buffer.data()), put.count,
+                       &_pendingValues, minMax);
+    }
+
+    core::Variable<T> &variable = *static_cast<core::Variable<T> *>(put.variable);
+    variable.m_BlocksInfo.clear();
+    variable.m_BlocksSpan.clear();
 }
 
 }  // namespace lsmio
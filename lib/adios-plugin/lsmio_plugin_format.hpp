@@ -0,0 +1,481 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _LSMIO_PLUGIN_FORMAT_HPP_
+#define _LSMIO_PLUGIN_FORMAT_HPP_
+
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lsmio {
+
+/**
+ * @brief On-disk encoding of numeric ADIOS variables.
+ *
+ * A block is a 16 byte header followed by the raw elements in little-endian
+ * order. The first magic byte is not printable, so a block can never be taken
+ * for the comma-separated text that older versions of the plugin wrote.
+ *
+ *   0 magic "\x89LSB"   4 version   5 type   6 element size   7 reserved
+ *   8 element count (u64)           16 elements
+ */
+enum class BlockType : uint8_t {
+    Unknown = 0,
+    Char,
+    Int8,
+    Int16,
+    Int32,
+    Int64,
+    UInt8,
+    UInt16,
+    UInt32,
+    UInt64,
+    Float,
+    Double,
+    LongDouble,
+    FloatComplex,
+    DoubleComplex
+};
+
+template <typename T>
+struct BlockTraits {
+    static constexpr BlockType type = BlockType::Unknown;
+};
+
+#define LSMIO_BLOCK_TRAITS(T, TYPE)                        \
+    template <>                                            \
+    struct BlockTraits<T> {                                \
+        static constexpr BlockType type = BlockType::TYPE; \
+    };
+
+LSMIO_BLOCK_TRAITS(char, Char)
+LSMIO_BLOCK_TRAITS(signed char, Int8)
+LSMIO_BLOCK_TRAITS(short, Int16)
+LSMIO_BLOCK_TRAITS(int, Int32)
+LSMIO_BLOCK_TRAITS(long, Int64)
+LSMIO_BLOCK_TRAITS(long long, Int64)
+LSMIO_BLOCK_TRAITS(unsigned char, UInt8)
+LSMIO_BLOCK_TRAITS(unsigned short, UInt16)
+LSMIO_BLOCK_TRAITS(unsigned int, UInt32)
+LSMIO_BLOCK_TRAITS(unsigned long, UInt64)
+LSMIO_BLOCK_TRAITS(unsigned long long, UInt64)
+LSMIO_BLOCK_TRAITS(float, Float)
+LSMIO_BLOCK_TRAITS(double, Double)
+LSMIO_BLOCK_TRAITS(long double, LongDouble)
+LSMIO_BLOCK_TRAITS(std::complex<float>, FloatComplex)
+LSMIO_BLOCK_TRAITS(std::complex<double>, DoubleComplex)
+#undef LSMIO_BLOCK_TRAITS
+
+struct BlockHeader {
+    BlockType type = BlockType::Unknown;
+    uint8_t elementSize = 0;
+    uint64_t count = 0;
+};
+
+class BlockCodec {
+  public:
+    static constexpr char MAGIC[4] = {'\x89', 'L', 'S', 'B'};
+    static constexpr uint8_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 16;
+
+    /// true if data starts with a binary block header
+    static bool isBlock(const std::string &data) {
+        return data.size() >= HEADER_SIZE && std::memcmp(data.data(), MAGIC, 4) == 0;
+    }
+
+    static bool readHeader(const std::string &data, BlockHeader *header) {
+        if (!isBlock(data) || static_cast<uint8_t>(data[4]) != VERSION) return false;
+
+        header->type = static_cast<BlockType>(data[5]);
+        header->elementSize = static_cast<uint8_t>(data[6]);
+        header->count = 0;
+        for (int i = 7; i >= 0; i--) {
+            header->count = (header->count << 8) | static_cast<uint8_t>(data[8 + i]);
+        }
+
+        const size_t payload = data.size() - HEADER_SIZE;
+        return header->elementSize && payload % header->elementSize == 0 &&
+               payload / header->elementSize == header->count;
+    }
+
+    template <typename T>
+    static void encode(const T *values, size_t count, std::string *out) {
+        static_assert(BlockTraits<T>::type != BlockType::Unknown, "no block type for T");
+
+        out->resize(HEADER_SIZE + count * sizeof(T));
+        char *p = &(*out)[0];
+
+        writeHeader<T>(p, count);
+        copyElements<T>(p + HEADER_SIZE, reinterpret_cast<const char *>(values), count);
+    }
+
+    /**
+     * @brief Encode a block in place.
+     *
+     * @param block HEADER_SIZE spare bytes followed by the native values; the header is
+     *              written into the spare bytes, so the values are never copied.
+     */
+    template <typename T>
+    static void seal(std::string *block) {
+        static_assert(BlockTraits<T>::type != BlockType::Unknown, "no block type for T");
+
+        char *p = &(*block)[0];
+        const size_t count = (block->size() - HEADER_SIZE) / sizeof(T);
+
+        writeHeader<T>(p, count);
+        // big-endian hosts still swap, from a copy of the native values
+        if (isBigEndian() && sizeof(T) > 1) {
+            const std::string native(p + HEADER_SIZE, count * sizeof(T));
+            copyElements<T>(p + HEADER_SIZE, native.data(), count);
+        }
+    }
+
+    /**
+     * @brief Decode a block into values.
+     *
+     * @param data The encoded block.
+     * @param values Receives the elements.
+     * @param count Number of elements values can hold; must match the block.
+     * @throws std::invalid_argument if the block is malformed or of another type.
+     */
+    template <typename T>
+    static void decode(const std::string &data, T *values, size_t count) {
+        BlockHeader header;
+
+        if (!readHeader(data, &header)) {
+            throw std::invalid_argument("ERROR: BlockCodec: malformed block.");
+        }
+        if (header.type != BlockTraits<T>::type || header.elementSize != sizeof(T)) {
+            throw std::invalid_argument("ERROR: BlockCodec: block type mismatch.");
+        }
+        if (header.count != count) {
+            throw std::invalid_argument("ERROR: BlockCodec: block has " +
+                                        std::to_string(header.count) + " elements, expected " +
+                                        std::to_string(count));
+        }
+
+        copyElements<T>(reinterpret_cast<char *>(values), data.data() + HEADER_SIZE, count);
+    }
+
+  private:
+    static bool isBigEndian() {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    template <typename T>
+    static void writeHeader(char *p, size_t count) {
+        std::memcpy(p, MAGIC, 4);
+        p[4] = static_cast<char>(VERSION);
+        p[5] = static_cast<char>(BlockTraits<T>::type);
+        p[6] = static_cast<char>(sizeof(T));
+        p[7] = 0;
+        for (int i = 0; i < 8; i++) {
+            p[8 + i] = static_cast<char>((static_cast<uint64_t>(count) >> (8 * i)) & 0xff);
+        }
+    }
+
+    // memcpy on little-endian hosts, otherwise swap each scalar (complex has two)
+    template <typename T>
+    static void copyElements(char *dst, const char *src, size_t count) {
+        if (!isBigEndian() || sizeof(T) == 1) {
+            std::memcpy(dst, src, count * sizeof(T));
+            return;
+        }
+
+        const size_t scalar = (BlockTraits<T>::type == BlockType::FloatComplex ||
+                               BlockTraits<T>::type == BlockType::DoubleComplex)
+                                  ? sizeof(T) / 2
+                                  : sizeof(T);
+        const size_t scalars = count * sizeof(T) / scalar;
+        for (size_t i = 0; i < scalars; i++) {
+            for (size_t b = 0; b < scalar; b++) {
+                dst[i * scalar + b] = src[i * scalar + scalar - 1 - b];
+            }
+        }
+    }
+};
+
+/**
+ * @brief Store keys of step-versioned variables.
+ *
+ * The zero-padded step comes first, so the data and metadata of one step are
+ * contiguous in the store and reading a step is a sequential range scan.
+ *
+ *   data   s0000000003/<name>/000012                        (step 3, written by rank 12)
+ *   block  s0000000003/<name>/000012/000001                 (its second block of the step)
+ *   chunk  s0000000003/<name>/000012/000001/000004_000000   (chunk 4,0 of that block)
+ *   meta   s0000000003/@000000   (first metadata record of step 3, one line per block)
+ */
+class StepKey {
+  public:
+    static std::string step(size_t step) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "s%010zu", step);
+        return buf;
+    }
+
+    static std::string data(size_t step, const std::string &name, int rank) {
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), "/%06d", rank);
+        return StepKey::step(step) + "/" + name + buf;
+    }
+
+    /// data key of the block-th array block a rank put in a step
+    static std::string block(size_t step, const std::string &name, int rank, size_t block) {
+        char buf[24];
+        std::snprintf(buf, sizeof(buf), "/%06zu", block);
+        return data(step, name, rank) + buf;
+    }
+
+    static std::string meta(size_t step, size_t record) {
+        char buf[24];
+        std::snprintf(buf, sizeof(buf), "/@%06zu", record);
+        return StepKey::step(step) + buf;
+    }
+
+    /// data key of one chunk of an array block: <block key>/<c0>_<c1>...
+    static std::string chunk(const std::string &blockKey, const std::vector<size_t> &coords) {
+        std::string key = blockKey;
+        char buf[24];
+        for (size_t d = 0; d < coords.size(); d++) {
+            std::snprintf(buf, sizeof(buf), "%c%06zu", d ? '_' : '/', coords[d]);
+            key += buf;
+        }
+        return key;
+    }
+};
+
+/**
+ * @brief Chunk grid of an array block and hyperslab copies between boxes.
+ *
+ * Dimensions are row-major. A chunk spans single elements in its leading
+ * dimensions, a run in one dimension and everything after it, so every chunk
+ * is contiguous in the memory of the block it was cut from.
+ */
+class ChunkLayout {
+  public:
+    using Dims = std::vector<size_t>;
+
+    /// shape of the chunks of a block of count elements, each at most chunkBytes
+    static Dims chunkShape(const Dims &count, size_t elementSize, size_t chunkBytes) {
+        Dims chunk(count);
+        size_t inner = elementSize;
+        for (size_t d = count.size(); d-- > 0;) {
+            if (inner * count[d] > chunkBytes) {
+                chunk[d] = std::max<size_t>(1, chunkBytes / inner);
+                for (size_t o = 0; o < d; o++) chunk[o] = 1;
+                break;
+            }
+            inner *= count[d];
+        }
+        return chunk;
+    }
+
+    static size_t elements(const Dims &count) {
+        size_t n = 1;
+        for (size_t c : count) n *= c;
+        return n;
+    }
+
+    /// row-major element offset of start within a box of count elements
+    static size_t offset(const Dims &count, const Dims &start) {
+        size_t offset = 0;
+        for (size_t d = 0; d < count.size(); d++) offset = offset * count[d] + start[d];
+        return offset;
+    }
+
+    /// chunk coordinates [first, last] of a block overlapping the box; false if none do
+    static bool chunkRange(const Dims &blockStart, const Dims &chunk, const Dims &start,
+                           const Dims &count, Dims *first, Dims *last) {
+        first->resize(chunk.size());
+        last->resize(chunk.size());
+        for (size_t d = 0; d < chunk.size(); d++) {
+            if (count[d] == 0 || start[d] < blockStart[d]) return false;
+            (*first)[d] = (start[d] - blockStart[d]) / chunk[d];
+            (*last)[d] = (start[d] + count[d] - 1 - blockStart[d]) / chunk[d];
+        }
+        return true;
+    }
+
+    /// advance coords to the next chunk in [first, last] in row-major order
+    static bool next(const Dims &first, const Dims &last, Dims *coords) {
+        for (size_t d = coords->size(); d-- > 0;) {
+            if ((*coords)[d] < last[d]) {
+                (*coords)[d]++;
+                return true;
+            }
+            (*coords)[d] = first[d];
+        }
+        return false;
+    }
+
+    /// intersection of two boxes; false if they do not overlap
+    static bool intersect(const Dims &aStart, const Dims &aCount, const Dims &bStart,
+                          const Dims &bCount, Dims *start, Dims *count) {
+        start->resize(aStart.size());
+        count->resize(aStart.size());
+        for (size_t d = 0; d < aStart.size(); d++) {
+            size_t lo = std::max(aStart[d], bStart[d]);
+            size_t hi = std::min(aStart[d] + aCount[d], bStart[d] + bCount[d]);
+            if (lo >= hi) return false;
+            (*start)[d] = lo;
+            (*count)[d] = hi - lo;
+        }
+        return true;
+    }
+
+    /// copy the box (start, count) from the src box into the dst box, one memcpy per row
+    static void copyBox(const char *src, const Dims &srcStart, const Dims &srcCount, char *dst,
+                        const Dims &dstStart, const Dims &dstCount, const Dims &start,
+                        const Dims &count, size_t elementSize) {
+        const size_t ndim = count.size();
+        if (ndim == 0) {
+            std::memcpy(dst, src, elementSize);
+            return;
+        }
+
+        Dims srcStride(ndim), dstStride(ndim), index(ndim, 0);
+        srcStride[ndim - 1] = dstStride[ndim - 1] = elementSize;
+        for (size_t d = ndim - 1; d-- > 0;) {
+            srcStride[d] = srcStride[d + 1] * srcCount[d + 1];
+            dstStride[d] = dstStride[d + 1] * dstCount[d + 1];
+        }
+
+        const size_t run = count[ndim - 1] * elementSize;
+        do {
+            size_t srcOffset = 0, dstOffset = 0;
+            for (size_t d = 0; d < ndim; d++) {
+                srcOffset += (start[d] + index[d] - srcStart[d]) * srcStride[d];
+                dstOffset += (start[d] + index[d] - dstStart[d]) * dstStride[d];
+            }
+            std::memcpy(dst + dstOffset, src + srcOffset, run);
+        } while (nextRow(count, &index));
+    }
+
+  private:
+    static bool nextRow(const Dims &count, Dims *index) {
+        for (size_t d = count.size() - 1; d-- > 0;) {
+            if (++(*index)[d] < count[d]) return true;
+            (*index)[d] = 0;
+        }
+        return false;
+    }
+};
+
+/**
+ * @brief Min / max statistics of array chunks.
+ *
+ * Kept in the block metadata as "min:max,min:max,..." in chunk order, so that
+ * readers can answer MinMax queries and skip chunks without reading them.
+ * Only arithmetic types have statistics.
+ */
+class ChunkStats {
+  public:
+    /// min and max of n > 0 values; independent lanes let the compiler vectorise the loop
+    template <typename T>
+    static void minMax(const T *values, size_t n, T *min, T *max) {
+        constexpr size_t LANES = 8;
+        T lo[LANES], hi[LANES];
+        for (size_t l = 0; l < LANES; l++) lo[l] = hi[l] = values[0];
+
+        size_t i = 0;
+        for (; i + LANES <= n; i += LANES) {
+            for (size_t l = 0; l < LANES; l++) {
+                lo[l] = values[i + l] < lo[l] ? values[i + l] : lo[l];
+                hi[l] = hi[l] < values[i + l] ? values[i + l] : hi[l];
+            }
+        }
+        for (; i < n; i++) {
+            lo[0] = values[i] < lo[0] ? values[i] : lo[0];
+            hi[0] = hi[0] < values[i] ? values[i] : hi[0];
+        }
+
+        *min = lo[0];
+        *max = hi[0];
+        for (size_t l = 1; l < LANES; l++) {
+            *min = lo[l] < *min ? lo[l] : *min;
+            *max = *max < hi[l] ? hi[l] : *max;
+        }
+    }
+
+    template <typename T>
+    static void append(T min, T max, std::string *stats) {
+        std::ostringstream os;
+        os.precision(std::numeric_limits<T>::max_digits10);
+        // unary plus prints character types as numbers
+        os << (stats->empty() ? "" : ",") << +min << ":" << +max;
+        *stats += os.str();
+    }
+
+    template <typename T>
+    static std::vector<std::pair<T, T>> parse(const std::string &stats) {
+        std::vector<std::pair<T, T>> ranges;
+        std::stringstream ss(stats);
+        std::string range;
+
+        while (std::getline(ss, range, ',')) {
+            size_t sep = range.find(':', 1);
+            if (sep == std::string::npos) break;
+            ranges.emplace_back(parseValue<T>(range.substr(0, sep)),
+                                parseValue<T>(range.substr(sep + 1)));
+        }
+        return ranges;
+    }
+
+  private:
+    template <typename T>
+    static T parseValue(const std::string &value) {
+        if constexpr (std::is_floating_point<T>::value) {
+            return static_cast<T>(std::stold(value));
+        } else if constexpr (std::is_signed<T>::value) {
+            return static_cast<T>(std::stoll(value));
+        } else {
+            return static_cast<T>(std::stoull(value));
+        }
+    }
+};
+
+}  // namespace lsmio
+
+#endif
@@ -136,6 +136,9 @@ std::string to_string(const MPIAggType v) {
         case MPIAggType::Split:
             sVal = "mpiSplit";
             break;
+        case MPIAggType::Hierarchical:
+            sVal = "mpiHierarchical";
+            break;
     }
 
     return sVal;
@@ -159,6 +162,24 @@ std::string to_string(const StorageType v) {
     return sVal;
 }
 
+std::string to_string(const ClientTransport v) {
+    std::string sVal;
+
+    switch (v) {
+        case ClientTransport::MPI:
+            sVal = "MPI";
+            break;
+        case ClientTransport::SharedMemory:
+            sVal = "SharedMemory";
+            break;
+        case ClientTransport::Adios:
+            sVal = "Adios";
+            break;
+    }
+
+    return sVal;
+}
+
 }  // namespace lsmio
 
 std::ostream &operator<<(std::ostream &os, lsmio::MPIAggType v) {
@@ -171,6 +192,11 @@ std::ostream &operator<<(std::ostream &os, lsmio::StorageType v) {
     return os;
 }
 
+std::ostream &operator<<(std::ostream &os, lsmio::ClientTransport v) {
+    os << lsmio::to_string(v);
+    return os;
+}
+
 std::ostream &operator<<(std::ostream &os, const lsmio::MPIAggType &v) {
     os << lsmio::to_string(v);
     return os;
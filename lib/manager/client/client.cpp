@@ -30,9 +30,11 @@
 
 #include <mpi.h>
 
+#include <algorithm>
 #include <chrono>  // NOLINT [build/c++11]
 #include <iostream>
 #include <lsmio/manager/client/client.hpp>
+#include <lsmio/manager/trace.hpp>
 #include <map>
 #include <thread>  // NOLINT [build/c++11]
 
@@ -51,15 +53,19 @@
 namespace lsmio {
 
 const std::string KV_CMD::GET = "get";
+const std::string KV_CMD::GET_BATCH = "getBatch";
 const std::string KV_CMD::PUT = "put";
+const std::string KV_CMD::PUT_BATCH = "putBatch";
 const std::string KV_CMD::DEL = "del";
 const std::string KV_CMD::META_GET = "metaGet";
 const std::string KV_CMD::META_GET_ALL = "metaGetAll";
 const std::string KV_CMD::META_PUT = "metaPut";
 const std::string KV_CMD::READ_BARRIER = "rBarrier";
 const std::string KV_CMD::WRITE_BARRIER = "wBarrier";
+const std::string KV_CMD::WAIT_CAPACITY = "wCapacity";
 
 const std::string KV_CMD_RETURN::GET = "getBack";
+const std::string KV_CMD_RETURN::GET_BATCH = "getBatchBack";
 const std::string KV_CMD_RETURN::META_GET = "metaGetBack";
 const std::string KV_CMD_RETURN::META_GET_ALL = "metaGetAllBack";
 const std::string KV_CMD_RETURN::READ_BARRIER = "rBarrierBack";
@@ -109,31 +115,25 @@ bool LSMIOClient::checkThreadSupport() {
 void LSMIOClient::serializeCmd(std::string *buf, const std::string &command, const std::string &key,
                                const std::string &value) {
     buf->append(command + _COL_SEPARATOR_STR + key + _COL_SEPARATOR_STR + value);
-    LOG(INFO) << "LSMIOClient::serializeCmd: "
-              << " size : " << buf->size()
-              << " buf : " << (buf->size() > 80 ? buf->substr(0, 80) + "..." : *buf) << std::endl;
+    LSMIO_TRACE(Serialize, buf->size());
 }
 
 // "cmd;key;value"
 // "0123456789012"
-void LSMIOClient::deSerializeCmd(const char *buf, const int &len, std::string *command,
+void LSMIOClient::deSerializeCmd(const char *buf, const size_t &len, std::string *command,
                                  std::string *key, std::string *value) {
-    int cmdSize = strchr(buf, _COL_SEPARATOR_CHAR) - buf;
+    size_t cmdSize = strchr(buf, _COL_SEPARATOR_CHAR) - buf;
     command->assign(buf, cmdSize);
 
     cmdSize += 1;
-    int keySize = strchr(buf + cmdSize, _COL_SEPARATOR_CHAR) - (buf + cmdSize);
+    size_t keySize = strchr(buf + cmdSize, _COL_SEPARATOR_CHAR) - (buf + cmdSize);
     key->assign(buf + cmdSize, keySize);
 
     keySize += 1;
-    int valSize = len - (keySize + cmdSize);
+    size_t valSize = len - (keySize + cmdSize);
     value->assign(buf + cmdSize + keySize, valSize);
 
-    LOG(INFO) << "LSMIOClient::deSerializeCmd:"
-              << " my rank: " << _rank << " command : " << *command << " key : " << *key
-              << " size : " << value->size()
-              << " value : " << (value->size() > 80 ? value->substr(0, 80) + "..." : *value)
-              << std::endl;
+    LSMIO_TRACE(Deserialize, len);
 }
 
 bool LSMIOClient::stopCollectiveIOServer() {
@@ -155,8 +155,10 @@ bool LSMIOClient::stopCollectiveIOServer() {
 bool LSMIOClient::stopCollectiveIOClient(int rank) {
     LOG(INFO) << "LSMIOClient::stopCollectiveIOClient: aggregation rank: " << rank << std::endl;
     std::string retValue;
+    _isCreditClient = false;
     sendCommand(rank, _EOL_COMMAND, KV_DUMMY, retValue);
     LOG(INFO) << "LSMIOClient::stopCollectiveIOClient: sent for _EOL_COMMAND: " << std::endl;
+    _drainCredits(rank);
     _barrier();  // B99: server/client: End Process
     LOG(INFO) << "LSMIOClient::stopCollectiveIOClient(): Barrier reached. Cleaning up client..."
               << std::endl;
@@ -165,6 +167,7 @@ bool LSMIOClient::stopCollectiveIOClient(int rank) {
 
 bool LSMIOClient::startCollectiveIOClient() {
     LOG(INFO) << "LSMIOClient::startCollectiveIOClient: ..." << std::endl;
+    _isCreditClient = _creditsEnabled();
     _barrier();  // B99: server/client: End Process
     LOG(INFO) << "LSMIOClient::startCollectiveIOClient: Barrier reached." << std::endl;
 
@@ -190,22 +193,145 @@ bool LSMIOClient::startCollectiveIOServer(LSMIOClientCallback func, LSMIOManager
     return true;
 }
 
+int64_t LSMIOClient::_commandBytes(const std::string &command, const std::string &key,
+                                   const std::string &value) {
+    return command.size() + key.size() + value.size() + 2;
+}
+
+bool LSMIOClient::_creditsEnabled() const {
+    return false;
+}
+
+void LSMIOClient::_sendCredits(int rank, int64_t bytes, int64_t msgs) {}
+
+bool LSMIOClient::_recvCredits(int rank, bool block, int64_t *bytes, int64_t *msgs) {
+    return false;
+}
+
+bool LSMIOClient::_hasPendingCommand(int rank) {
+    return true;
+}
+
+bool LSMIOClient::allowsUnevenCommands() const {
+    return false;
+}
+
+void LSMIOClient::_acquireCredits(int rank, int64_t bytes) {
+    if (!_isCreditClient) return;
+
+    const int64_t maxBytes = gConfigLSMIO.creditBytes;
+    const int64_t maxMsgs = gConfigLSMIO.creditMessages;
+    int64_t gBytes, gMsgs;
+
+    while (_recvCredits(rank, false, &gBytes, &gMsgs)) {
+        _creditBytesUsed -= gBytes;
+        _creditMsgsUsed -= gMsgs;
+    }
+
+    // a command larger than the window is let through once nothing else is in flight
+    while (_creditMsgsUsed > 0 && ((maxBytes > 0 && _creditBytesUsed + bytes > maxBytes) ||
+                                   (maxMsgs > 0 && _creditMsgsUsed + 1 > maxMsgs))) {
+        LOG(INFO) << "LSMIOClient::_acquireCredits: waiting, in flight: " << _creditBytesUsed
+                  << " bytes / " << _creditMsgsUsed << " commands." << std::endl;
+        LSMIOSpan span("client.creditWait", bytes);
+        _recvCredits(rank, true, &gBytes, &gMsgs);
+        _creditBytesUsed -= gBytes;
+        _creditMsgsUsed -= gMsgs;
+    }
+
+    _creditBytesUsed += bytes;
+    _creditMsgsUsed++;
+}
+
+void LSMIOClient::_drainCredits(int rank) {
+    int64_t gBytes, gMsgs;
+
+    while (_creditMsgsUsed > 0) {
+        _recvCredits(rank, true, &gBytes, &gMsgs);
+        _creditBytesUsed -= gBytes;
+        _creditMsgsUsed -= gMsgs;
+    }
+}
+
+void LSMIOClient::_grantCredits(LSMIOClientCallback func, LSMIOManager *lm,
+                                const std::vector<int> &eolRanks) {
+    const int64_t halfBytes = gConfigLSMIO.creditBytes / 2;
+    const int64_t halfMsgs = gConfigLSMIO.creditMessages / 2;
+    bool capacityChecked = false;
+
+    for (int rank = 0; rank < _size; rank++) {
+        if (rank == _rank || _owedMsgs[rank] == 0) continue;
+
+        bool grant = eolRanks[rank] || (halfBytes > 0 && _owedBytes[rank] >= halfBytes) ||
+                     (halfMsgs > 0 && _owedMsgs[rank] >= halfMsgs) || !_hasPendingCommand(rank);
+        if (!grant) continue;
+
+        // let the store catch up with its flushes before more data is admitted
+        if (!capacityChecked) {
+            std::string retValue;
+            (lm->*func)(_rank, KV_CMD::WAIT_CAPACITY, KV_DUMMY, &retValue, KV_DUMMY);
+            capacityChecked = true;
+        }
+
+        _sendCredits(rank, _owedBytes[rank], _owedMsgs[rank]);
+        _owedBytes[rank] = 0;
+        _owedMsgs[rank] = 0;
+    }
+}
+
+LSMIOSendRequest *LSMIOClient::isendCommand(int rank, const std::string &command,
+                                            const std::string &key, const std::string &value,
+                                            int tag) {
+    sendCommand(rank, command, key, value, tag);
+    return nullptr;
+}
+
 void LSMIOClient::_cancelWaitForCommand() {
     LOG(INFO) << "LSMIOClient::_cancelWaitForCommand: " << _loopRunning << std::endl;
     _loopRunning = 0;
     _serverThread.join();
 }
 
+char **LSMIOClient::_recvToBuffer(const std::vector<int> &ready, size_t *bufSizes, int *tags) {
+    return nullptr;
+}
+
+void LSMIOClient::_recvCommands(const std::vector<int> &ready, std::vector<std::string> *commands,
+                                std::vector<std::string> *keys, std::vector<std::string> *values,
+                                std::vector<int> *tags) {
+    size_t *bufSizes = new size_t[_size];
+    char **recvBuf = _recvToBuffer(ready, bufSizes, tags->data());
+
+    for (int recv_i = 0; recv_i < _size; recv_i++) {
+        if (!ready[recv_i]) continue;
+
+        deSerializeCmd(recvBuf[recv_i], bufSizes[recv_i], &(*commands)[recv_i],
+                       &(*keys)[recv_i], &(*values)[recv_i]);
+        delete[] recvBuf[recv_i];
+    }
+
+    delete[] recvBuf;
+    delete[] bufSizes;
+}
+
 void LSMIOClient::_waitForCommand(LSMIOClientCallback func, LSMIOManager *lm) {
-    unsigned int loopCounter = 0;
     std::vector<int> eolRanks(_size, 0);
 
     LOG(INFO) << "LSMIOClient::_waitForCommand: Starting..." << std::endl;
+    const bool useCredits = _creditsEnabled();
+    _owedBytes.assign(_size, 0);
+    _owedMsgs.assign(_size, 0);
+
+    // rounds in a row without a command; an idle aggregator yields a few times, then sleeps
+    // for exponentially longer up to about a millisecond, so that it does not hold a core
+    // while the application computes
+    const size_t idleYields = 16, idleMaxShift = 10;
+    size_t idleRounds = 0;
 
     _loopRunning = 1;
     while (true) {
         bool allClientsShutDown = true;
-        int recv_i, req_count;
+        int recv_i;
 
         for (recv_i = 0; recv_i < _size; recv_i++) {
             if (recv_i == _rank) continue;
@@ -220,50 +346,82 @@ void LSMIOClient::_waitForCommand(LSMIOClientCallback func, LSMIOManager *lm) {
             break;
         }
 
-        LOG(INFO) << "LSMIOClient::_waitForCommand: Waiting for buffers to be filled..."
-                  << std::endl;
-        int *bufSizes = new int[_size];
-        char **recvBuf = _recvToBuffer(bufSizes);
+        // a round takes the commands that have arrived, so clients need not issue the same
+        // number of them; finished clients are never waited on again
+        std::vector<int> ready(_size, 0);
+        size_t readyCount = 0;
+        for (recv_i = 0; recv_i < _size; recv_i++) {
+            if (recv_i == _rank || eolRanks[recv_i]) continue;
+            ready[recv_i] = _hasPendingCommand(recv_i) ? 1 : 0;
+            readyCount += ready[recv_i];
+        }
 
-        for (recv_i = 0, req_count = 0; recv_i < _size; recv_i++) {
-            if (recv_i == _rank) continue;
+        if (readyCount == 0) {
+            if (idleRounds < idleYields) {
+                std::this_thread::yield();
+            } else {
+                const size_t shift = std::min(idleRounds - idleYields, idleMaxShift);
+                std::this_thread::sleep_for(std::chrono::microseconds(1 << shift));
+            }
+            idleRounds++;
+            continue;
+        }
+        idleRounds = 0;
 
-            std::string str_cmd, str_key, str_val;
-            deSerializeCmd(recvBuf[recv_i], bufSizes[recv_i], &str_cmd, &str_key, &str_val);
+        std::vector<std::string> recvCmds(_size), recvKeys(_size), recvVals(_size);
+        std::vector<int> recvTags(_size, KV_TAG_BLOCKING);
+        {
+            LSMIOSpan span("aggregator.recv");
+            _recvCommands(ready, &recvCmds, &recvKeys, &recvVals, &recvTags);
+        }
+        _queueDepth.store(readyCount, std::memory_order_relaxed);
+
+        for (recv_i = 0; recv_i < _size; recv_i++) {
+            if (!ready[recv_i]) continue;
 
-            LOG(INFO) << "LSMIOClient::_waitForCommand: "
-                      << " rank: " << recv_i << " cmd: " << str_cmd << " key: " << str_key
-                      << " val.size: " << str_val.size()
-                      << " val: " << (str_val.size() > 80 ? str_val.substr(0, 80) + "..." : str_val)
-                      << std::endl;
+            const std::string &str_cmd = recvCmds[recv_i];
+            const std::string &str_key = recvKeys[recv_i];
+            std::string &str_val = recvVals[recv_i];
 
-            delete recvBuf[recv_i];
+            LSMIO_TRACE2(ServerCommand, str_val.size(), recv_i);
+            _queueDepth.fetch_sub(1, std::memory_order_relaxed);
 
             if (str_cmd == _EOL_COMMAND) {
                 eolRanks[recv_i] = 1;
                 continue;
             }
 
+            if (useCredits) {
+                _owedBytes[recv_i] += _commandBytes(str_cmd, str_key, str_val);
+                _owedMsgs[recv_i]++;
+            }
+
             // callback time
             std::string retValue;
-            (lm->*func)(recv_i, str_cmd, str_key, &retValue, str_val);
+            (lm->*func)(recv_i, str_cmd, str_key, &retValue, std::move(str_val));
 
             if (str_cmd == KV_CMD::GET) {
-                sendCommand(recv_i, KV_CMD_RETURN::GET, str_key, retValue);
+                sendCommand(recv_i, KV_CMD_RETURN::GET, str_key, retValue, recvTags[recv_i]);
+            } else if (str_cmd == KV_CMD::GET_BATCH) {
+                sendCommand(recv_i, KV_CMD_RETURN::GET_BATCH, str_key, retValue,
+                            recvTags[recv_i]);
             } else if (str_cmd == KV_CMD::META_GET) {
-                sendCommand(recv_i, KV_CMD_RETURN::META_GET, str_key, retValue);
+                sendCommand(recv_i, KV_CMD_RETURN::META_GET, str_key, retValue, recvTags[recv_i]);
             } else if (str_cmd == KV_CMD::META_GET_ALL) {
-                sendCommand(recv_i, KV_CMD_RETURN::META_GET_ALL, str_key, retValue);
+                sendCommand(recv_i, KV_CMD_RETURN::META_GET_ALL, str_key, retValue,
+                            recvTags[recv_i]);
             } else if (str_cmd == KV_CMD::READ_BARRIER) {
-                sendCommand(recv_i, KV_CMD_RETURN::READ_BARRIER, str_key, retValue);
+                sendCommand(recv_i, KV_CMD_RETURN::READ_BARRIER, str_key, retValue,
+                            recvTags[recv_i]);
             } else if (str_cmd == KV_CMD::WRITE_BARRIER) {
-                sendCommand(recv_i, KV_CMD_RETURN::WRITE_BARRIER, str_key, retValue);
+                sendCommand(recv_i, KV_CMD_RETURN::WRITE_BARRIER, str_key, retValue,
+                            recvTags[recv_i]);
             }
         }
 
-        delete recvBuf;
-
-        LOG(INFO) << "LSMIOClient::_waitForCommand: Completed loop: " << loopCounter++ << std::endl;
+        if (useCredits) {
+            _grantCredits(func, lm, eolRanks);
+        }
     }
 
     _loopRunning = 0;
@@ -30,10 +30,25 @@
 
 #include <iostream>
 #include <lsmio/manager/client/client_adios.hpp>
+#include <lsmio/manager/trace.hpp>
 #include <thread>  // NOLINT [build/c++11]
 
 namespace lsmio {
 
+LSMIOSendRequestAdios::~LSMIOSendRequestAdios() {
+    wait();
+}
+
+bool LSMIOSendRequestAdios::test() {
+    wait();
+    return true;
+}
+
+void LSMIOSendRequestAdios::wait() {
+    for (auto &req : requests) req.Wait("LSMIOSendRequestAdios::wait");
+    requests.clear();
+}
+
 LSMIOClientAdios::LSMIOClientAdios(adios2::helper::Comm *comm) : LSMIOClient() {
     _comm = comm;
     _rank = (_comm) ? _comm->Rank() : 0;
@@ -47,71 +62,108 @@ void LSMIOClientAdios::_barrier() {
     _comm->Barrier("LSMIOClientAdios::_barrier");
 }
 
-char **LSMIOClientAdios::_recvToBuffer(int *bufSizes) {
-    const std::string hint = "LSMIOClientADIO::_recvToBuffer";
-    int recv_i, req_count;
+void LSMIOClientAdios::_postSizeRecvs(const std::vector<int> &ranks) {
+    const std::string hint = "LSMIOClientAdios::_postSizeRecvs";
+
+    for (int recv_i = 0; recv_i < _size; recv_i++) {
+        if (recv_i == _rank || !ranks[recv_i]) continue;
+        _recvSizeReqs[recv_i] = _comm->Irecv(&_recvSizes[recv_i], 1, recv_i, MPI_ANY_TAG, hint);
+    }
+}
+
+void LSMIOClientAdios::_recvCommands(const std::vector<int> &ready,
+                                     std::vector<std::string> *commands,
+                                     std::vector<std::string> *keys,
+                                     std::vector<std::string> *values, std::vector<int> *tags) {
+    const std::string hint = "LSMIOClientAdios::_recvCommands";
+
+    if (_recvBuffers.empty()) {
+        _recvSizes.assign(_size, 0);
+        _recvSizeReqs.resize(_size);
+        _recvBuffers.resize(_size);
+        _postSizeRecvs(std::vector<int>(_size, 1));
+    }
+
+    // a payload follows its size frame on the same tag
+    std::vector<adios2::helper::Comm::Req> reqs;
+    for (int recv_i = 0; recv_i < _size; recv_i++) {
+        if (!ready[recv_i]) continue;
 
-    char **buffer = new char *[_size];
-    for (recv_i = 0, req_count = 0; recv_i < _size; recv_i++) {
-        if (recv_i == _rank) continue;
+        adios2::helper::Comm::Status status = _recvSizeReqs[recv_i].Wait(hint);
+        (*tags)[recv_i] = status.Tag;
 
-        MPI_Status status;
-        int bSize = 0;
-        MPI_Probe(recv_i, MPI_ANY_TAG, adios2::helper::CommAsMPI(*_comm), &status);
-        MPI_Get_count(&status, MPI_CHAR, &bSize);
+        std::vector<char> &buffer = _recvBuffers[recv_i];
+        if (buffer.size() < _recvSizes[recv_i]) buffer.resize(_recvSizes[recv_i]);
 
-        LOG(INFO) << "LSMIOClientAdios::_recvToBuffer:"
-                  << " rank: " << recv_i << " Alloc cmd size: " << bSize << std::endl;
-        buffer[recv_i] = new char[bSize];
-        bufSizes[recv_i] = bSize;
-        _comm->Recv(buffer[recv_i], bSize, recv_i, 0, hint);
+        LSMIO_TRACE2(Recv, _recvSizes[recv_i], recv_i);
+        reqs.push_back(
+            _comm->Irecv(buffer.data(), _recvSizes[recv_i], recv_i, status.Tag, hint));
     }
 
-    return buffer;
+    for (auto &req : reqs) req.Wait(hint);
+
+    std::vector<int> next(_size, 0);
+    for (int recv_i = 0; recv_i < _size; recv_i++) {
+        if (!ready[recv_i]) continue;
+
+        deSerializeCmd(_recvBuffers[recv_i].data(), _recvSizes[recv_i], &(*commands)[recv_i],
+                       &(*keys)[recv_i], &(*values)[recv_i]);
+        next[recv_i] = ((*commands)[recv_i] != _EOL_COMMAND);
+    }
+
+    // the next commands of these ranks arrive while this round is being stored
+    _postSizeRecvs(next);
 }
 
 bool LSMIOClientAdios::sendCommand(int rank, const std::string &command, const std::string &key,
-                                   const std::string &value) {
-    const std::string hint = "LSMIOClientADIO::sendCommand";
+                                   const std::string &value, int tag) {
+    LSMIOSpan span("transport.send", value.size());
+    LSMIOSendRequest *req = isendCommand(rank, command, key, value, tag);
+    delete req;
+
+    LSMIO_TRACE2(Send, value.size(), rank);
+
+    return true;
+}
 
-    std::string bufMPI;
-    serializeCmd(&bufMPI, command, key, value);
+LSMIOSendRequest *LSMIOClientAdios::isendCommand(int rank, const std::string &command,
+                                                 const std::string &key,
+                                                 const std::string &value, int tag) {
+    LSMIOSpan span("transport.isend", value.size());
+    const std::string hint = "LSMIOClientAdios::isendCommand";
 
-    _comm->Send(bufMPI.c_str(), bufMPI.size(), rank, 0, hint);
+    LSMIOSendRequestAdios *req = new LSMIOSendRequestAdios();
+    serializeCmd(&req->buffer, command, key, value);
+    req->size = req->buffer.size();
 
-    LOG(INFO) << "LSMIOClientAdios::sendCommandMPI:"
-              << " myRank: " << _rank << " command : " << command << " key : " << key
-              << " size : " << value.size()
-              << " value : " << (value.size() > 80 ? value.substr(0, 80) + "..." : value)
-              << " to: " << rank << std::endl;
+    req->requests.push_back(_comm->Isend(&req->size, 1, rank, tag, hint));
+    req->requests.push_back(_comm->Isend(req->buffer.data(), req->size, rank, tag, hint));
 
-    return true;
+    return req;
 }
 
 bool LSMIOClientAdios::recvCommand(int rank, std::string *command, std::string *key,
-                                   std::string *value) {
-    const std::string hint = "LSMIOClientADIO::recvCommand";
+                                   std::string *value, int tag) {
+    LSMIOSpan span("transport.recv");
+    const std::string hint = "LSMIOClientAdios::recvCommand";
 
-    int sizeReceived[3];
-    _comm->Recv(sizeReceived, 3, rank, 0, hint);
+    size_t size = 0;
+    _comm->Recv(&size, 1, rank, tag, hint);
 
-    char cmdBuffer[sizeReceived[0]];
-    char keyBuffer[sizeReceived[1]];
-    char valBuffer[sizeReceived[2]];
+    if (_replyBuffer.size() < size) _replyBuffer.resize(size);
+    _comm->Recv(_replyBuffer.data(), size, rank, tag, hint);
 
-    _comm->Recv(cmdBuffer, sizeReceived[0], rank, 0, hint);
-    _comm->Recv(cmdBuffer, sizeReceived[1], rank, 0, hint);
-    _comm->Recv(cmdBuffer, sizeReceived[2], rank, 0, hint);
+    deSerializeCmd(_replyBuffer.data(), size, command, key, value);
 
-    command->assign(cmdBuffer, sizeReceived[0]);
-    key->assign(keyBuffer, sizeReceived[1]);
-    value->assign(valBuffer, sizeReceived[2]);
-
-    LOG(INFO) << "LSMIOClientAdios::recvCommandMPI:"
-              << " rank: " << rank << " command: " << *command << " key: " << *key
-              << " value: " << *value << std::endl;
+    LSMIO_TRACE2(Recv, size, rank);
 
     return true;
 }
 
+bool LSMIOClientAdios::probeCommand(int rank, int tag) {
+    int flag = 0;
+    MPI_Iprobe(rank, tag, adios2::helper::CommAsMPI(*_comm), &flag, MPI_STATUS_IGNORE);
+    return flag != 0;
+}
+
 }  // namespace lsmio
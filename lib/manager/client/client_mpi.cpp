@@ -28,9 +28,12 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
 #include <chrono>  // NOLINT [build/c++11]
+#include <climits>
 #include <iostream>
 #include <lsmio/manager/client/client_mpi.hpp>
+#include <lsmio/manager/trace.hpp>
 #include <thread>  // NOLINT [build/c++11]
 
 #define MPI_COMM_TO_STR(cLevel)                          \
@@ -43,6 +46,20 @@
 
 namespace lsmio {
 
+LSMIOSendRequestMPI::~LSMIOSendRequestMPI() {
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+}
+
+bool LSMIOSendRequestMPI::test() {
+    int flag = 0;
+    MPI_Testall(requests.size(), requests.data(), &flag, MPI_STATUSES_IGNORE);
+    return flag != 0;
+}
+
+void LSMIOSendRequestMPI::wait() {
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+}
+
 LSMIOClientMPI::LSMIOClientMPI(MPI_Comm &comm) : LSMIOClient() {
     _mpiComm = &comm;
     MPI_Comm_size(*_mpiComm, &_size);
@@ -60,70 +77,182 @@ void LSMIOClientMPI::_barrier() {
     MPI_Barrier(*_mpiComm);
 }
 
-char **LSMIOClientMPI::_recvToBuffer(int *bufSizes) {
-    MPI_Request reqs[_size - 1];
-    MPI_Status statuses[_size - 1];
-    int recv_i, req_count;
+size_t LSMIOClientMPI::_fragmentBytes() {
+    size_t fragment = (gConfigLSMIO.transferSize > 0) ? gConfigLSMIO.transferSize : INT_MAX;
+    return std::min<size_t>(fragment, INT_MAX);
+}
+
+void LSMIOClientMPI::_isendBuffer(const std::string &buf, std::string *header, int rank, int tag,
+                                  std::vector<MPI_Request> *reqs) {
+    const size_t fragment = _fragmentBytes();
+
+    if (buf.size() <= fragment) {
+        reqs->assign(1, MPI_REQUEST_NULL);
+        MPI_Isend(buf.data(), buf.size(), MPI_CHAR, rank, tag, *_mpiComm, &(*reqs)[0]);
+        return;
+    }
+
+    // "__FRAG;<total>;<fragment>" followed by the fragments in order on the same tag
+    *header = _FRAG_COMMAND + _COL_SEPARATOR_STR + std::to_string(buf.size()) +
+              _COL_SEPARATOR_STR + std::to_string(fragment);
+
+    size_t count = (buf.size() + fragment - 1) / fragment;
+    reqs->assign(count + 1, MPI_REQUEST_NULL);
+    MPI_Isend(header->data(), header->size(), MPI_CHAR, rank, tag, *_mpiComm, &(*reqs)[0]);
+
+    for (size_t i = 0; i < count; i++) {
+        size_t offset = i * fragment;
+        int len = static_cast<int>(std::min(fragment, buf.size() - offset));
+        MPI_Isend(buf.data() + offset, len, MPI_CHAR, rank, tag, *_mpiComm, &(*reqs)[i + 1]);
+    }
+
+    LSMIO_TRACE2(Send, buf.size(), rank);
+}
+
+char *LSMIOClientMPI::_irecvBuffer(int rank, int tag, int bSize, size_t *size,
+                                   std::vector<MPI_Request> *reqs) {
+    if (bSize > _FRAG_HEADER_MAX) {
+        char *buffer = new char[bSize];
+        *size = bSize;
+        reqs->push_back(MPI_REQUEST_NULL);
+        MPI_Irecv(buffer, bSize, MPI_CHAR, rank, tag, *_mpiComm, &reqs->back());
+        return buffer;
+    }
+
+    // small enough to be a fragment header: look at it before posting the receives
+    char *buffer = new char[bSize];
+    *size = bSize;
+    MPI_Recv(buffer, bSize, MPI_CHAR, rank, tag, *_mpiComm, MPI_STATUS_IGNORE);
+
+    std::string prefix = _FRAG_COMMAND + _COL_SEPARATOR_STR;
+    std::string message(buffer, bSize);
+    if (message.compare(0, prefix.size(), prefix) != 0) {
+        return buffer;
+    }
+    delete[] buffer;
+
+    size_t sep = message.find(_COL_SEPARATOR_CHAR, prefix.size());
+    size_t total = std::stoull(message.substr(prefix.size(), sep - prefix.size()));
+    size_t fragment = std::stoull(message.substr(sep + 1));
+
+    buffer = new char[total];
+    *size = total;
+    for (size_t offset = 0; offset < total; offset += fragment) {
+        int len = static_cast<int>(std::min(fragment, total - offset));
+        reqs->push_back(MPI_REQUEST_NULL);
+        MPI_Irecv(buffer + offset, len, MPI_CHAR, rank, tag, *_mpiComm, &reqs->back());
+    }
+
+    LSMIO_TRACE2(Recv, total, rank);
+
+    return buffer;
+}
+
+char **LSMIOClientMPI::_recvToBuffer(const std::vector<int> &ready, size_t *bufSizes, int *tags) {
+    std::vector<MPI_Request> reqs;
+    int recv_i;
 
     char **buffer = new char *[_size];
-    for (recv_i = 0, req_count = 0; recv_i < _size; recv_i++) {
-        if (recv_i == _rank) continue;
+    for (recv_i = 0; recv_i < _size; recv_i++) {
+        if (!ready[recv_i]) continue;
 
+        MPI_Status status;
         int bSize = 0;
-        MPI_Probe(recv_i, MPI_ANY_TAG, *_mpiComm, &statuses[req_count]);
-        MPI_Get_count(&statuses[req_count], MPI_CHAR, &bSize);
-
-        LOG(INFO) << "LSMIOClientMPI::_recvToBuffer:"
-                  << " rank: " << recv_i << " alloc size: " << bSize << std::endl;
+        MPI_Probe(recv_i, MPI_ANY_TAG, *_mpiComm, &status);
+        MPI_Get_count(&status, MPI_CHAR, &bSize);
 
-        buffer[recv_i] = new char[bSize];
-        bufSizes[recv_i] = bSize;
-        MPI_Irecv(buffer[recv_i], bSize, MPI_CHAR, recv_i, 0, *_mpiComm, &reqs[req_count++]);
+        tags[recv_i] = status.MPI_TAG;
+        buffer[recv_i] = _irecvBuffer(recv_i, tags[recv_i], bSize, &bufSizes[recv_i], &reqs);
     }
 
-    LOG(INFO) << "LSMIOClientMPI::_recvToBuffer: Waiting for buffers for ALL." << std::endl;
-    MPI_Waitall(req_count, reqs, statuses);
+    MPI_Waitall(reqs.size(), reqs.data(), MPI_STATUSES_IGNORE);
 
     return buffer;
 }
 
-bool LSMIOClientMPI::sendCommand(int rank, const std::string &command, const std::string &key,
-                                 const std::string &value) {
-    MPI_Request reqs[4];
-    MPI_Status statuses[4];
+bool LSMIOClientMPI::_creditsEnabled() const {
+    return gConfigLSMIO.creditBytes > 0 || gConfigLSMIO.creditMessages > 0;
+}
+
+void LSMIOClientMPI::_sendCredits(int rank, int64_t bytes, int64_t msgs) {
+    int64_t credits[2] = {bytes, msgs};
+    MPI_Send(credits, 2, MPI_INT64_T, rank, KV_TAG_CREDIT, *_mpiComm);
+}
+
+bool LSMIOClientMPI::_recvCredits(int rank, bool block, int64_t *bytes, int64_t *msgs) {
+    if (!block) {
+        int flag = 0;
+        MPI_Iprobe(rank, KV_TAG_CREDIT, *_mpiComm, &flag, MPI_STATUS_IGNORE);
+        if (!flag) return false;
+    }
+
+    int64_t credits[2];
+    MPI_Recv(credits, 2, MPI_INT64_T, rank, KV_TAG_CREDIT, *_mpiComm, MPI_STATUS_IGNORE);
+    *bytes = credits[0];
+    *msgs = credits[1];
+    return true;
+}
+
+bool LSMIOClientMPI::_hasPendingCommand(int rank) {
+    int flag = 0;
+    MPI_Iprobe(rank, MPI_ANY_TAG, *_mpiComm, &flag, MPI_STATUS_IGNORE);
+    return flag != 0;
+}
 
+bool LSMIOClientMPI::sendCommand(int rank, const std::string &command, const std::string &key,
+                                 const std::string &value, int tag) {
+    LSMIOSpan span("transport.send", value.size());
     std::string bufMPI;
     serializeCmd(&bufMPI, command, key, value);
-    MPI_Send(bufMPI.c_str(), bufMPI.size(), MPI_CHAR, rank, 0, *_mpiComm);
+    _acquireCredits(rank, bufMPI.size());
 
-    LOG(INFO) << "LSMIOClientMPI::sendCommandMPI:"
-              << " my rank: " << _rank << " command : " << command << " key : " << key
-              << " size : " << value.size()
-              << " value : " << (value.size() > 80 ? value.substr(0, 80) + "..." : value)
-              << " to: " << rank << std::endl;
+    std::string header;
+    std::vector<MPI_Request> reqs;
+    _isendBuffer(bufMPI, &header, rank, tag, &reqs);
+    MPI_Waitall(reqs.size(), reqs.data(), MPI_STATUSES_IGNORE);
 
     return true;
 }
 
+LSMIOSendRequest *LSMIOClientMPI::isendCommand(int rank, const std::string &command,
+                                               const std::string &key, const std::string &value,
+                                               int tag) {
+    LSMIOSpan span("transport.isend", value.size());
+    LSMIOSendRequestMPI *req = new LSMIOSendRequestMPI();
+    serializeCmd(&req->buffer, command, key, value);
+    _acquireCredits(rank, req->buffer.size());
+    _isendBuffer(req->buffer, &req->header, rank, tag, &req->requests);
+
+    return req;
+}
+
 bool LSMIOClientMPI::recvCommand(int rank, std::string *command, std::string *key,
-                                 std::string *value) {
+                                 std::string *value, int tag) {
+    LSMIOSpan span("transport.recv");
     MPI_Status status;
 
     int bSize = 0;
-    MPI_Probe(rank, MPI_ANY_TAG, *_mpiComm, &status);
+    MPI_Probe(rank, tag, *_mpiComm, &status);
     MPI_Get_count(&status, MPI_CHAR, &bSize);
 
-    char *bufReceived = new char[bSize];
-    MPI_Recv(bufReceived, bSize, MPI_CHAR, rank, 0, *_mpiComm, &status);
+    size_t size = 0;
+    std::vector<MPI_Request> reqs;
+    char *bufReceived = _irecvBuffer(rank, tag, bSize, &size, &reqs);
+    MPI_Waitall(reqs.size(), reqs.data(), MPI_STATUSES_IGNORE);
+
+    deSerializeCmd(bufReceived, size, command, key, value);
+    delete[] bufReceived;
 
-    deSerializeCmd(bufReceived, bSize, command, key, value);
+    return true;
+}
 
-    LOG(INFO) << "LSMIOClientMPI::recvCommandMPI:"
-              << " rank: " << rank << " command: " << *command << " key: " << *key
-              << " size: " << value->size()
-              << " value: " << (value->size() > 80 ? (*value).substr(0, 80) + "..." : *value)
-              << std::endl;
+bool LSMIOClientMPI::probeCommand(int rank, int tag) {
+    int flag = 0;
+    MPI_Iprobe(rank, tag, *_mpiComm, &flag, MPI_STATUS_IGNORE);
+    return flag != 0;
+}
 
+bool LSMIOClientMPI::allowsUnevenCommands() const {
     return true;
 }
 
@@ -0,0 +1,266 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <lsmio/manager/client/client_shm.hpp>
+#include <lsmio/manager/trace.hpp>
+#include <new>
+#include <thread>  // NOLINT [build/c++11]
+
+namespace lsmio {
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared-memory rings require lock-free 64-bit atomics");
+
+ShmRing::ShmRing(void *base, uint64_t capacity) {
+    _header = static_cast<ShmRingHeader *>(base);
+    _data = static_cast<char *>(base) + sizeof(ShmRingHeader);
+    _capacity = capacity;
+}
+
+void ShmRing::reset() {
+    new (_header) ShmRingHeader();
+    _header->head.store(0, std::memory_order_relaxed);
+    _header->tail.store(0, std::memory_order_release);
+}
+
+void ShmRing::write(const void *buf, uint64_t len) {
+    const char *src = static_cast<const char *>(buf);
+    uint64_t tail = _header->tail.load(std::memory_order_relaxed);
+
+    while (len > 0) {
+        uint64_t free = _capacity - (tail - _header->head.load(std::memory_order_acquire));
+        if (free == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        uint64_t offset = tail % _capacity;
+        uint64_t chunk = std::min({len, free, _capacity - offset});
+        std::memcpy(_data + offset, src, chunk);
+
+        tail += chunk;
+        src += chunk;
+        len -= chunk;
+        _header->tail.store(tail, std::memory_order_release);
+    }
+}
+
+void ShmRing::read(void *buf, uint64_t len) {
+    char *dst = static_cast<char *>(buf);
+    uint64_t head = _header->head.load(std::memory_order_relaxed);
+
+    while (len > 0) {
+        uint64_t avail = _header->tail.load(std::memory_order_acquire) - head;
+        if (avail == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        uint64_t offset = head % _capacity;
+        uint64_t chunk = std::min({len, avail, _capacity - offset});
+        std::memcpy(dst, _data + offset, chunk);
+
+        head += chunk;
+        dst += chunk;
+        len -= chunk;
+        _header->head.store(head, std::memory_order_release);
+    }
+}
+
+uint64_t ShmRing::available() const {
+    return _header->tail.load(std::memory_order_acquire) -
+           _header->head.load(std::memory_order_relaxed);
+}
+
+uint64_t ShmRing::footprint(uint64_t capacity) {
+    return sizeof(ShmRingHeader) + capacity;
+}
+
+LSMIOClientSHM::LSMIOClientSHM(MPI_Comm &comm, uint64_t ringSize, int aggRank) : LSMIOClient() {
+    _mpiComm = &comm;
+    _aggRank = aggRank;
+    MPI_Comm_size(*_mpiComm, &_size);
+    MPI_Comm_rank(*_mpiComm, &_rank);
+
+    // keep every ring header on its own cache lines
+    _ringSize = std::max<uint64_t>(64, (ringSize + 63) & ~static_cast<uint64_t>(63));
+    const uint64_t pairBytes = 2 * ShmRing::footprint(_ringSize);
+
+    MPI_Info info;
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "alloc_shared_noncontig", "true");
+
+    void *base = nullptr;
+    MPI_Aint localBytes = (_rank == _aggRank) ? 0 : static_cast<MPI_Aint>(pairBytes);
+    MPI_Win_allocate_shared(localBytes, 1, info, *_mpiComm, &base, &_win);
+    MPI_Info_free(&info);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, _win);
+
+    _reqRings.resize(_size);
+    _repRings.resize(_size);
+    for (int rank = 0; rank < _size; rank++) {
+        if (rank == _aggRank) continue;
+        if (_rank != _aggRank && rank != _rank) continue;
+
+        MPI_Aint segBytes = 0;
+        int dispUnit = 0;
+        char *segment = nullptr;
+        MPI_Win_shared_query(_win, rank, &segBytes, &dispUnit, &segment);
+
+        _reqRings[rank] = ShmRing(segment, _ringSize);
+        _repRings[rank] = ShmRing(segment + ShmRing::footprint(_ringSize), _ringSize);
+    }
+
+    if (_rank != _aggRank) {
+        _reqRings[_rank].reset();
+        _repRings[_rank].reset();
+    }
+
+    MPI_Win_sync(_win);
+    MPI_Barrier(*_mpiComm);
+
+    LOG(INFO) << "LSMIOClientSHM::LSMIOClientSHM(): "
+              << " rank/size: " << _rank << "/" << _size << " ring size: " << _ringSize
+              << std::endl;
+}
+
+LSMIOClientSHM::~LSMIOClientSHM() {
+    if (_win != MPI_WIN_NULL) {
+        MPI_Win_unlock_all(_win);
+        MPI_Win_free(&_win);
+    }
+}
+
+ShmRing &LSMIOClientSHM::_outRing(int rank) {
+    return (_rank == _aggRank) ? _repRings[rank] : _reqRings[_rank];
+}
+
+ShmRing &LSMIOClientSHM::_inRing(int rank) {
+    return (_rank == _aggRank) ? _reqRings[rank] : _repRings[_rank];
+}
+
+void LSMIOClientSHM::_barrier() {
+    MPI_Barrier(*_mpiComm);
+}
+
+void LSMIOClientSHM::_readRecord(ShmRing &ring, int *tag, std::string *command, std::string *key,
+                                 std::string *value) {
+    RecordHeader header;
+    ring.read(&header, sizeof(header));
+    *tag = header.tag;
+
+    command->resize(header.cmdLen);
+    ring.read(command->data(), header.cmdLen);
+    key->resize(header.keyLen);
+    ring.read(key->data(), header.keyLen);
+    value->resize(header.valLen);
+    ring.read(value->data(), header.valLen);
+}
+
+void LSMIOClientSHM::_recvCommands(const std::vector<int> &ready,
+                                   std::vector<std::string> *commands,
+                                   std::vector<std::string> *keys,
+                                   std::vector<std::string> *values, std::vector<int> *tags) {
+    for (int recv_i = 0; recv_i < _size; recv_i++) {
+        if (!ready[recv_i]) continue;
+        _readRecord(_inRing(recv_i), &(*tags)[recv_i], &(*commands)[recv_i], &(*keys)[recv_i],
+                    &(*values)[recv_i]);
+    }
+}
+
+bool LSMIOClientSHM::_hasPendingCommand(int rank) {
+    return _inRing(rank).available() > 0;
+}
+
+bool LSMIOClientSHM::sendCommand(int rank, const std::string &command, const std::string &key,
+                                 const std::string &value, int tag) {
+    LSMIOSpan span("transport.send", value.size());
+    RecordHeader header = {static_cast<uint32_t>(command.size()),
+                           static_cast<uint32_t>(key.size()), value.size(), tag};
+
+    ShmRing &ring = _outRing(rank);
+    ring.write(&header, sizeof(header));
+    ring.write(command.data(), header.cmdLen);
+    ring.write(key.data(), header.keyLen);
+    ring.write(value.data(), header.valLen);
+
+    LSMIO_TRACE2(Send, value.size(), rank);
+
+    return true;
+}
+
+bool LSMIOClientSHM::recvCommand(int rank, std::string *command, std::string *key,
+                                 std::string *value, int tag) {
+    LSMIOSpan span("transport.recv");
+    auto it = _stash.find(tag);
+    if (it != _stash.end()) {
+        std::tie(*command, *key, *value) = std::move(it->second);
+        _stash.erase(it);
+        return true;
+    }
+
+    // replies arrive in request order; keep the ones belonging to other requests
+    ShmRing &ring = _inRing(rank);
+    while (true) {
+        int recvTag;
+        _readRecord(ring, &recvTag, command, key, value);
+        if (recvTag == tag) break;
+        _stash[recvTag] = std::make_tuple(std::move(*command), std::move(*key), std::move(*value));
+    }
+
+    LSMIO_TRACE2(Recv, value->size(), rank);
+
+    return true;
+}
+
+bool LSMIOClientSHM::probeCommand(int rank, int tag) {
+    if (_stash.count(tag)) return true;
+
+    // a started record is always completed by its producer, so reading it cannot stall
+    ShmRing &ring = _inRing(rank);
+    while (ring.available() > 0) {
+        int recvTag;
+        std::string command, key, value;
+        _readRecord(ring, &recvTag, &command, &key, &value);
+        _stash[recvTag] = std::make_tuple(std::move(command), std::move(key), std::move(value));
+        if (recvTag == tag) return true;
+    }
+
+    return false;
+}
+
+bool LSMIOClientSHM::allowsUnevenCommands() const {
+    return true;
+}
+
+}  // namespace lsmio
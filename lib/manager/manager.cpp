@@ -28,11 +28,16 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <iostream>
+#include <iterator>
 #include <lsmio/manager/client/client_adios.hpp>
 #include <lsmio/manager/client/client_mpi.hpp>
+#include <lsmio/manager/client/client_shm.hpp>
 #include <lsmio/manager/manager.hpp>
+#include <lsmio/manager/trace.hpp>
 #include <sstream>
 #include <string>
 #include <tuple>
@@ -45,6 +50,10 @@ std::atomic<int> LSMIOManager::_lmInitialized = 0;
 std::atomic<int> LSMIOManager::_lmInitializing = 0;
 std::atomic<int> LSMIOManager::_lmCleaning = 0;
 
+/// Read cache namespaces for metadata and data keys.
+static const std::string READ_CACHE_META = "m:";
+static const std::string READ_CACHE_DATA = "d:";
+
 
 void vectorTupleSerialize(const std::vector<std::tuple<std::string, std::string>>& values,
                           std::string& value) {
@@ -74,6 +83,43 @@ void vectorTupleDeserialize(const std::string& serialized_data,
     }
 }
 
+void tupleSerializeBinary(const std::string& first, const std::string& second,
+                          std::string& value) {
+    uint32_t firstLen = first.length();
+    uint32_t secondLen = second.length();
+    value.append(reinterpret_cast<const char*>(&firstLen), sizeof(firstLen));
+    value.append(first);
+    value.append(reinterpret_cast<const char*>(&secondLen), sizeof(secondLen));
+    value.append(second);
+}
+
+void vectorTupleSerializeBinary(const std::vector<std::tuple<std::string, std::string>>& values,
+                                std::string& value) {
+    for (const auto& [first, second] : values) {
+        tupleSerializeBinary(first, second, value);
+    }
+}
+
+void vectorTupleDeserializeBinary(const std::string& serialized_data,
+                                  std::vector<std::tuple<std::string, std::string>>& values) {
+    size_t pos = 0;
+    uint32_t len[2];
+
+    while (pos < serialized_data.length()) {
+        std::string parts[2];
+        for (int i = 0; i < 2; i++) {
+            if (pos + sizeof(len[i]) > serialized_data.length()) return;
+            std::memcpy(&len[i], serialized_data.data() + pos, sizeof(len[i]));
+            pos += sizeof(len[i]);
+
+            if (pos + len[i] > serialized_data.length()) return;
+            parts[i].assign(serialized_data, pos, len[i]);
+            pos += len[i];
+        }
+        values.emplace_back(std::move(parts[0]), std::move(parts[1]));
+    }
+}
+
 LSMIOManager::LSMIOManager(const std::string& dbName, const std::string& dbDir,
                            const bool overWrite, MPI_Comm mpiComm) {
     _dbName = dbName;
@@ -119,13 +165,15 @@ void LSMIOManager::_init() {
             LOG(INFO) << "LSMIOManager::_init: MPI comm world is greater than 1." << std::endl;
             _isShared = true;
 
-            if (gConfigLSMIO.mpiAggType == MPIAggType::Shared) {
+            if (gConfigLSMIO.mpiAggType == MPIAggType::Shared ||
+                gConfigLSMIO.mpiAggType == MPIAggType::Hierarchical) {
                 _isSharedSplit = true;
-                MPI_Comm_split_type(_mpiComm, MPI_COMM_TYPE_SHARED, AGGREGATION_RANK, MPI_INFO_NULL,
-                                    &_aggComm);
+                _splitNodeComm();
             } else if (gConfigLSMIO.mpiAggType == MPIAggType::Split) {
                 _isSharedSplit = true;
-                int splitSize = _worldRank / 2;
+                int ratio = (gConfigLSMIO.ranksPerAggregator > 0) ? gConfigLSMIO.ranksPerAggregator
+                                                                  : 2;
+                int splitSize = _worldRank / ratio;
                 MPI_Comm_split(_mpiComm, splitSize, _worldRank, &_aggComm);
             } else {
                 // gConfigLSMIO.mpiAggType == MPIAggType::Entire or MPIAggType::EntireSerial
@@ -134,6 +182,11 @@ void LSMIOManager::_init() {
 
             MPI_Comm_rank(_aggComm, &_aggRank);
             MPI_Comm_size(_aggComm, &_aggSize);
+
+            if (gConfigLSMIO.mpiAggType == MPIAggType::Hierarchical) {
+                int color = (_aggRank == AGGREGATION_RANK) ? 0 : MPI_UNDEFINED;
+                MPI_Comm_split(_mpiComm, color, _worldRank, &_globalComm);
+            }
         }
     }
 
@@ -142,7 +195,15 @@ void LSMIOManager::_init() {
               << ", mpiAggType=" << (int)gConfigLSMIO.mpiAggType
               << ", _dbPath=" << (_dbDir.empty() ? _dbName : _dbDir + "/" + _dbName);
 
-    if (_isShared && _isSharedSplit && !gConfigLSMIO.disableAggDirStructure) {
+    _rootDir = _dbDir;
+
+    if (!gConfigLSMIO.traceDir.empty()) {
+        LSMIOTrace::enableSpans(_worldRank);
+        _isTracing = true;
+    }
+
+    if (_isShared && _isSharedSplit && !gConfigLSMIO.disableAggDirStructure &&
+        gConfigLSMIO.mpiAggType != MPIAggType::Hierarchical) {
         std::filesystem::path pathDBDir(_dbDir);
         pathDBDir /= AGGREGATION_DIR_INFIX;
         pathDBDir /= std::to_string(_worldRank);
@@ -156,30 +217,41 @@ void LSMIOManager::_init() {
 
     // Startup: RDB first and MPI afterwards to ensure DB available before MPI messages are received
     if (_isOpenLocal()) {
-        switch (gConfigLSMIO.storageType) {
-            case StorageType::NativeDB:
-                LOG(INFO) << "LSMIOManager::_init: setting up Native backend." << std::endl;
-                _lcStore = new LSMIOStoreNative(_dbPath, _isOverWrite);
-                break;
-            case StorageType::RocksDB:
-                LOG(INFO) << "LSMIOManager::_init: setting up RocksDB backend." << std::endl;
-                _lcStore = new LSMIOStoreRDB(_dbPath, _isOverWrite);
-                break;
-            case StorageType::LevelDB:
-                LOG(INFO) << "LSMIOManager::_init: setting up LevelDB backend." << std::endl;
-                _lcStore = new LSMIOStoreLDB(_dbPath, _isOverWrite);
-                break;
+        if (_globalComm != MPI_COMM_NULL) {
+            _lcStore = _openForwardStore();
+        } else {
+            _lcStore = _openStore(_dbPath);
         }
+        _lcStore->setStats(&_stats);
+    }
+
+    if (gConfigLSMIO.writeRestartIndex) {
+        _openRestartIndex();
     }
 
     if (_isOpenRemote() || _isServeLocal()) {
-        _lcMPI = new LSMIOClientMPI(_aggComm);
+        if (gConfigLSMIO.clientTransport == ClientTransport::SharedMemory &&
+            gConfigLSMIO.mpiAggType == MPIAggType::Shared) {
+            LOG(INFO) << "LSMIOManager::_init: using shared-memory transport." << std::endl;
+            _lcMPI = new LSMIOClientSHM(_aggComm, gConfigLSMIO.shmRingSize, AGGREGATION_RANK);
+        } else if (gConfigLSMIO.clientTransport == ClientTransport::Adios) {
+            LOG(INFO) << "LSMIOManager::_init: using Adios transport." << std::endl;
+            _aggAdiosComm = new adios2::helper::Comm(adios2::helper::CommDupMPI(_aggComm));
+            _lcMPI = new LSMIOClientAdios(_aggAdiosComm);
+        } else {
+            _lcMPI = new LSMIOClientMPI(_aggComm);
+        }
 
         if (_isServeLocal()) {
             _lcMPI->checkThreadSupport();
         }
     }
 
+    // a cache hit skips the round trip, which only transports serving uneven clients allow
+    if (_isOpenRemote() && gConfigLSMIO.readCacheBytes > 0 && _lcMPI->allowsUnevenCommands()) {
+        _readCache = new LSMIOReadCache(gConfigLSMIO.readCacheBytes);
+    }
+
     if (_isServeLocal()) {
         LOG(INFO) << "LSMIOManager::_init: starting collective I/O server." << std::endl;
         _lcMPI->startCollectiveIOServer(&LSMIOManager::callbackForCollectiveIO, this);
@@ -188,17 +260,303 @@ void LSMIOManager::_init() {
         _lcMPI->startCollectiveIOClient();
     }
 
+    if (!gConfigLSMIO.metricsDir.empty()) {
+        _openMetrics();
+    }
+
     LOG(INFO) << "LSMIOManager::_init: rank: " << _aggRank << std::endl;
 }
 
+LSMIOStore* LSMIOManager::_openBackend(const std::string& dbPath) {
+    LSMIOStore* store = nullptr;
+
+    switch (gConfigLSMIO.storageType) {
+        case StorageType::NativeDB:
+            LOG(INFO) << "LSMIOManager::_openBackend: setting up Native backend." << std::endl;
+            store = new LSMIOStoreNative(dbPath, _isOverWrite);
+            break;
+        case StorageType::RocksDB:
+            LOG(INFO) << "LSMIOManager::_openBackend: setting up RocksDB backend." << std::endl;
+            store = new LSMIOStoreRDB(dbPath, _isOverWrite);
+            break;
+        case StorageType::LevelDB:
+            LOG(INFO) << "LSMIOManager::_openBackend: setting up LevelDB backend." << std::endl;
+            store = new LSMIOStoreLDB(dbPath, _isOverWrite);
+            break;
+    }
+
+    return store;
+}
+
+LSMIOStore* LSMIOManager::_openStore(const std::string& dbPath) {
+    if (gConfigLSMIO.storeShards <= 1) {
+        return _openBackend(dbPath);
+    }
+
+    std::vector<LSMIOStore*> shards;
+    for (int i = 0; i < gConfigLSMIO.storeShards; i++) {
+        shards.push_back(_openBackend(dbPath + "." + std::to_string(i)));
+    }
+
+    return new LSMIOStoreSharded(dbPath, shards, gConfigLSMIO.shardByRank);
+}
+
+LSMIOStore* LSMIOManager::_openForwardStore() {
+    int globalRank, globalSize;
+    MPI_Comm_rank(_globalComm, &globalRank);
+    MPI_Comm_size(_globalComm, &globalSize);
+
+    int writers = std::max(1, std::min(gConfigLSMIO.globalWriters, globalSize));
+    LSMIOStore* partition = nullptr;
+
+    if (globalRank < writers) {
+        std::filesystem::path pathDBDir(_dbDir);
+        pathDBDir /= GLOBAL_DIR_INFIX;
+        pathDBDir /= std::to_string(globalRank);
+        std::filesystem::create_directories(pathDBDir);
+
+        LOG(INFO) << "LSMIOManager::_openForwardStore: global writer: " << globalRank << "/"
+                  << writers << std::endl;
+        partition = _openStore((pathDBDir / _dbName).string());
+    }
+
+    return new LSMIOStoreForward(_dbPath, _globalComm, writers, partition);
+}
+
+void LSMIOManager::_openRestartIndex() {
+    std::string indexDir = restartIndexDir(_dbName, _rootDir);
+    std::string indexFile = indexDir + "/" + std::to_string(_worldRank) + ".idx";
+
+    // collective: stale indices of an earlier run with other aggregators go before any is saved
+    if (_isOverWrite) {
+        if (_worldRank == 0) std::filesystem::remove_all(indexDir);
+        if (_isShared) MPI_Barrier(_mpiComm);
+    }
+
+    // the aggregator learns the world ranks it serves
+    _aggWorldRanks.assign(_aggSize, _worldRank);
+    if (_isShared) {
+        MPI_Gather(&_worldRank, 1, MPI_INT, _aggWorldRanks.data(), 1, MPI_INT, AGGREGATION_RANK,
+                   _aggComm);
+    }
+
+    if (!_isOpenLocal()) {
+        return;
+    }
+
+    if (_globalComm != MPI_COMM_NULL) {
+        LOG(WARNING) << "LSMIOManager::_openRestartIndex: hierarchical stores are not indexed."
+                     << std::endl;
+        return;
+    }
+
+    std::string storePath = _dbPath;
+    if (!_rootDir.empty()) {
+        storePath = std::filesystem::path(_dbPath).lexically_relative(_rootDir).string();
+    }
+
+    _restartIndex = new LSMIORestartIndex(storePath, gConfigLSMIO.storageType,
+                                          std::max(1, gConfigLSMIO.storeShards),
+                                          gConfigLSMIO.shardByRank);
+
+    if (!_isOverWrite && std::filesystem::exists(indexFile)) {
+        _restartIndex->load(indexFile);
+    }
+}
+
+void LSMIOManager::_indexMutation(int rank, const std::string& key, bool meta, bool del) {
+    if (!_restartIndex) return;
+
+    std::string storeKey = _rankedKey(rank, key);
+    if (meta) storeKey = _lcStore->metaPrefix() + storeKey;
+
+    if (del) {
+        _restartIndex->remove(storeKey);
+    } else {
+        _restartIndex->add(storeKey, _aggWorldRanks[rank], meta, key);
+    }
+}
+
+void LSMIOManager::_saveRestartIndex() {
+    std::string indexDir = restartIndexDir(_dbName, _rootDir);
+    std::filesystem::create_directories(indexDir);
+
+    std::string indexFile = indexDir + "/" + std::to_string(_worldRank) + ".idx";
+    if (!_restartIndex->save(indexFile)) {
+        LOG(ERROR) << "LSMIOManager::_saveRestartIndex: failed: " << indexFile << std::endl;
+        return;
+    }
+
+    // the full index supersedes the updates published while writing
+    std::error_code ec;
+    for (size_t i = 0; i < _restartIndexUpdates; i++) {
+        std::filesystem::remove(
+            indexDir + "/" + std::to_string(_worldRank) + "." + std::to_string(i) + ".idx", ec);
+    }
+}
+
+bool LSMIOManager::allowsUnevenCommands() const {
+    return !_lcMPI || _lcMPI->allowsUnevenCommands();
+}
+
+bool LSMIOManager::publishRestartIndex() {
+    if (!_restartIndex) return true;
+
+    std::string indexDir = restartIndexDir(_dbName, _rootDir);
+    std::filesystem::create_directories(indexDir);
+
+    std::string updateFile = indexDir + "/" + std::to_string(_worldRank) + "." +
+                             std::to_string(_restartIndexUpdates++) + ".idx";
+    bool success = _restartIndex->saveNew(updateFile);
+    if (!success) {
+        LOG(ERROR) << "LSMIOManager::publishRestartIndex: failed: " << updateFile << std::endl;
+    }
+
+    return success;
+}
+
+void LSMIOManager::_splitNodeComm() {
+    MPI_Comm nodeComm = MPI_COMM_NULL;
+    MPI_Info info = MPI_INFO_NULL;
+    int splitType = MPI_COMM_TYPE_SHARED;
+
+    if (gConfigLSMIO.emulatedNodes > 0) {
+        // contiguous blocks of ranks stand in for nodes when testing on one machine
+        int64_t node = static_cast<int64_t>(_worldRank) * gConfigLSMIO.emulatedNodes / _worldSize;
+        MPI_Comm_split(_mpiComm, static_cast<int>(node), _worldRank, &nodeComm);
+    } else if (gConfigLSMIO.numaAwareAggregation) {
+#if defined(OPEN_MPI)
+        splitType = OMPI_COMM_TYPE_NUMA;
+#elif MPI_VERSION >= 4
+        splitType = MPI_COMM_TYPE_HW_GUIDED;
+        MPI_Info_create(&info);
+        MPI_Info_set(info, "mpi_hw_resource_type", "NUMANode");
+#else
+        LOG(WARNING) << "LSMIOManager::_splitNodeComm: NUMA-aware aggregation is not supported "
+                     << "by this MPI library, grouping by node." << std::endl;
+#endif
+    }
+
+    if (gConfigLSMIO.emulatedNodes <= 0) {
+        MPI_Comm_split_type(_mpiComm, splitType, AGGREGATION_RANK, info, &nodeComm);
+        if (info != MPI_INFO_NULL) MPI_Info_free(&info);
+
+        if (splitType != MPI_COMM_TYPE_SHARED) {
+            // a rank may land outside every NUMA group; if any does, all ranks must fall back
+            // together since the second split is collective over _mpiComm
+            int localNull = nodeComm == MPI_COMM_NULL ? 1 : 0;
+            int anyNull = 0;
+            MPI_Allreduce(&localNull, &anyNull, 1, MPI_INT, MPI_MAX, _mpiComm);
+
+            if (anyNull) {
+                if (nodeComm != MPI_COMM_NULL) MPI_Comm_free(&nodeComm);
+                MPI_Comm_split_type(_mpiComm, MPI_COMM_TYPE_SHARED, AGGREGATION_RANK,
+                                    MPI_INFO_NULL, &nodeComm);
+            }
+        }
+    }
+
+    int nodeRank, nodeSize;
+    MPI_Comm_rank(nodeComm, &nodeRank);
+    MPI_Comm_size(nodeComm, &nodeSize);
+
+    int ratio = gConfigLSMIO.ranksPerAggregator;
+    if (gConfigLSMIO.aggregatorsPerNode > 0) {
+        ratio = (nodeSize + gConfigLSMIO.aggregatorsPerNode - 1) / gConfigLSMIO.aggregatorsPerNode;
+    }
+
+    LOG(INFO) << "LSMIOManager::_splitNodeComm: node rank/size: " << nodeRank << "/" << nodeSize
+              << " ranks per aggregator: " << ratio << std::endl;
+
+    if (ratio <= 0 || ratio >= nodeSize) {
+        _aggComm = nodeComm;
+        return;
+    }
+
+    MPI_Comm_split(nodeComm, nodeRank / ratio, nodeRank, &_aggComm);
+    MPI_Comm_free(&nodeComm);
+}
+
+void LSMIOManager::_openMetrics() {
+    std::error_code ec;
+    std::filesystem::path metricsPath(gConfigLSMIO.metricsDir);
+    std::filesystem::create_directories(metricsPath, ec);
+    metricsPath /= "lsmio_" + _dbName + "_" + std::to_string(_worldRank) + ".prom";
+
+    _metricsTime = std::chrono::steady_clock::now();
+    _metricsWriteBytes = _metricsReadBytes = 0;
+    _metrics = new LSMIOMetricsExporter(metricsPath.string(), gConfigLSMIO.metricsIntervalMs,
+                                        [this](std::ostream& os) { _writeMetrics(os); });
+}
+
+void LSMIOManager::_writeMetrics(std::ostream& os) {
+    using Exporter = LSMIOMetricsExporter;
+
+    LSMIOStatsSnapshot snap = _stats.snapshot();
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - _metricsTime).count();
+
+    // counters may have been reset since the previous sample
+    uint64_t written = snap.writeBytes - std::min(_metricsWriteBytes, snap.writeBytes);
+    uint64_t read = snap.readBytes - std::min(_metricsReadBytes, snap.readBytes);
+    double writeRate = seconds > 0 ? written / seconds : 0.0;
+    double readRate = seconds > 0 ? read / seconds : 0.0;
+    _metricsTime = now;
+    _metricsWriteBytes = snap.writeBytes;
+    _metricsReadBytes = snap.readBytes;
+
+    LSMIOStoreGauges gauges;
+    if (_lcStore) _lcStore->addGauges(&gauges);
+    uint64_t queueDepth = (_isServeLocal() && _lcMPI) ? _lcMPI->queueDepth() : 0;
+
+    std::string labels = "rank=" + Exporter::labelValue(std::to_string(_worldRank)) +
+                         ",db=" + Exporter::labelValue(_dbName);
+
+    Exporter::writeMetric(os, "lsmio_write_bytes_total", "counter",
+                          "Bytes written through the manager.", labels, snap.writeBytes);
+    Exporter::writeMetric(os, "lsmio_read_bytes_total", "counter",
+                          "Bytes read through the manager.", labels, snap.readBytes);
+    Exporter::writeMetric(os, "lsmio_write_ops_total", "counter",
+                          "Write operations through the manager.", labels, snap.writeOps);
+    Exporter::writeMetric(os, "lsmio_read_ops_total", "counter",
+                          "Read operations through the manager.", labels, snap.readOps);
+    Exporter::writeMetric(os, "lsmio_write_throughput_bytes_per_second", "gauge",
+                          "Write throughput since the previous sample.", labels, writeRate);
+    Exporter::writeMetric(os, "lsmio_read_throughput_bytes_per_second", "gauge",
+                          "Read throughput since the previous sample.", labels, readRate);
+    Exporter::writeMetric(os, "lsmio_stall_seconds_total", "counter",
+                          "Time writes waited for memtable flushes.", labels,
+                          snap[StatOp::Stall].totalNs / 1e9);
+    Exporter::writeMetric(os, "lsmio_memtable_bytes", "gauge",
+                          "Bytes in the active memtables of the local store.", labels,
+                          gauges.memtableBytes);
+    Exporter::writeMetric(os, "lsmio_immutable_memtables", "gauge",
+                          "Memtables queued for flushing in the local store.", labels,
+                          gauges.immutableMemtables);
+    Exporter::writeMetric(os, "lsmio_sstables", "gauge", "SSTables of the local store.", labels,
+                          gauges.sstables);
+    Exporter::writeMetric(os, "lsmio_aggregator_queue_depth", "gauge",
+                          "Received commands the aggregator has not dispatched yet.", labels,
+                          queueDepth);
+}
+
 LSMIOManager::~LSMIOManager() {
     close();
 }
 
 void LSMIOManager::close() {
     LOG(INFO) << "LSMIOManager::close(): rank: " << _aggRank << std::endl;
+    // The exporter samples the store and the client, stop it before either goes away
+    if (_metrics) {
+        _metrics->stop();
+        delete _metrics;
+        _metrics = nullptr;
+    }
+
     // Delete MPI first because its cleanup might require RDB being open
     if (_lcMPI) {
+        waitAll();
+
         if (_isServeLocal()) {
             _lcMPI->stopCollectiveIOServer();
         } else if (_isOpenRemote()) {
@@ -208,11 +566,45 @@ void LSMIOManager::close() {
         _lcMPI = nullptr;
     }
 
+    if (_aggAdiosComm) {
+        _aggAdiosComm->Free("LSMIOManager::close");
+        delete _aggAdiosComm;
+        _aggAdiosComm = nullptr;
+    }
+
     if (_lcStore) {
         _lcStore->close();
         delete _lcStore;
         _lcStore = nullptr;
     }
+
+    if (_restartIndex) {
+        _saveRestartIndex();
+        delete _restartIndex;
+        _restartIndex = nullptr;
+    }
+
+    if (_globalComm != MPI_COMM_NULL) {
+        MPI_Comm_free(&_globalComm);
+    }
+
+    if (_readCache) {
+        delete _readCache;
+        _readCache = nullptr;
+    }
+
+    if (_isTracing) {
+        LSMIOTrace::disableSpans();
+        _isTracing = false;
+
+        std::error_code ec;
+        std::filesystem::path tracePath(gConfigLSMIO.traceDir);
+        std::filesystem::create_directories(tracePath, ec);
+        tracePath /= _dbName + ".trace." + std::to_string(_worldRank) + ".json";
+        if (!LSMIOTrace::writeSpans(tracePath.string())) {
+            LOG(ERROR) << "LSMIOManager::close: failed to write trace: " << tracePath << std::endl;
+        }
+    }
 }
 
 bool LSMIOManager::_isOpenLocal() const {
@@ -240,128 +632,400 @@ std::string LSMIOManager::getDbPath() const {
 }
 
 bool LSMIOManager::get(const std::string& key, std::string* value) {
+    LSMIOStatTimer timer(&_stats, StatOp::Get);
+    LSMIOSpan span("manager.get");
     bool retValue = true;
 
-    LOG(INFO) << "LSMIOManager::get: for rank: " << _aggRank << " key: " << key << std::endl;
+    LSMIO_TRACE2(Get, key.length(), _aggRank);
     if (_isOpenLocal()) {
-        LOG(INFO) << "LSMIOManager::get: LOCAL for rank: " << _aggRank << std::endl;
         retValue = _lcStore->get(_rankedKey(key), value);
 
-        _counterReadBytes += value->length();
-        _counterReadOps++;
+        _stats.addRead(value->length());
 
         return retValue;
     }
 
     if (_isOpenRemote()) {
-        retValue &= _lcMPI->sendCommand(AGGREGATION_RANK, KV_CMD::GET, key, KV_DUMMY);
+        bool useCache = _readCache && gConfigLSMIO.readCacheData;
+        if (useCache && _readCache->get(READ_CACHE_DATA + key, value)) {
+            _stats.addRead(value->length());
+            return true;
+        }
 
         std::string cCommand, cKey;
-        retValue &= _lcMPI->recvCommand(AGGREGATION_RANK, &cCommand, &cKey, value);
+        {
+            LSMIOStatTimer remoteTimer(&_stats, StatOp::Remote);
+            retValue &= _lcMPI->sendCommand(AGGREGATION_RANK, KV_CMD::GET, key, KV_DUMMY);
+            retValue &= _lcMPI->recvCommand(AGGREGATION_RANK, &cCommand, &cKey, value);
+        }
 
-        _counterReadBytes += value->length();
-        _counterReadOps++;
+        _stats.addRead(value->length());
 
         if (cCommand != KV_CMD_RETURN::GET) {
             LOG(ERROR) << "LSMIOManager::get: received incorrect command: " << cCommand
                        << std::endl;
             return false;
         }
+
+        if (useCache && retValue && !value->empty()) _readCache->put(READ_CACHE_DATA + key, *value);
+    }
+
+    return retValue;
+}
+
+bool LSMIOManager::getBatch(const std::vector<std::string>& keys,
+                            std::vector<std::string>* values) {
+    LSMIOStatTimer timer(&_stats, StatOp::Get);
+    LSMIOSpan span("manager.getBatch", keys.size());
+    bool retValue = true;
+
+    LSMIO_TRACE2(GetBatch, keys.size(), _aggRank);
+    values->assign(keys.size(), std::string());
+
+    if (_isOpenLocal()) {
+        for (size_t i = 0; i < keys.size(); i++) {
+            retValue &= _lcStore->get(_rankedKey(keys[i]), &(*values)[i]);
+            _stats.addRead((*values)[i].length());
+        }
+
+        return retValue;
+    }
+
+    if (_isOpenRemote()) {
+        bool useCache = _readCache && gConfigLSMIO.readCacheData;
+
+        // positions of the keys that have to be asked for
+        std::vector<size_t> missing;
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (useCache && _readCache->get(READ_CACHE_DATA + keys[i], &(*values)[i])) {
+                _stats.addRead((*values)[i].length());
+            } else {
+                missing.push_back(i);
+            }
+        }
+
+        // the request is a list of (key, "") pairs, the reply the matching (key, value) pairs;
+        // exactly one message per call, even when every key was cached, so that the number of
+        // commands a client sends does not depend on its data
+        std::string request, reply, cCommand, cKey;
+        for (size_t i : missing) {
+            tupleSerializeBinary(keys[i], "", request);
+        }
+
+        {
+            LSMIOStatTimer remoteTimer(&_stats, StatOp::Remote);
+            retValue &= _lcMPI->sendCommand(AGGREGATION_RANK, KV_CMD::GET_BATCH,
+                                            std::to_string(missing.size()), request);
+            retValue &= _lcMPI->recvCommand(AGGREGATION_RANK, &cCommand, &cKey, &reply);
+        }
+
+        if (cCommand != KV_CMD_RETURN::GET_BATCH) {
+            LOG(ERROR) << "LSMIOManager::getBatch: received incorrect command: " << cCommand
+                       << std::endl;
+            return false;
+        }
+
+        std::vector<std::tuple<std::string, std::string>> replies;
+        vectorTupleDeserializeBinary(reply, replies);
+        if (replies.size() != missing.size()) {
+            LOG(ERROR) << "LSMIOManager::getBatch: expected " << missing.size()
+                       << " values, received: " << replies.size() << std::endl;
+            return false;
+        }
+
+        for (size_t i = 0; i < missing.size(); i++) {
+            std::string& value = (*values)[missing[i]];
+            value = std::move(std::get<1>(replies[i]));
+            _stats.addRead(value.length());
+
+            if (useCache && !value.empty()) {
+                _readCache->put(READ_CACHE_DATA + keys[missing[i]], value);
+            }
+        }
     }
 
     return retValue;
 }
 
 bool LSMIOManager::put(const std::string& key, const std::string& value, bool flush) {
+    LSMIOStatTimer timer(&_stats, StatOp::Put);
+    LSMIOSpan span("manager.put", value.length());
     bool retValue = true;
 
-    LOG(INFO) << "LSMIOManager::put:flush: rank: " << _aggRank << " key: " << key << "("
-              << key.length() << ")"
-              << " value.len: " << value.length() << " flush: " << flush << std::endl;
+    LSMIO_TRACE2(Put, value.length(), _aggRank);
 
-    _counterWriteBytes += value.length();
-    _counterWriteOps++;
+    _stats.addWrite(value.length());
 
     if (_isOpenLocal()) {
-        LOG(INFO) << "LSMIOManager::put: LOCAL for rank: " << _aggRank << std::endl;
+        _indexMutation(_aggRank, key, false, false);
         return _lcStore->put(_rankedKey(key), value, flush);
     }
 
     if (_isOpenRemote()) {
         retValue &= _lcMPI->sendCommand(AGGREGATION_RANK, KV_CMD::PUT, key, value);
+        _isWritePending = true;
+        if (_readCache) _readCache->erase(READ_CACHE_DATA + key);
     }
 
     return retValue;
 }
 
 bool LSMIOManager::put(const std::string& key, const std::string& value) {
-    LOG(INFO) << "LSMIOManager::put: for rank: " << _aggRank << " key: " << key << std::endl;
     return put(key, value, gConfigLSMIO.alwaysFlush);
 }
 
 bool LSMIOManager::put(const std::string& key, const char* value, std::streamsize n) {
-    LOG(INFO) << "LSMIOManager::put: for char* for rank: " << _aggRank << " key: " << key
-              << std::endl;
     std::string nValue(value, n);
     return put(key, nValue, gConfigLSMIO.alwaysFlush);
 }
 
 bool LSMIOManager::put(const std::string& key, const void* value, size_t size, size_t count) {
-    LOG(INFO) << "LSMIOManager::put: for void* for rank: " << _aggRank << " key: " << key
-              << std::endl;
     std::string nValue(static_cast<const char*>(value), size * count);
     return put(key, nValue, gConfigLSMIO.alwaysFlush);
 }
 
+bool LSMIOManager::putBatch(const std::vector<std::tuple<std::string, std::string>>& values,
+                            const std::vector<std::tuple<std::string, std::string>>& metaValues,
+                            bool flush) {
+    LSMIOStatTimer timer(&_stats, StatOp::Put);
+    LSMIOSpan span("manager.putBatch", values.size() + metaValues.size());
+    bool retValue = true;
+
+    LSMIO_TRACE2(PutBatch, values.size() + metaValues.size(), _aggRank);
+
+    if (_isOpenLocal()) {
+        for (const auto& [key, value] : values) _stats.addWrite(value.length());
+        for (const auto& [key, value] : metaValues) _stats.addWrite(value.length());
+        return _storeBatch(_aggRank, values, metaValues, flush);
+    }
+
+    if (_isOpenRemote()) {
+        // key of a PUT_BATCH is the number of data entries, metadata entries follow them;
+        // exactly one message per call, so that the number of commands a client sends does
+        // not depend on how much data it holds
+        std::string buffer;
+        for (size_t i = 0; i < values.size() + metaValues.size(); i++) {
+            const bool meta = i >= values.size();
+            const auto& [key, value] = meta ? metaValues[i - values.size()] : values[i];
+            tupleSerializeBinary(key, value, buffer);
+
+            _stats.addWrite(value.length());
+            if (_readCache && meta) _readCache->put(READ_CACHE_META + key, value);
+            if (_readCache && !meta) _readCache->erase(READ_CACHE_DATA + key);
+        }
+
+        retValue &= _lcMPI->sendCommand(AGGREGATION_RANK, KV_CMD::PUT_BATCH,
+                                        std::to_string(values.size()), buffer);
+        _isWritePending = true;
+    }
+
+    return retValue;
+}
+
+bool LSMIOManager::_storeBatch(int rank,
+                               const std::vector<std::tuple<std::string, std::string>>& values,
+                               const std::vector<std::tuple<std::string, std::string>>& metaValues,
+                               bool flush) {
+    const size_t count = values.size() + metaValues.size();
+    bool retValue = true;
+
+    // only the last mutation may flush, so that the batch reaches the store as one
+    for (size_t i = 0; i < count; i++) {
+        const bool meta = i >= values.size();
+        const bool last = flush && i + 1 == count;
+        const auto& [key, value] = meta ? metaValues[i - values.size()] : values[i];
+
+        _indexMutation(rank, key, meta, false);
+        if (meta) {
+            retValue &= _lcStore->metaPut(_rankedKey(rank, key), value, last);
+        } else {
+            retValue &= _lcStore->put(_rankedKey(rank, key), value, last);
+        }
+    }
+
+    return retValue;
+}
+
+LSMIORequest LSMIOManager::_acquireRequestTag() {
+    LSMIORequest tag = _nextRequestTag;
+    _nextRequestTag = (tag == KV_TAG_REQUEST_MAX) ? KV_TAG_REQUEST_MIN : tag + 1;
+
+    if (_pending.count(tag)) {
+        LOG(WARNING) << "LSMIOManager::_acquireRequestTag: tag still in flight: " << tag
+                     << std::endl;
+        wait(tag);
+    }
+
+    return tag;
+}
+
+bool LSMIOManager::_completeRequest(LSMIORequest request, bool block, bool* success) {
+    *success = true;
+
+    auto it = _pending.find(request);
+    if (it == _pending.end()) return true;
+
+    PendingRequest& pending = it->second;
+    if (pending.send) {
+        if (block) {
+            pending.send->wait();
+        } else if (!pending.send->test()) {
+            return false;
+        }
+
+        delete pending.send;
+        pending.send = nullptr;
+    }
+
+    if (pending.value) {
+        if (!block && !_lcMPI->probeCommand(AGGREGATION_RANK, request)) return false;
+
+        std::string cCommand, cKey;
+        *success &=
+            _lcMPI->recvCommand(AGGREGATION_RANK, &cCommand, &cKey, pending.value, request);
+
+        auto elapsed = std::chrono::steady_clock::now() - pending.start;
+        _stats.record(StatOp::Remote,
+                      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+
+        _stats.addRead(pending.value->length());
+
+        if (cCommand != KV_CMD_RETURN::GET) {
+            LOG(ERROR) << "LSMIOManager::_completeRequest: received incorrect command: "
+                       << cCommand << std::endl;
+            *success = false;
+        }
+    }
+
+    _pending.erase(it);
+    return true;
+}
+
+bool LSMIOManager::iput(const std::string& key, const std::string& value, LSMIORequest* request) {
+    LSMIO_TRACE2(IPut, value.length(), _aggRank);
+    *request = LSMIO_REQUEST_NULL;
+
+    if (!_isOpenRemote()) {
+        return put(key, value);
+    }
+
+    LSMIOStatTimer timer(&_stats, StatOp::Put);
+    LSMIOSpan span("manager.iput", value.length());
+    _stats.addWrite(value.length());
+
+    LSMIORequest tag = _acquireRequestTag();
+    _pending[tag].send = _lcMPI->isendCommand(AGGREGATION_RANK, KV_CMD::PUT, key, value, tag);
+    _isWritePending = true;
+    if (_readCache) _readCache->erase(READ_CACHE_DATA + key);
+    *request = tag;
+
+    return true;
+}
+
+bool LSMIOManager::iget(const std::string& key, std::string* value, LSMIORequest* request) {
+    LSMIO_TRACE2(IGet, key.length(), _aggRank);
+    *request = LSMIO_REQUEST_NULL;
+
+    if (!_isOpenRemote()) {
+        return get(key, value);
+    }
+
+    LSMIORequest tag = _acquireRequestTag();
+    PendingRequest& pending = _pending[tag];
+    pending.start = std::chrono::steady_clock::now();
+    pending.send = _lcMPI->isendCommand(AGGREGATION_RANK, KV_CMD::GET, key, KV_DUMMY, tag);
+    pending.value = value;
+    *request = tag;
+
+    return true;
+}
+
+bool LSMIOManager::test(LSMIORequest request, bool* success) {
+    bool retValue = true;
+
+    if (!_completeRequest(request, false, &retValue)) return false;
+
+    if (success) *success = retValue;
+    return true;
+}
+
+bool LSMIOManager::wait(LSMIORequest request) {
+    bool retValue = true;
+    _completeRequest(request, true, &retValue);
+    return retValue;
+}
+
+bool LSMIOManager::waitAll() {
+    bool retValue = true;
+
+    while (!_pending.empty()) {
+        retValue &= wait(_pending.begin()->first);
+    }
+
+    return retValue;
+}
+
 bool LSMIOManager::del(const std::string& key, bool flush) {
+    LSMIOSpan span("manager.del");
     bool retValue = true;
 
-    LOG(INFO) << "LSMIOManager::del:flush: for rank: " << _aggRank << " key: " << key << std::endl;
+    LSMIO_TRACE2(Del, key.length(), _aggRank);
     if (_isOpenLocal()) {
-        LOG(INFO) << "LSMIOManager::del: LOCAL for rank: " << _aggRank << std::endl;
+        _indexMutation(_aggRank, key, false, true);
         return _lcStore->del(_rankedKey(key), flush);
     }
 
     if (_isOpenRemote()) {
         retValue &= _lcMPI->sendCommand(AGGREGATION_RANK, KV_CMD::DEL, key, KV_DUMMY);
+        _isWritePending = true;
+        if (_readCache) _readCache->erase(READ_CACHE_DATA + key);
     }
 
     return retValue;
 }
 
 bool LSMIOManager::del(const std::string& key) {
-    LOG(INFO) << "LSMIOManager::del: for rank: " << _aggRank << " key: " << key << std::endl;
     return del(key, gConfigLSMIO.alwaysFlush);
 }
 
 bool LSMIOManager::metaGet(const std::string& key, std::string* value) {
+    LSMIOStatTimer timer(&_stats, StatOp::Get);
+    LSMIOSpan span("manager.metaGet");
     bool retValue = true;
 
-    LOG(INFO) << "LSMIOManager::metaGet: for rank: " << _aggRank << " key: " << key << std::endl;
+    LSMIO_TRACE2(MetaGet, key.length(), _aggRank);
     if (_isOpenLocal()) {
-        LOG(INFO) << "LSMIOManager::metaGet: LOCAL for rank: " << _aggRank << std::endl;
         retValue = _lcStore->metaGet(_rankedKey(key), value);
 
-        _counterReadBytes += value->length();
-        _counterReadOps++;
+        _stats.addRead(value->length());
 
         return retValue;
     }
 
     if (_isOpenRemote()) {
-        retValue &= _lcMPI->sendCommand(AGGREGATION_RANK, KV_CMD::META_GET, key, KV_DUMMY);
+        if (_readCache && _readCache->get(READ_CACHE_META + key, value)) {
+            _stats.addRead(value->length());
+            return true;
+        }
 
         std::string cCommand, cKey;
-        retValue &= _lcMPI->recvCommand(AGGREGATION_RANK, &cCommand, &cKey, value);
+        {
+            LSMIOStatTimer remoteTimer(&_stats, StatOp::Remote);
+            retValue &= _lcMPI->sendCommand(AGGREGATION_RANK, KV_CMD::META_GET, key, KV_DUMMY);
+            retValue &= _lcMPI->recvCommand(AGGREGATION_RANK, &cCommand, &cKey, value);
+        }
 
-        _counterReadBytes += value->length();
-        _counterReadOps++;
+        _stats.addRead(value->length());
 
         if (cCommand != KV_CMD_RETURN::META_GET) {
             LOG(ERROR) << "LSMIOManager::metaGet: received incorrect command: " << cCommand
                        << std::endl;
             return false;
         }
+
+        if (_readCache && retValue && !value->empty()) {
+            _readCache->put(READ_CACHE_META + key, *value);
+        }
     }
 
     return retValue;
@@ -371,31 +1035,24 @@ bool LSMIOManager::metaGetAll(std::vector<std::tuple<std::string, std::string>>*
                               std::string inFix) {
     bool retValue = true;
 
-    LOG(INFO) << "LSMIOManager::metaGetAll: for rank: " << _aggRank << std::endl;
+    LSMIO_TRACE2(MetaGetAll, inFix.length(), _aggRank);
     if (_isOpenLocal()) {
-        LOG(INFO) << "LSMIOManager::metaGetAll: LOCAL for rank: " << _aggRank << std::endl;
         retValue = _lcStore->metaGetAll(values, inFix);
 
-        _counterReadBytes += values->size();
-        _counterReadOps++;
+        _stats.addRead(values->size());
 
         return retValue;
     }
 
     if (_isOpenRemote()) {
-        LOG(INFO) << "LSMIOManager::metaGetAll: REMOTE to rank: " << _aggRank << std::endl;
         retValue &= _lcMPI->sendCommand(AGGREGATION_RANK, KV_CMD::META_GET_ALL, KV_DUMMY, KV_DUMMY);
 
         std::string cCommand, cKey;
         std::string value;
 
-        LOG(INFO) << "LSMIOManager::metaGetAll: waiting for REMOTE." << std::endl;
         retValue &= _lcMPI->recvCommand(AGGREGATION_RANK, &cCommand, &cKey, &value);
-        LOG(INFO) << "LSMIOManager::metaGetAll: REMOTE response received len: " << value.length()
-                  << std::endl;
 
-        _counterReadBytes += value.length();
-        _counterReadOps++;
+        _stats.addRead(value.length());
 
         lsmio::vectorTupleDeserialize(value, *values);
 
@@ -410,37 +1067,107 @@ bool LSMIOManager::metaGetAll(std::vector<std::tuple<std::string, std::string>>*
 }
 
 bool LSMIOManager::metaPut(const std::string& key, const std::string& value, bool flush) {
+    LSMIOStatTimer timer(&_stats, StatOp::Put);
+    LSMIOSpan span("manager.metaPut", value.length());
     bool retValue = true;
 
-    LOG(INFO) << "LSMIOManager::metaPut: rank: " << _aggRank << " key: " << key << "("
-              << key.length() << ")"
-              << " value.len: " << value.length() << " flush: " << flush << std::endl;
+    LSMIO_TRACE2(MetaPut, value.length(), _aggRank);
 
-    _counterWriteBytes += value.length();
-    _counterWriteOps++;
+    _stats.addWrite(value.length());
 
     if (_isOpenLocal()) {
-        LOG(INFO) << "LSMIOManager::metaPut: LOCAL for rank: " << _aggRank << std::endl;
+        _indexMutation(_aggRank, key, true, false);
         return _lcStore->metaPut(_rankedKey(key), value, flush);
     }
 
     if (_isOpenRemote()) {
         retValue &= _lcMPI->sendCommand(AGGREGATION_RANK, KV_CMD::META_PUT, key, value);
+        _isWritePending = true;
+        if (_readCache) _readCache->put(READ_CACHE_META + key, value);
     }
 
     return retValue;
 }
 
+bool LSMIOManager::metaGetAllCollective(
+    std::vector<std::tuple<std::string, std::string>>* values) {
+    bool retValue = true;
+
+    LOG(INFO) << "LSMIOManager::metaGetAllCollective: for rank: " << _aggRank << std::endl;
+    if (!_isServeLocal() && !_isOpenRemote()) {
+        return metaGetAll(values);
+    }
+
+    std::vector<int> counts(_aggSize, 0);
+    std::vector<int> displs(_aggSize, 0);
+    std::string buffer;
+    int count = 0;
+
+    if (_isServeLocal()) {
+        // remote writes issued before the call have been applied once everyone is here
+        MPI_Barrier(_aggComm);
+        retValue = _lcStore->metaGetAll(values);
+
+        // keys are <metaPrefix><rank>::<key>, bucket them by the owning rank
+        const std::string& prefix = _lcStore->metaPrefix();
+        std::vector<std::vector<std::tuple<std::string, std::string>>> buckets(_aggSize);
+        for (const auto& tup : *values) {
+            const std::string& key = std::get<0>(tup);
+            size_t sep = key.find("::", prefix.length());
+            if (sep == std::string::npos) continue;
+
+            int rank = std::atoi(key.c_str() + prefix.length());
+            if (rank > AGGREGATION_RANK && rank < _aggSize) buckets[rank].push_back(tup);
+        }
+
+        for (int rank = 0; rank < _aggSize; rank++) {
+            size_t offset = buffer.length();
+            vectorTupleSerializeBinary(buckets[rank], buffer);
+            displs[rank] = offset;
+            counts[rank] = retValue ? static_cast<int>(buffer.length() - offset) : -1;
+        }
+        if (!retValue) buffer.clear();
+
+        MPI_Scatter(counts.data(), 1, MPI_INT, &count, 1, MPI_INT, AGGREGATION_RANK, _aggComm);
+        std::vector<int> sendCounts(counts);
+        for (int& sendCount : sendCounts) sendCount = std::max(sendCount, 0);
+        MPI_Scatterv(buffer.data(), sendCounts.data(), displs.data(), MPI_BYTE, MPI_IN_PLACE, 0,
+                     MPI_BYTE, AGGREGATION_RANK, _aggComm);
+    } else {
+        // every client, with writes in flight or not, has its writes applied before the scan
+        retValue &= writeBarrier();
+        MPI_Barrier(_aggComm);
+
+        MPI_Scatter(nullptr, 1, MPI_INT, &count, 1, MPI_INT, AGGREGATION_RANK, _aggComm);
+        buffer.resize(std::max(count, 0));
+        MPI_Scatterv(nullptr, nullptr, nullptr, MPI_BYTE, buffer.data(), buffer.length(),
+                     MPI_BYTE, AGGREGATION_RANK, _aggComm);
+
+        if (count < 0) {
+            LOG(ERROR) << "LSMIOManager::metaGetAllCollective: aggregator scan failed."
+                       << std::endl;
+            retValue = false;
+        }
+        vectorTupleDeserializeBinary(buffer, *values);
+    }
+
+    _stats.addRead(buffer.length());
+
+    return retValue;
+}
+
 bool LSMIOManager::readBarrier() {
+    LSMIOStatTimer timer(&_stats, StatOp::Barrier);
+    LSMIOSpan span("manager.readBarrier");
     bool retValue = true;
 
-    LOG(INFO) << "LSMIOManager::readBarrier: for rank: " << _aggRank << std::endl;
+    LSMIO_TRACE(ReadBarrier, _aggRank);
     if (_isOpenLocal()) {
-        LOG(INFO) << "LSMIOManager::readBarrier: LOCAL for rank: " << _aggRank << std::endl;
         return _lcStore->readBarrier();
     }
 
     if (_isOpenRemote()) {
+        retValue &= waitAll();
         retValue &= _lcMPI->sendCommand(AGGREGATION_RANK, KV_CMD::READ_BARRIER, KV_DUMMY, KV_DUMMY);
 
         std::string cCommand, cKey, cValue;
@@ -457,17 +1184,20 @@ bool LSMIOManager::readBarrier() {
 }
 
 bool LSMIOManager::writeBarrier() {
+    LSMIOStatTimer timer(&_stats, StatOp::Barrier);
+    LSMIOSpan span("manager.writeBarrier");
     bool retValue = true;
 
-    LOG(INFO) << "LSMIOManager::writeBarrier: for rank: " << _aggRank << std::endl;
+    LSMIO_TRACE(WriteBarrier, _aggRank);
     if (_isOpenLocal()) {
-        LOG(INFO) << "LSMIOManager::writeBarrier: LOCAL for rank: " << _aggRank << std::endl;
         return _lcStore->writeBarrier();
     }
 
     if (_isOpenRemote()) {
+        retValue &= waitAll();
         retValue &=
             _lcMPI->sendCommand(AGGREGATION_RANK, KV_CMD::WRITE_BARRIER, KV_DUMMY, KV_DUMMY);
+        _isWritePending = false;
 
         std::string cCommand, cKey, cValue;
         retValue &= _lcMPI->recvCommand(AGGREGATION_RANK, &cCommand, &cKey, &cValue);
@@ -485,15 +1215,34 @@ bool LSMIOManager::writeBarrier() {
 void LSMIOManager::callbackForCollectiveIO(int rank, const std::string& command,
                                            const std::string& key, std::string* gValue,
                                            std::string pValue) {
+    LSMIOSpan span("aggregator.command", pValue.length());
     bool retValue = true;
 
-    LOG(INFO) << "LSMIOManager::callbackForCollectiveIO: " << command << ": " << key << std::endl;
-
     if (command == KV_CMD::GET) {
         retValue &= _lcStore->get(_rankedKey(rank, key), gValue);
+    } else if (command == KV_CMD::GET_BATCH) {
+        std::vector<std::tuple<std::string, std::string>> values;
+        vectorTupleDeserializeBinary(pValue, values);
+
+        for (auto& [vKey, value] : values) {
+            retValue &= _lcStore->get(_rankedKey(rank, vKey), &value);
+        }
+        vectorTupleSerializeBinary(values, *gValue);
     } else if (command == KV_CMD::PUT) {
+        _indexMutation(rank, key, false, false);
         retValue &= _lcStore->put(_rankedKey(rank, key), pValue, gConfigLSMIO.alwaysFlush);
+    } else if (command == KV_CMD::PUT_BATCH) {
+        std::vector<std::tuple<std::string, std::string>> values, metaValues;
+        vectorTupleDeserializeBinary(pValue, values);
+
+        size_t dataCount = std::min<size_t>(std::stoull(key), values.size());
+        metaValues.assign(std::make_move_iterator(values.begin() + dataCount),
+                          std::make_move_iterator(values.end()));
+        values.resize(dataCount);
+
+        retValue &= _storeBatch(rank, values, metaValues, gConfigLSMIO.alwaysFlush);
     } else if (command == KV_CMD::DEL) {
+        _indexMutation(rank, key, false, true);
         retValue &= _lcStore->del(_rankedKey(rank, key), gConfigLSMIO.alwaysFlush);
     } else if (command == KV_CMD::META_GET) {
         retValue &= _lcStore->metaGet(_rankedKey(rank, key), gValue);
@@ -503,32 +1252,38 @@ void LSMIOManager::callbackForCollectiveIO(int rank, const std::string& command,
         retValue &= _lcStore->metaGetAll(&values, inFix);
         lsmio::vectorTupleSerialize(values, *gValue);
     } else if (command == KV_CMD::META_PUT) {
+        _indexMutation(rank, key, true, false);
         retValue &= _lcStore->metaPut(_rankedKey(rank, key), pValue, gConfigLSMIO.alwaysFlush);
     } else if (command == KV_CMD::WRITE_BARRIER) {
         retValue &= _lcStore->writeBarrier();
+    } else if (command == KV_CMD::WAIT_CAPACITY) {
+        retValue &= _lcStore->waitForCapacity();
     } else {
         LOG(ERROR) << "LSMIOManager::callbackForCollectiveIO: UNKNOWN command: " << command
                    << std::endl;
         retValue = false;
     }
-
-    LOG(INFO) << "LSMIOManager::callbackForCollectiveIO: " << command << ": COMPLETED."
-              << std::endl;
 }
 
 void LSMIOManager::resetCounters() {
-    _counterWriteBytes = 0;
-    _counterReadBytes = 0;
-    _counterWriteOps = 0;
-    _counterReadOps = 0;
+    _stats.reset();
 }
 
 void LSMIOManager::getCounters(uint64_t& writeBytes, uint64_t& readBytes, uint64_t& writeOps,
                                uint64_t& readOps) const {
-    writeBytes = _counterWriteBytes;
-    readBytes = _counterReadBytes;
-    writeOps = _counterWriteOps;
-    readOps = _counterReadOps;
+    LSMIOStatsSnapshot snap = _stats.snapshot();
+    writeBytes = snap.writeBytes;
+    readBytes = snap.readBytes;
+    writeOps = snap.writeOps;
+    readOps = snap.readOps;
+}
+
+LSMIOStatsSnapshot LSMIOManager::getStats() const {
+    return _stats.snapshot();
+}
+
+void LSMIOManager::resetStats() {
+    _stats.reset();
 }
 
 LSMIOManager* LSMIOManager::initialize(const std::string& dbName, const std::string& dbDir,
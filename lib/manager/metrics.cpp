@@ -0,0 +1,144 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <lsmio/manager/metrics.hpp>
+
+namespace lsmio {
+
+LSMIOMetricsExporter::LSMIOMetricsExporter(const std::string &filePath, int intervalMs,
+                                           Writer writer)
+    : _filePath(filePath), _interval(std::max(intervalMs, 1)), _writer(std::move(writer)) {
+    _thread = std::thread(&LSMIOMetricsExporter::_run, this);
+}
+
+LSMIOMetricsExporter::~LSMIOMetricsExporter() {
+    stop();
+}
+
+void LSMIOMetricsExporter::_run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (!_stop) {
+        lock.unlock();
+        exportNow();
+        lock.lock();
+
+        _cv.wait_for(lock, _interval, [this] { return _stop; });
+    }
+}
+
+bool LSMIOMetricsExporter::exportNow() {
+    std::string tmpPath = _filePath + ".tmp";
+
+    {
+        std::ofstream os(tmpPath, std::ios::out | std::ios::trunc);
+        if (!os) {
+            LOG(ERROR) << "LSMIOMetricsExporter::exportNow: cannot write: " << tmpPath
+                       << std::endl;
+            return false;
+        }
+        _writer(os);
+        if (!os) return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, _filePath, ec);
+    if (ec) {
+        LOG(ERROR) << "LSMIOMetricsExporter::exportNow: cannot replace: " << _filePath << ": "
+                   << ec.message() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void LSMIOMetricsExporter::stop() {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_stop) return;
+        _stop = true;
+    }
+    _cv.notify_all();
+
+    if (_thread.joinable()) _thread.join();
+    exportNow();
+}
+
+namespace {
+
+void writeHeader(std::ostream &os, const std::string &name, const std::string &type,
+                 const std::string &help, const std::string &labels) {
+    os << "# HELP " << name << " " << help << "\n";
+    os << "# TYPE " << name << " " << type << "\n";
+    os << name;
+    if (!labels.empty()) os << "{" << labels << "}";
+}
+
+}  // namespace
+
+void LSMIOMetricsExporter::writeMetric(std::ostream &os, const std::string &name,
+                                       const std::string &type, const std::string &help,
+                                       const std::string &labels, double value) {
+    writeHeader(os, name, type, help, labels);
+    std::streamsize precision = os.precision(17);
+    os << " " << value << "\n";
+    os.precision(precision);
+}
+
+void LSMIOMetricsExporter::writeMetric(std::ostream &os, const std::string &name,
+                                       const std::string &type, const std::string &help,
+                                       const std::string &labels, uint64_t value) {
+    writeHeader(os, name, type, help, labels);
+    os << " " << value << "\n";
+}
+
+std::string LSMIOMetricsExporter::labelValue(const std::string &value) {
+    std::string quoted = "\"";
+
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            quoted += '\\';
+            quoted += c;
+        } else if (c == '\n') {
+            quoted += "\\n";
+        } else {
+            quoted += c;
+        }
+    }
+
+    return quoted + "\"";
+}
+
+}  // namespace lsmio
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <lsmio/manager/read_cache.hpp>
+
+namespace lsmio {
+
+LSMIOReadCache::LSMIOReadCache(uint64_t capacity) : _capacity(capacity) {}
+
+bool LSMIOReadCache::get(const std::string &key, std::string *value) {
+    auto it = _index.find(key);
+    if (it == _index.end()) {
+        _misses++;
+        return false;
+    }
+
+    _entries.splice(_entries.begin(), _entries, it->second);
+    *value = it->second->second;
+    _hits++;
+    return true;
+}
+
+void LSMIOReadCache::put(const std::string &key, const std::string &value) {
+    erase(key);
+
+    uint64_t bytes = key.length() + value.length();
+    if (bytes > _capacity) return;
+
+    _entries.emplace_front(key, value);
+    _index[key] = _entries.begin();
+    _sizeBytes += bytes;
+
+    _evict();
+}
+
+void LSMIOReadCache::erase(const std::string &key) {
+    auto it = _index.find(key);
+    if (it == _index.end()) return;
+
+    _sizeBytes -= it->second->first.length() + it->second->second.length();
+    _entries.erase(it->second);
+    _index.erase(it);
+}
+
+void LSMIOReadCache::clear() {
+    _entries.clear();
+    _index.clear();
+    _sizeBytes = 0;
+}
+
+void LSMIOReadCache::_evict() {
+    while (_sizeBytes > _capacity && !_entries.empty()) {
+        const Entry &last = _entries.back();
+        _sizeBytes -= last.first.length() + last.second.length();
+        _index.erase(last.first);
+        _entries.pop_back();
+    }
+}
+
+}  // namespace lsmio
@@ -0,0 +1,480 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <lsmio/manager/restart.hpp>
+#include <lsmio/manager/store/native/store_native.hpp>
+#include <lsmio/manager/store/store_ldb.hpp>
+#include <lsmio/manager/store/store_rdb.hpp>
+#include <lsmio/manager/store/store_sharded.hpp>
+
+namespace lsmio {
+
+// version 2 appends the entries an update deletes
+static const char RESTART_INDEX_MAGIC[] = "LSMIOIX2";
+static const char RESTART_INDEX_MAGIC_V1[] = "LSMIOIX1";
+static const size_t RESTART_INDEX_MAGIC_LEN = sizeof(RESTART_INDEX_MAGIC) - 1;
+
+static void writeUInt32(std::ostream &os, uint32_t v) {
+    os.write(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+static void writeString(std::ostream &os, const std::string &s) {
+    writeUInt32(os, static_cast<uint32_t>(s.size()));
+    os.write(s.data(), s.size());
+}
+
+static bool readUInt32(std::istream &is, uint32_t *v) {
+    is.read(reinterpret_cast<char *>(v), sizeof(*v));
+    return !is.fail();
+}
+
+static bool readString(std::istream &is, std::string *s) {
+    uint32_t len;
+    if (!readUInt32(is, &len)) return false;
+    s->resize(len);
+    is.read(&(*s)[0], len);
+    return !is.fail();
+}
+
+std::string restartIndexDir(const std::string &dbName, const std::string &dbDir) {
+    std::filesystem::path path(dbDir);
+    path /= dbName + ".index";
+    return path.string();
+}
+
+LSMIORestartIndex::LSMIORestartIndex(const std::string &storePath, StorageType storageType,
+                                     int shards, bool byRank)
+    : _storePath(storePath), _storageType(storageType), _shards(shards), _byRank(byRank) {}
+
+void LSMIORestartIndex::add(const std::string &storeKey, int writer, bool meta,
+                            const std::string &key) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry &entry = _entries[storeKey];
+    entry.writer = writer;
+    entry.meta = meta;
+    entry.key = key;
+    _unsaved.insert(storeKey);
+    _removed.erase(storeKey);
+}
+
+void LSMIORestartIndex::remove(const std::string &storeKey) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(storeKey);
+    if (it == _entries.end()) return;
+
+    // readers may have the entry from an earlier update
+    _removed[storeKey] = it->second;
+    _entries.erase(it);
+    _unsaved.erase(storeKey);
+}
+
+std::map<std::string, LSMIORestartIndex::Entry> LSMIORestartIndex::entries() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries;
+}
+
+std::map<std::string, LSMIORestartIndex::Entry> LSMIORestartIndex::removed() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _removed;
+}
+
+bool LSMIORestartIndex::save(const std::string &filePath) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _write(filePath, nullptr);
+}
+
+bool LSMIORestartIndex::saveNew(const std::string &filePath) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_unsaved.empty() && _removed.empty()) return true;
+
+    if (!_write(filePath, &_unsaved)) return false;
+    _unsaved.clear();
+    _removed.clear();
+    return true;
+}
+
+bool LSMIORestartIndex::_write(const std::string &filePath,
+                               const std::set<std::string> *only) const {
+    std::string tmpPath = filePath + ".tmp";
+    std::ofstream os(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!os) {
+        LOG(ERROR) << "LSMIORestartIndex::save: cannot open: " << tmpPath << std::endl;
+        return false;
+    }
+
+    os.write(RESTART_INDEX_MAGIC, RESTART_INDEX_MAGIC_LEN);
+    writeString(os, _storePath);
+    writeUInt32(os, static_cast<uint32_t>(_storageType));
+    writeUInt32(os, static_cast<uint32_t>(_shards));
+    writeUInt32(os, _byRank ? 1 : 0);
+    writeUInt32(os, static_cast<uint32_t>(only ? only->size() : _entries.size()));
+
+    auto writeEntry = [&os](const std::string &storeKey, const Entry &entry) {
+        writeString(os, storeKey);
+        writeUInt32(os, static_cast<uint32_t>(entry.writer));
+        writeUInt32(os, entry.meta ? 1 : 0);
+        writeString(os, entry.key);
+    };
+
+    if (only) {
+        for (const std::string &storeKey : *only) writeEntry(storeKey, _entries.at(storeKey));
+    } else {
+        for (const auto &[storeKey, entry] : _entries) writeEntry(storeKey, entry);
+    }
+
+    // a full index holds no deletions, it replaces what was published before
+    writeUInt32(os, static_cast<uint32_t>(only ? _removed.size() : 0));
+    if (only) {
+        for (const auto &[storeKey, entry] : _removed) writeEntry(storeKey, entry);
+    }
+
+    os.close();
+    if (os.fail()) {
+        LOG(ERROR) << "LSMIORestartIndex::save: write failed: " << tmpPath << std::endl;
+        return false;
+    }
+
+    // readers never see a partially written index
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, filePath, ec);
+    return !ec;
+}
+
+bool LSMIORestartIndex::load(const std::string &filePath) {
+    std::ifstream is(filePath, std::ios::binary);
+    if (!is) {
+        LOG(ERROR) << "LSMIORestartIndex::load: cannot open: " << filePath << std::endl;
+        return false;
+    }
+
+    std::string magic(RESTART_INDEX_MAGIC_LEN, '\0');
+    is.read(&magic[0], RESTART_INDEX_MAGIC_LEN);
+    if (is.fail() || (magic != RESTART_INDEX_MAGIC && magic != RESTART_INDEX_MAGIC_V1)) {
+        LOG(ERROR) << "LSMIORestartIndex::load: not an index file: " << filePath << std::endl;
+        return false;
+    }
+
+    std::string storePath;
+    uint32_t storageType, shards, byRank, count;
+    if (!readString(is, &storePath) || !readUInt32(is, &storageType) ||
+        !readUInt32(is, &shards) || !readUInt32(is, &byRank) || !readUInt32(is, &count)) {
+        LOG(ERROR) << "LSMIORestartIndex::load: truncated header: " << filePath << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _storePath = storePath;
+    _storageType = static_cast<StorageType>(storageType);
+    _shards = static_cast<int>(shards);
+    _byRank = (byRank != 0);
+
+    auto readEntry = [&is](std::string *storeKey, Entry *entry) {
+        uint32_t writer, meta;
+        if (!readString(is, storeKey) || !readUInt32(is, &writer) || !readUInt32(is, &meta) ||
+            !readString(is, &entry->key)) {
+            return false;
+        }
+        entry->writer = static_cast<int>(writer);
+        entry->meta = (meta != 0);
+        return true;
+    };
+
+    for (uint32_t i = 0; i < count; i++) {
+        std::string storeKey;
+        Entry entry;
+        if (!readEntry(&storeKey, &entry)) {
+            LOG(ERROR) << "LSMIORestartIndex::load: truncated entries: " << filePath << std::endl;
+            return false;
+        }
+        _entries[storeKey] = entry;
+        _removed.erase(storeKey);
+    }
+
+    if (magic == RESTART_INDEX_MAGIC_V1) return true;
+
+    uint32_t removedCount;
+    if (!readUInt32(is, &removedCount)) {
+        LOG(ERROR) << "LSMIORestartIndex::load: truncated deletions: " << filePath << std::endl;
+        return false;
+    }
+    for (uint32_t i = 0; i < removedCount; i++) {
+        std::string storeKey;
+        Entry entry;
+        if (!readEntry(&storeKey, &entry)) {
+            LOG(ERROR) << "LSMIORestartIndex::load: truncated deletions: " << filePath
+                       << std::endl;
+            return false;
+        }
+        _entries.erase(storeKey);
+        _removed[storeKey] = entry;
+    }
+
+    return true;
+}
+
+/// number of an update file <rank>.<n>.idx, LONG_MAX for a full index <rank>.idx
+static long indexFileUpdate(const std::string &path) {
+    const std::string name = std::filesystem::path(path).stem().string();
+    const size_t dot = name.find('.');
+    if (dot == std::string::npos) return LONG_MAX;
+    return std::strtol(name.c_str() + dot + 1, nullptr, 10);
+}
+
+LSMIORestartReader::LSMIORestartReader(const std::string &dbName, const std::string &dbDir)
+    : _dbDir(dbDir), _indexDir(restartIndexDir(dbName, dbDir)) {
+    if (!std::filesystem::is_directory(_indexDir)) {
+        LOG(WARNING) << "LSMIORestartReader: no restart index: " << _indexDir << std::endl;
+        return;
+    }
+
+    _loadIndices();
+
+    LOG(INFO) << "LSMIORestartReader: stores: " << _stores.size()
+              << " writers: " << writers().size() << std::endl;
+}
+
+void LSMIORestartReader::_loadIndices() {
+    if (!std::filesystem::is_directory(_indexDir)) return;
+
+    std::vector<std::tuple<std::filesystem::file_time_type, long, std::string>> files;
+    for (const auto &entry : std::filesystem::directory_iterator(_indexDir)) {
+        if (entry.path().extension() != ".idx") continue;
+
+        // index files are replaced, never modified, so a new write time means new content
+        std::error_code ec;
+        auto writeTime = entry.last_write_time(ec);
+        auto [it, isNew] = _loadedIndices.emplace(entry.path().filename().string(), writeTime);
+        if (isNew || it->second != writeTime) {
+            it->second = writeTime;
+            files.emplace_back(writeTime, indexFileUpdate(entry.path().string()),
+                               entry.path().string());
+        }
+    }
+
+    // oldest first: a deletion follows the update that added the key, and the full index
+    // saved on close supersedes the updates before it, but not those of a later append
+    std::sort(files.begin(), files.end());
+
+    for (const auto &[writeTime, update, file] : files) {
+        LSMIORestartIndex index;
+        if (!index.load(file)) {
+            // e.g. an update removed by the writer's final save: tried again next time
+            _loadedIndices.erase(std::filesystem::path(file).filename().string());
+            continue;
+        }
+
+        // published updates and the final index of an aggregator name the same store
+        std::string path = (std::filesystem::path(_dbDir) / index.storePath()).string();
+        auto [storeIt, isNew] = _storeByPath.emplace(path, _stores.size());
+        if (isNew) {
+            StoreInfo info;
+            info.path = path;
+            info.storageType = index.storageType();
+            info.shards = index.shards();
+            info.byRank = index.byRank();
+            _stores.push_back(info);
+        }
+
+        // the full index also lacks what was deleted after the updates a reader has seen
+        if (update == LONG_MAX) _dropStore(storeIt->second);
+
+        for (const auto &[storeKey, entry] : index.entries()) {
+            auto &locations = entry.meta ? _meta : _data;
+            locations[entry.writer][entry.key] = Location{storeIt->second, storeKey};
+        }
+        for (const auto &[storeKey, entry] : index.removed()) {
+            auto &locations = entry.meta ? _meta : _data;
+            auto writerIt = locations.find(entry.writer);
+            if (writerIt == locations.end()) continue;
+            writerIt->second.erase(entry.key);
+            if (writerIt->second.empty()) locations.erase(writerIt);
+        }
+    }
+}
+
+void LSMIORestartReader::_dropStore(size_t store) {
+    for (auto *locations : {&_data, &_meta}) {
+        for (auto writerIt = locations->begin(); writerIt != locations->end();) {
+            auto &keys = writerIt->second;
+            for (auto keyIt = keys.begin(); keyIt != keys.end();) {
+                keyIt = (keyIt->second.store == store) ? keys.erase(keyIt) : std::next(keyIt);
+            }
+            writerIt = keys.empty() ? locations->erase(writerIt) : std::next(writerIt);
+        }
+    }
+}
+
+void LSMIORestartReader::refresh() {
+    for (auto &info : _stores) {
+        if (info.store) info.store->refresh();
+    }
+    _loadIndices();
+}
+
+LSMIORestartReader::~LSMIORestartReader() {
+    close();
+}
+
+void LSMIORestartReader::close() {
+    for (auto &info : _stores) {
+        if (info.store) {
+            info.store->close();
+            delete info.store;
+            info.store = nullptr;
+        }
+    }
+}
+
+LSMIOStore *LSMIORestartReader::_openStore(StoreInfo &info) {
+    auto openBackend = [&info](const std::string &path) -> LSMIOStore * {
+        switch (info.storageType) {
+            case StorageType::NativeDB:
+                return new LSMIOStoreNative(path, false, true);
+            case StorageType::RocksDB:
+                return new LSMIOStoreRDB(path, false);
+            case StorageType::LevelDB:
+                return new LSMIOStoreLDB(path, false);
+        }
+        return nullptr;
+    };
+
+    if (info.shards <= 1) {
+        return openBackend(info.path);
+    }
+
+    std::vector<LSMIOStore *> shards;
+    for (int i = 0; i < info.shards; i++) {
+        shards.push_back(openBackend(info.path + "." + std::to_string(i)));
+    }
+
+    return new LSMIOStoreSharded(info.path, shards, info.byRank);
+}
+
+std::vector<int> LSMIORestartReader::writers() const {
+    std::vector<int> ranks;
+    for (const auto &locations : {&_data, &_meta}) {
+        for (const auto &[writer, keys] : *locations) ranks.push_back(writer);
+    }
+    std::sort(ranks.begin(), ranks.end());
+    ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+    return ranks;
+}
+
+bool LSMIORestartReader::sharedReads() const {
+    if (_stores.empty()) return false;
+    for (const auto &info : _stores) {
+        if (info.storageType != StorageType::NativeDB) return false;
+    }
+    return true;
+}
+
+bool LSMIORestartReader::keys(int writer, std::vector<std::string> *values) const {
+    auto it = _data.find(writer);
+    if (it == _data.end()) return false;
+    for (const auto &[key, location] : it->second) values->push_back(key);
+    return true;
+}
+
+bool LSMIORestartReader::metaKeys(int writer, std::vector<std::string> *values) const {
+    auto it = _meta.find(writer);
+    if (it == _meta.end()) return false;
+    for (const auto &[key, location] : it->second) values->push_back(key);
+    return true;
+}
+
+bool LSMIORestartReader::_get(const std::map<int, std::map<std::string, Location>> &locations,
+                              int writer, const std::string &key, std::string *value) {
+    auto writerIt = locations.find(writer);
+    if (writerIt == locations.end()) return false;
+
+    auto keyIt = writerIt->second.find(key);
+    if (keyIt == writerIt->second.end()) return false;
+
+    StoreInfo &info = _stores[keyIt->second.store];
+    if (!info.store) {
+        info.store = _openStore(info);
+        if (!info.store) return false;
+    }
+
+    return info.store->get(keyIt->second.storeKey, value);
+}
+
+bool LSMIORestartReader::get(int writer, const std::string &key, std::string *value) {
+    return _get(_data, writer, key, value);
+}
+
+bool LSMIORestartReader::metaGet(int writer, const std::string &key, std::string *value) {
+    return _get(_meta, writer, key, value);
+}
+
+bool LSMIORestartReader::getBatch(const std::vector<std::tuple<int, std::string>> &keys,
+                                  std::vector<std::string> *values) {
+    values->assign(keys.size(), std::string());
+
+    // resolve every key first, so each aggregator store is visited once
+    std::vector<std::tuple<size_t, const std::string *, size_t>> lookups;
+    bool found = true;
+    for (size_t i = 0; i < keys.size(); i++) {
+        const auto &[writer, key] = keys[i];
+        auto writerIt = _data.find(writer);
+        if (writerIt == _data.end()) {
+            found = false;
+            continue;
+        }
+        auto keyIt = writerIt->second.find(key);
+        if (keyIt == writerIt->second.end()) {
+            found = false;
+            continue;
+        }
+        lookups.emplace_back(keyIt->second.store, &keyIt->second.storeKey, i);
+    }
+
+    std::sort(lookups.begin(), lookups.end(), [](const auto &a, const auto &b) {
+        if (std::get<0>(a) != std::get<0>(b)) return std::get<0>(a) < std::get<0>(b);
+        return *std::get<1>(a) < *std::get<1>(b);
+    });
+
+    for (const auto &[store, storeKey, index] : lookups) {
+        StoreInfo &info = _stores[store];
+        if (!info.store) info.store = _openStore(info);
+        if (!info.store || !info.store->get(*storeKey, &(*values)[index])) found = false;
+    }
+
+    return found;
+}
+
+}  // namespace lsmio
@@ -0,0 +1,187 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <lsmio/manager/stats.hpp>
+
+namespace lsmio {
+
+size_t LSMIOStats::bucketOf(uint64_t ns) {
+    if (ns < 4) return ns;
+
+    int exp = 63 - __builtin_clzll(ns);
+    size_t sub = (ns >> (exp - 2)) & 3;
+    return std::min<size_t>(4 * (exp - 1) + sub, BUCKETS - 1);
+}
+
+uint64_t LSMIOStats::bucketUpperBound(size_t bucket) {
+    if (bucket < 4) return bucket;
+
+    int exp = bucket / 4 + 1;
+    uint64_t lower = (4 + bucket % 4) << (exp - 2);
+    return lower + (uint64_t{1} << (exp - 2)) - 1;
+}
+
+LSMIOStats::LSMIOStats() {
+    reset();
+}
+
+LSMIOStats::Shard &LSMIOStats::_shard() {
+    static std::atomic<size_t> nextShard{0};
+    thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return _shards[shard];
+}
+
+void LSMIOStats::addWrite(uint64_t bytes) {
+    Shard &shard = _shard();
+    shard.writeBytes.fetch_add(bytes, std::memory_order_relaxed);
+    shard.writeOps.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LSMIOStats::addRead(uint64_t bytes) {
+    Shard &shard = _shard();
+    shard.readBytes.fetch_add(bytes, std::memory_order_relaxed);
+    shard.readOps.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LSMIOStats::record(StatOp op, uint64_t ns) {
+    Histogram &hist = _shard().latency[static_cast<size_t>(op)];
+    hist.buckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+    hist.sumNs.fetch_add(ns, std::memory_order_relaxed);
+
+    uint64_t max = hist.maxNs.load(std::memory_order_relaxed);
+    while (ns > max && !hist.maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+    }
+}
+
+LSMIOStatsSnapshot LSMIOStats::snapshot() const {
+    LSMIOStatsSnapshot snap;
+
+    for (const Shard &shard : _shards) {
+        snap.writeBytes += shard.writeBytes.load(std::memory_order_relaxed);
+        snap.readBytes += shard.readBytes.load(std::memory_order_relaxed);
+        snap.writeOps += shard.writeOps.load(std::memory_order_relaxed);
+        snap.readOps += shard.readOps.load(std::memory_order_relaxed);
+    }
+
+    for (size_t op = 0; op < static_cast<size_t>(StatOp::Count); op++) {
+        uint64_t buckets[BUCKETS] = {0};
+        uint64_t sumNs = 0;
+        LSMIOLatency &latency = snap.latency[op];
+
+        for (const Shard &shard : _shards) {
+            const Histogram &hist = shard.latency[op];
+            for (size_t b = 0; b < BUCKETS; b++) {
+                buckets[b] += hist.buckets[b].load(std::memory_order_relaxed);
+            }
+            sumNs += hist.sumNs.load(std::memory_order_relaxed);
+            latency.maxNs = std::max(latency.maxNs, hist.maxNs.load(std::memory_order_relaxed));
+        }
+
+        for (size_t b = 0; b < BUCKETS; b++) latency.count += buckets[b];
+        if (latency.count == 0) continue;
+        latency.totalNs = sumNs;
+        latency.meanNs = sumNs / latency.count;
+
+        // smallest bucket holding the q-th sample, capped by the largest sample seen
+        auto percentile = [&](double q) {
+            uint64_t rank = static_cast<uint64_t>(q * latency.count);
+            uint64_t seen = 0;
+            for (size_t b = 0; b < BUCKETS; b++) {
+                seen += buckets[b];
+                if (seen > rank) return std::min(bucketUpperBound(b), latency.maxNs);
+            }
+            return latency.maxNs;
+        };
+        latency.p50Ns = percentile(0.50);
+        latency.p99Ns = percentile(0.99);
+        latency.p999Ns = percentile(0.999);
+    }
+
+    return snap;
+}
+
+void LSMIOStats::reset() {
+    for (Shard &shard : _shards) {
+        shard.writeBytes.store(0, std::memory_order_relaxed);
+        shard.readBytes.store(0, std::memory_order_relaxed);
+        shard.writeOps.store(0, std::memory_order_relaxed);
+        shard.readOps.store(0, std::memory_order_relaxed);
+
+        for (Histogram &hist : shard.latency) {
+            for (auto &bucket : hist.buckets) bucket.store(0, std::memory_order_relaxed);
+            hist.sumNs.store(0, std::memory_order_relaxed);
+            hist.maxNs.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+LSMIOStatTimer::LSMIOStatTimer(LSMIOStats *stats, StatOp op) : _stats(stats), _op(op) {
+    if (_stats) _start = std::chrono::steady_clock::now();
+}
+
+LSMIOStatTimer::~LSMIOStatTimer() {
+    if (!_stats) return;
+
+    auto elapsed = std::chrono::steady_clock::now() - _start;
+    _stats->record(_op,
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+std::string to_string(const StatOp v) {
+    std::string sVal;
+
+    switch (v) {
+        case StatOp::Put:
+            sVal = "put";
+            break;
+        case StatOp::Get:
+            sVal = "get";
+            break;
+        case StatOp::Barrier:
+            sVal = "barrier";
+            break;
+        case StatOp::Remote:
+            sVal = "remote";
+            break;
+        case StatOp::Flush:
+            sVal = "flush";
+            break;
+        case StatOp::Stall:
+            sVal = "stall";
+            break;
+        case StatOp::Count:
+            break;
+    }
+
+    return sVal;
+}
+
+}  // namespace lsmio
@@ -30,6 +30,7 @@
 
 #include <iostream>
 #include <lsmio/manager/store/native/file_closer.hpp>
+#include <lsmio/manager/trace.hpp>
 
 namespace lsmio {
 
@@ -73,6 +74,8 @@ void FileCloser::workerLoop() {
             to_close.swap(_pending);
         }
 
+        LSMIOSpan span("fileCloser.close", to_close.size());
+
         for (auto& f : to_close) {
             if (f && f->is_open()) {
                 f->close();
@@ -33,12 +33,14 @@
 #include <fstream>
 #include <iostream>
 #include <lsmio/manager/store/native/sstable_manager.hpp>
+#include <lsmio/manager/trace.hpp>
 
 namespace lsmio {
 
-SSTableManager::SSTableManager(const std::string& dbPath, size_t filePoolSize, size_t preAllocBytes)
+SSTableManager::SSTableManager(const std::string& dbPath, size_t filePoolSize, size_t preAllocBytes,
+                               bool readOnly)
     : _dbPath(dbPath) {
-    recoverState(filePoolSize, preAllocBytes);
+    recoverState(filePoolSize, preAllocBytes, readOnly);
 }
 
 SSTableManager::~SSTableManager() {
@@ -55,6 +57,13 @@ bool SSTableManager::flushMemtable(const Memtable& memtable, std::vector<char>&
         return true;
     }
 
+    if (!_filePool) {
+        std::cerr << "[SSTableManager] ERROR: No file pool to flush into: " << _dbPath
+                  << std::endl;
+        return false;
+    }
+
+    LSMIOSpan span("sstable.flushMemtable", memtable.sizeBytes());
     auto [sstable_path, sst_file_ptr] = _filePool->acquire();
     std::ofstream& sst_file = *sst_file_ptr;
 
@@ -76,6 +85,7 @@ bool SSTableManager::flushMemtable(const Memtable& memtable, std::vector<char>&
     serialization_buffer.reserve(1024 * 64);
 
     const auto& data = memtable.getData();
+    const uint64_t first_offset = sst_file.tellp();
     for (const auto& [key, value] : data) {
         uint64_t current_offset = sst_file.tellp();
         new_index.offsets.emplace_back(key, current_offset);
@@ -83,8 +93,13 @@ bool SSTableManager::flushMemtable(const Memtable& memtable, std::vector<char>&
         uint32_t key_len = static_cast<uint32_t>(key.size());
         uint32_t val_len = static_cast<uint32_t>(value.size());
 
+        // The first key length of a pre-allocated table is written last, see below
+        const uint32_t stored_key_len =
+            (_preAllocated && current_offset == first_offset) ? 0 : key_len;
+
         serialization_buffer.clear();
-        serialization_buffer.append(reinterpret_cast<const char*>(&key_len), sizeof(key_len));
+        serialization_buffer.append(reinterpret_cast<const char*>(&stored_key_len),
+                                    sizeof(stored_key_len));
         serialization_buffer.append(key.data(), key_len);
         serialization_buffer.append(reinterpret_cast<const char*>(&val_len), sizeof(val_len));
         serialization_buffer.append(value.data(), val_len);
@@ -93,6 +108,16 @@ bool SSTableManager::flushMemtable(const Memtable& memtable, std::vector<char>&
     }
 
     sst_file.flush();
+
+    // A reader refreshing the store cannot tell the records of a pre-allocated table from the
+    // zeros behind them by the file size, so the table is published whole: it reads as empty
+    // until its first key length goes in once all records are written
+    if (_preAllocated) {
+        const uint32_t key_len = static_cast<uint32_t>(data.front().first.size());
+        sst_file.seekp(first_offset);
+        sst_file.write(reinterpret_cast<const char*>(&key_len), sizeof(key_len));
+        sst_file.flush();
+    }
     _fileCloser->scheduleClose(std::move(sst_file_ptr));
 
     std::sort(
@@ -113,6 +138,7 @@ bool SSTableManager::flushMemtable(const Memtable& memtable, std::vector<char>&
     newNode->next = _head.load(std::memory_order_relaxed);
     while (!_head.compare_exchange_weak(newNode->next, newNode, std::memory_order_release,
                                         std::memory_order_relaxed));
+    _table_count.fetch_add(1, std::memory_order_relaxed);
     return true;
 }
 
@@ -212,78 +238,125 @@ bool SSTableManager::readValueAt(const std::string& sstable_path, uint64_t offse
     return true;
 }
 
-void SSTableManager::recoverState(size_t filePoolSize, size_t preAllocBytes) {
-    uint64_t max_id = 0;
-
-    if (std::filesystem::exists(_dbPath)) {
-        std::vector<std::pair<uint64_t, std::string>> found_files;
-        for (const auto& entry : std::filesystem::directory_iterator(_dbPath)) {
-            std::string filename = entry.path().filename().string();
-            if (filename.rfind("L0-", 0) == 0 && filename.rfind(".sst") == filename.size() - 4) {
-                try {
-                    uint64_t id = std::stoull(filename.substr(3, filename.size() - 7));
-                    found_files.push_back({id, entry.path().string()});
-                    if (id > max_id) max_id = id;
-                } catch (...) {
-                }
+std::vector<std::pair<uint64_t, std::string>> SSTableManager::listTables() const {
+    std::vector<std::pair<uint64_t, std::string>> found_files;
+    if (!std::filesystem::exists(_dbPath)) return found_files;
+
+    for (const auto& entry : std::filesystem::directory_iterator(_dbPath)) {
+        std::string filename = entry.path().filename().string();
+        if (filename.rfind("L0-", 0) == 0 && filename.rfind(".sst") == filename.size() - 4) {
+            try {
+                uint64_t id = std::stoull(filename.substr(3, filename.size() - 7));
+                found_files.push_back({id, entry.path().string()});
+            } catch (...) {
             }
         }
+    }
 
-        // Sort files by ID (Oldest to Newest)
-        std::sort(found_files.begin(), found_files.end());
-        std::cout << "[NATIVE] Recovering state. Indexing " << found_files.size() << " SSTables..."
-                  << std::endl;
+    // Sort files by ID (Oldest to Newest)
+    std::sort(found_files.begin(), found_files.end());
+    return found_files;
+}
 
-        for (const auto& [id, path] : found_files) {
-            L0Index new_index;
-            new_index.path = path;
+uint64_t SSTableManager::indexTable(const std::string& path, uint64_t offset, L0Index& index) {
+    std::error_code ec;
+    const uint64_t size = std::filesystem::file_size(path, ec);
+    std::ifstream sst_file(path, std::ios::binary);
+    if (ec || !sst_file) return offset;
 
-            std::ifstream sst_file(path, std::ios::binary);
-            if (sst_file) {
-                while (sst_file.peek() != EOF) {
-                    uint64_t current_offset = sst_file.tellg();
+    sst_file.seekg(offset);
+    while (sst_file.peek() != EOF) {
+        uint64_t current_offset = sst_file.tellg();
+
+        // Keys are never empty: zeros are the unwritten tail of a pre-allocated file
+        uint32_t key_len;
+        sst_file.read(reinterpret_cast<char*>(&key_len), sizeof(key_len));
+        if (sst_file.fail() || key_len == 0) break;
+
+        std::string key(key_len, '\0');
+        sst_file.read(&key[0], key_len);
+        if (sst_file.fail()) break;
+
+        uint32_t val_len;
+        sst_file.read(reinterpret_cast<char*>(&val_len), sizeof(val_len));
+        if (sst_file.fail()) break;
+
+        // A record still being written is left for the next refresh; pre-allocated tables
+        // are only readable once complete, see flushMemtable
+        uint64_t end = current_offset + 2 * sizeof(uint32_t) + key_len + val_len;
+        if (end > size) break;
+
+        sst_file.seekg(val_len, std::ios::cur);  // Skip value
+        index.offsets.emplace_back(key, current_offset);
+        offset = end;
+    }
 
-                    uint32_t key_len;
-                    sst_file.read(reinterpret_cast<char*>(&key_len), sizeof(key_len));
-                    if (sst_file.fail()) break;
+    return offset;
+}
 
-                    std::string key(key_len, '\0');
-                    sst_file.read(&key[0], key_len);
-                    if (sst_file.fail()) break;
+void SSTableManager::prependIndex(L0Index&& index) {
+    std::sort(index.offsets.begin(), index.offsets.end(),
+              [](const std::pair<std::string, uint64_t>& a,
+                 const std::pair<std::string, uint64_t>& b) {
+                  if (a.first != b.first) return a.first < b.first;
+                  return a.second > b.second;
+              });
+
+    auto last = std::unique(index.offsets.begin(), index.offsets.end(),
+                            [](const std::pair<std::string, uint64_t>& a,
+                               const std::pair<std::string, uint64_t>& b) {
+                                return a.first == b.first;
+                            });
+    index.offsets.erase(last, index.offsets.end());
+
+    IndexNode* newNode = new IndexNode(std::move(index));
+    newNode->next = _head.load(std::memory_order_relaxed);
+    while (!_head.compare_exchange_weak(newNode->next, newNode, std::memory_order_release,
+                                        std::memory_order_relaxed));
+    _table_count.fetch_add(1, std::memory_order_relaxed);
+}
 
-                    uint32_t val_len;
-                    sst_file.read(reinterpret_cast<char*>(&val_len), sizeof(val_len));
-                    if (sst_file.fail()) break;
+bool SSTableManager::refresh() {
+    // Tables are written oldest to newest, so indexing them in ID order keeps the newest
+    // records at the head of the list
+    for (const auto& [id, path] : listTables()) {
+        uint64_t& indexed = _indexed[path];
 
-                    sst_file.seekg(val_len, std::ios::cur);  // Skip value
+        L0Index new_index;
+        new_index.path = path;
+        indexed = indexTable(path, indexed, new_index);
+        if (!new_index.offsets.empty()) prependIndex(std::move(new_index));
+    }
+    return true;
+}
 
-                    new_index.offsets.emplace_back(key, current_offset);
-                }
-            }
+void SSTableManager::recoverState(size_t filePoolSize, size_t preAllocBytes, bool readOnly) {
+    uint64_t max_id = 0;
 
-            std::sort(new_index.offsets.begin(), new_index.offsets.end(),
-                      [](const std::pair<std::string, uint64_t>& a,
-                         const std::pair<std::string, uint64_t>& b) {
-                          if (a.first != b.first) return a.first < b.first;
-                          return a.second > b.second;
-                      });
-
-            auto last = std::unique(
-                new_index.offsets.begin(), new_index.offsets.end(),
-                [](const std::pair<std::string, uint64_t>& a,
-                   const std::pair<std::string, uint64_t>& b) { return a.first == b.first; });
-            new_index.offsets.erase(last, new_index.offsets.end());
-
-            // Prepend during recovery to maintain newest-to-oldest order
-            // Since we iterate found_files Oldest -> Newest, prepending each results in Newest at
-            // head.
-            IndexNode* newNode = new IndexNode(std::move(new_index));
-            newNode->next = _head.load(std::memory_order_relaxed);
-            _head.store(newNode, std::memory_order_relaxed);
+    if (std::filesystem::exists(_dbPath)) {
+        std::vector<std::pair<uint64_t, std::string>> found_files = listTables();
+        std::cout << "[NATIVE] Recovering state. Indexing " << found_files.size() << " SSTables..."
+                  << std::endl;
+
+        // Prepend during recovery to maintain newest-to-oldest order
+        // Since we iterate found_files Oldest -> Newest, prepending each results in Newest at
+        // head.
+        for (const auto& [id, path] : found_files) {
+            L0Index new_index;
+            new_index.path = path;
+            _indexed[path] = indexTable(path, 0, new_index);
+            prependIndex(std::move(new_index));
+            if (id > max_id) max_id = id;
         }
         std::cout << "[NATIVE] Recovery complete." << std::endl;
     }
 
+    if (readOnly) {
+        return;
+    }
+
+    _preAllocated = preAllocBytes > 0;
+
     _filePool =
         std::make_unique<FilePool>(_dbPath, "L0-", ".sst", filePoolSize, max_id + 1, preAllocBytes);
     _fileCloser = std::make_unique<FileCloser>(filePoolSize);
@@ -46,6 +46,7 @@
 #include <iomanip>
 #include <iostream>
 #include <lsmio/manager/store/native/store_native.hpp>
+#include <lsmio/manager/trace.hpp>
 #include <map>
 #include <mutex>
 #include <set>
@@ -64,14 +65,23 @@
 
 namespace lsmio {
 
-LSMIOStoreNative::LSMIOStoreNative(const std::string& dbPath, const bool overWrite)
+LSMIOStoreNative::LSMIOStoreNative(const std::string& dbPath, const bool overWrite,
+                                   const bool readOnly)
     : LSMIOStore(dbPath, overWrite),
       _memtable_max_size_bytes(gConfigLSMIO.writeBufferSize > 0 ? gConfigLSMIO.writeBufferSize
                                                                 : 32 * 1024 * 1024),
       _max_immutable_memtables(gConfigLSMIO.writeBufferNumber > 0 ? gConfigLSMIO.writeBufferNumber
                                                                   : 4),  // Default 4
+      _read_only(readOnly),
       _active_memtable(std::make_unique<Memtable>()),
-      _flush_buffer(_memtable_max_size_bytes) {
+      _flush_buffer(readOnly ? 0 : _memtable_max_size_bytes) {
+    if (_read_only) {
+        // Index the existing SSTables only: no directories, file pool or flush thread
+        _sstable_manager = std::make_unique<SSTableManager>(_dbPath, 0, 0, true);
+        _shutting_down = false;
+        return;
+    }
+
     // Ensure database directory exists
     if (overWrite) {
         std::filesystem::remove_all(_dbPath);
@@ -184,6 +194,7 @@ void LSMIOStoreNative::FlushWorkLoop() {
         _backpressure_cv.notify_all();
 
         if (memtable_to_flush) {
+            LSMIOSpan span("native.flushWork", memtable_to_flush->sizeBytes());
             try {
                 FlushMemtableToL0(std::move(memtable_to_flush));
             } catch (const std::exception& e) {
@@ -206,6 +217,8 @@ void LSMIOStoreNative::FlushMemtableToL0(std::unique_ptr<Memtable> memtable) {
         return;
     }
 
+    LSMIOStatTimer timer(_stats, StatOp::Flush);
+
     // Delegate to SSTableManager
     // We pass _flush_buffer for reuse
     _sstable_manager->flushMemtable(*memtable, _flush_buffer);
@@ -221,12 +234,19 @@ bool LSMIOStoreNative::stopBatch() {
 
 bool LSMIOStoreNative::_batchMutation(MutationType mType, const std::string key,
                                       const std::string value, bool flush) {
+    if (_read_only) {
+        LOG(ERROR) << "LSMIOStoreNative::_batchMutation: read-only store: " << _dbPath
+                   << std::endl;
+        return false;
+    }
+
     std::string actual_value = value;
     if (mType == MutationType::Del) {
         actual_value = MEMTABLE_TOMBSTONE;
     }
 
     size_t entry_size = key.size() + actual_value.size();
+    LSMIOSpan span("native.batchMutation", entry_size);
 
     std::unique_lock<std::mutex> lock(_state_mutex);
 
@@ -235,6 +255,8 @@ bool LSMIOStoreNative::_batchMutation(MutationType mType, const std::string key,
         _active_memtable->sizeBytes() > 0) {
         // --- 2. Apply Backpressure ---
         if (_immutable_memtables.size() >= _max_immutable_memtables) {
+            LSMIOSpan stall("native.backpressure", entry_size);
+            LSMIOStatTimer stallTimer(_stats, StatOp::Stall);
             _backpressure_cv.wait(
                 lock, [this] { return _immutable_memtables.size() < _max_immutable_memtables; });
         }
@@ -351,4 +373,29 @@ bool LSMIOStoreNative::writeBarrier() {
     return true;
 }
 
+void LSMIOStoreNative::addGauges(LSMIOStoreGauges* gauges) {
+    {
+        std::unique_lock<std::mutex> lock(_state_mutex);
+        if (_active_memtable) gauges->memtableBytes += _active_memtable->sizeBytes();
+        gauges->immutableMemtables += _immutable_memtables.size();
+    }
+
+    if (_sstable_manager) gauges->sstables += _sstable_manager->tableCount();
+}
+
+bool LSMIOStoreNative::refresh() {
+    // only a read-only store can be written by someone else
+    if (!_read_only || !_sstable_manager) return true;
+    return _sstable_manager->refresh();
+}
+
+bool LSMIOStoreNative::waitForCapacity() {
+    std::unique_lock<std::mutex> lock(_state_mutex);
+    _backpressure_cv.wait(lock, [this] {
+        return _shutting_down.load() || _immutable_memtables.size() < _max_immutable_memtables;
+    });
+
+    return true;
+}
+
 }  // namespace lsmio
@@ -48,6 +48,15 @@ std::string getMutationType(MutationType mType) {
     return sVal;
 }
 
+uint64_t hashStoreKey(const std::string& key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
 LSMIOStore::LSMIOStore(const std::string& dbPath, const bool overWrite) {
     _dbPath = dbPath;
     _maxBatchSize = gConfigLSMIO.asyncBatchSize;
@@ -57,36 +66,24 @@ LSMIOStore::LSMIOStore(const std::string& dbPath, const bool overWrite) {
 LSMIOStore::~LSMIOStore() {}
 
 bool LSMIOStore::metaGet(const std::string key, std::string* value) {
-    LOG(INFO) << "LSMIOStore::metaGet: " << std::endl;
     return get(_metaPrefix + key, value);
 }
 
 bool LSMIOStore::metaGetAll(std::vector<std::tuple<std::string, std::string>>* values,
                             std::string inFix) {
-    LOG(INFO) << "LSMIOStore::metaGetAll: " << std::endl;
     std::string prefix = _metaPrefix + (inFix.empty() ? "" : inFix);
     return getPrefix(prefix, values);
 }
 
 bool LSMIOStore::metaPut(const std::string key, const std::string value, bool flush) {
-    LOG(INFO) << "LSMIOStore::metaPut: " << std::endl;
     return put(_metaPrefix + key, value, flush);
 }
 
 bool LSMIOStore::put(const std::string key, const std::string value, bool flush) {
-    bool retValue;
-
-    LOG(INFO) << "LSMIOStore::put: key: " << key << " flush: " << flush << " size: " << value.size()
-              << std::endl;
-
     return _batchMutation(MutationType::Put, key, value, flush);
 }
 
 bool LSMIOStore::del(const std::string key, bool flush) {
-    bool retValue;
-
-    LOG(INFO) << "LSMIOStore::del: key: " << key << " flush: " << flush << std::endl;
-
     return _batchMutation(MutationType::Del, key, "", flush);
 }
 
@@ -98,4 +95,8 @@ bool LSMIOStore::writeBarrier() {
     return true;
 }
 
+bool LSMIOStore::waitForCapacity() {
+    return true;
+}
+
 }  // namespace lsmio
@@ -0,0 +1,390 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <lsmio/manager/store/store_forward.hpp>
+#include <stdexcept>
+
+namespace lsmio {
+
+namespace {
+
+void appendU32(std::string& out, uint32_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+void appendU64(std::string& out, uint64_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+void appendEntry(std::string& out, MutationType type, const std::string& key,
+                 const std::string& value) {
+    out.push_back(static_cast<char>(type));
+    appendU32(out, key.size());
+    out.append(key);
+    appendU64(out, value.size());
+    out.append(value);
+}
+
+bool readEntry(const std::string& in, size_t* pos, MutationType* type, std::string* key,
+               std::string* value) {
+    uint32_t keyLen;
+    uint64_t valLen;
+
+    if (*pos + 1 + sizeof(keyLen) > in.size()) return false;
+    *type = static_cast<MutationType>(in[*pos]);
+    std::memcpy(&keyLen, in.data() + *pos + 1, sizeof(keyLen));
+    *pos += 1 + sizeof(keyLen);
+
+    if (*pos + keyLen + sizeof(valLen) > in.size()) return false;
+    key->assign(in, *pos, keyLen);
+    std::memcpy(&valLen, in.data() + *pos + keyLen, sizeof(valLen));
+    *pos += keyLen + sizeof(valLen);
+
+    if (*pos + valLen > in.size()) return false;
+    value->assign(in, *pos, valLen);
+    *pos += valLen;
+
+    return true;
+}
+
+}  // namespace
+
+LSMIOStoreForward::LSMIOStoreForward(const std::string& dbPath, MPI_Comm comm, int writers,
+                                     LSMIOStore* partition)
+    : LSMIOStore(dbPath, false) {
+    _comm = comm;
+    MPI_Comm_rank(_comm, &_rank);
+    MPI_Comm_size(_comm, &_size);
+
+    _writers = std::max(1, std::min(writers, _size));
+    _nodePrefix = std::to_string(_rank) + "/";
+    _partition = partition;
+
+    _runs.resize(_writers);
+    _runBytes.assign(_writers, 0);
+
+    LOG(INFO) << "LSMIOStoreForward::LSMIOStoreForward: leader: " << _rank << "/" << _size
+              << " writers: " << _writers << std::endl;
+
+    if (_rank < _writers) {
+        if (!_partition) {
+            throw std::invalid_argument(
+                "ERROR: LSMIOStoreForward::LSMIOStoreForward: writer without a partition store.");
+        }
+        _writerThread = std::thread(&LSMIOStoreForward::_serveWriter, this);
+    }
+}
+
+LSMIOStoreForward::~LSMIOStoreForward() {
+    close();
+}
+
+void LSMIOStoreForward::close() {
+    LOG(INFO) << "LSMIOStoreForward::close(): cleaning up." << std::endl;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_isClosed) return;
+        _isClosed = true;
+
+        for (int writer = 0; writer < _writers; writer++) {
+            _forwardRun(writer, false);
+        }
+
+        const char end = static_cast<char>(ForwardOp::End);
+        for (int writer = 0; writer < _writers; writer++) {
+            MPI_Send(&end, 1, MPI_BYTE, writer, FORWARD_TAG_REQUEST, _comm);
+        }
+    }
+
+    if (_writerThread.joinable()) {
+        _writerThread.join();
+    }
+
+    if (_partition) {
+        _partition->close();
+        delete _partition;
+        _partition = nullptr;
+    }
+}
+
+int LSMIOStoreForward::_writerOf(const std::string& key) const {
+    return hashStoreKey(key) % _writers;
+}
+
+bool LSMIOStoreForward::_forwardRun(int writer, bool flush) {
+    std::map<std::string, ForwardRecord>& run = _runs[writer];
+    if (run.empty()) return true;
+
+    std::string request;
+    request.reserve(_runBytes[writer] + run.size() * 13 + 2);
+    request.push_back(static_cast<char>(ForwardOp::Batch));
+    request.push_back(flush ? 1 : 0);
+
+    for (const auto& [key, record] : run) {
+        appendEntry(request, record.type, key, record.value);
+    }
+
+    LOG(INFO) << "LSMIOStoreForward::_forwardRun: writer: " << writer << " count: " << run.size()
+              << " bytes: " << request.size() << std::endl;
+
+    run.clear();
+    _runBytes[writer] = 0;
+
+    int rc = MPI_Send(request.data(), request.size(), MPI_BYTE, writer, FORWARD_TAG_REQUEST, _comm);
+    return rc == MPI_SUCCESS;
+}
+
+bool LSMIOStoreForward::_request(int writer, const std::string& request, std::string* reply) {
+    MPI_Status status;
+    int count;
+
+    if (MPI_Send(request.data(), request.size(), MPI_BYTE, writer, FORWARD_TAG_REQUEST, _comm) !=
+        MPI_SUCCESS) {
+        return false;
+    }
+
+    MPI_Probe(writer, FORWARD_TAG_REPLY, _comm, &status);
+    MPI_Get_count(&status, MPI_BYTE, &count);
+
+    reply->resize(count);
+    int rc = MPI_Recv(reply->data(), count, MPI_BYTE, writer, FORWARD_TAG_REPLY, _comm,
+                      MPI_STATUS_IGNORE);
+    return rc == MPI_SUCCESS;
+}
+
+bool LSMIOStoreForward::_barrier(ForwardOp op) {
+    bool retValue = true;
+    std::string request(1, static_cast<char>(op));
+    std::string reply;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (int writer = 0; writer < _writers; writer++) {
+        retValue &= _forwardRun(writer, false);
+    }
+
+    for (int writer = 0; writer < _writers; writer++) {
+        bool ok = _request(writer, request, &reply);
+        retValue &= ok && !reply.empty() && reply[0];
+    }
+
+    return retValue;
+}
+
+bool LSMIOStoreForward::startBatch() {
+    return true;
+}
+
+bool LSMIOStoreForward::stopBatch() {
+    bool retValue = true;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (int writer = 0; writer < _writers; writer++) {
+        retValue &= _forwardRun(writer, false);
+    }
+
+    return retValue;
+}
+
+bool LSMIOStoreForward::_batchMutation(MutationType mType, const std::string key,
+                                       const std::string value, bool flush) {
+    std::string fKey = _nodePrefix + key;
+    int writer = _writerOf(fKey);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    std::map<std::string, ForwardRecord>& run = _runs[writer];
+
+    auto it = run.find(fKey);
+    if (it != run.end()) {
+        _runBytes[writer] -= it->first.size() + it->second.value.size();
+    }
+
+    run[fKey] = ForwardRecord{mType, value};
+    _runBytes[writer] += fKey.size() + value.size();
+
+    if (flush || _runBytes[writer] >= static_cast<uint64_t>(gConfigLSMIO.forwardBatchBytes)) {
+        return _forwardRun(writer, flush);
+    }
+
+    return true;
+}
+
+bool LSMIOStoreForward::dbCleanup() {
+    // the partition stores clean themselves up on open
+    return true;
+}
+
+bool LSMIOStoreForward::get(const std::string key, std::string* value) {
+    std::string fKey = _nodePrefix + key;
+    int writer = _writerOf(fKey);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // read-your-writes for mutations that have not been forwarded yet
+    auto it = _runs[writer].find(fKey);
+    if (it != _runs[writer].end()) {
+        if (it->second.type == MutationType::Del) return false;
+        *value = it->second.value;
+        return true;
+    }
+
+    std::string request(1, static_cast<char>(ForwardOp::Get));
+    request.append(fKey);
+
+    std::string reply;
+    if (!_request(writer, request, &reply) || reply.empty() || !reply[0]) return false;
+
+    value->assign(reply, 1, std::string::npos);
+    return true;
+}
+
+bool LSMIOStoreForward::getPrefix(const std::string key,
+                                  std::vector<std::tuple<std::string, std::string>>* values) {
+    std::string request(1, static_cast<char>(ForwardOp::Scan));
+    request.append(_nodePrefix + key);
+
+    LOG(INFO) << "LSMIOStoreForward::getPrefix(): key: " << key << std::endl;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (int writer = 0; writer < _writers; writer++) {
+        _forwardRun(writer, false);
+    }
+
+    // keys of a prefix are spread over all partitions, merge them back in order
+    std::map<std::string, std::string> results;
+    for (int writer = 0; writer < _writers; writer++) {
+        std::string reply;
+        if (!_request(writer, request, &reply)) return false;
+
+        size_t pos = 0;
+        MutationType type;
+        std::string rKey, rValue;
+        while (readEntry(reply, &pos, &type, &rKey, &rValue)) {
+            results[rKey.substr(_nodePrefix.size())] = std::move(rValue);
+        }
+    }
+
+    for (auto& [rKey, rValue] : results) {
+        values->emplace_back(rKey, std::move(rValue));
+    }
+
+    return true;
+}
+
+void LSMIOStoreForward::setStats(LSMIOStats* stats) {
+    _stats = stats;
+    if (_partition) _partition->setStats(stats);
+}
+
+void LSMIOStoreForward::addGauges(LSMIOStoreGauges* gauges) {
+    if (_partition) _partition->addGauges(gauges);
+}
+
+bool LSMIOStoreForward::readBarrier() {
+    LOG(INFO) << "LSMIOStoreForward::readBarrier: " << std::endl;
+    return _barrier(ForwardOp::ReadBarrier);
+}
+
+bool LSMIOStoreForward::writeBarrier() {
+    LOG(INFO) << "LSMIOStoreForward::writeBarrier: " << std::endl;
+    return _barrier(ForwardOp::WriteBarrier);
+}
+
+void LSMIOStoreForward::_serveWriter() {
+    int ended = 0;
+
+    LOG(INFO) << "LSMIOStoreForward::_serveWriter: partition: " << _rank << std::endl;
+
+    while (ended < _size) {
+        MPI_Status status;
+        int count;
+
+        MPI_Probe(MPI_ANY_SOURCE, FORWARD_TAG_REQUEST, _comm, &status);
+        MPI_Get_count(&status, MPI_BYTE, &count);
+
+        std::string request(count, '\0');
+        MPI_Recv(request.data(), count, MPI_BYTE, status.MPI_SOURCE, FORWARD_TAG_REQUEST, _comm,
+                 MPI_STATUS_IGNORE);
+        if (request.empty()) continue;
+
+        std::string reply;
+        ForwardOp op = static_cast<ForwardOp>(request[0]);
+
+        switch (op) {
+            case ForwardOp::Batch: {
+                bool flush = request.size() > 1 && request[1];
+                size_t pos = 2;
+                MutationType type;
+                std::string key, value;
+                while (readEntry(request, &pos, &type, &key, &value)) {
+                    if (type == MutationType::Del) {
+                        _partition->del(key, flush);
+                    } else {
+                        _partition->put(key, value, flush);
+                    }
+                }
+                continue;
+            }
+            case ForwardOp::Get: {
+                std::string value;
+                bool found = _partition->get(request.substr(1), &value);
+                reply.push_back(found ? 1 : 0);
+                if (found) reply.append(value);
+                break;
+            }
+            case ForwardOp::Scan: {
+                std::vector<std::tuple<std::string, std::string>> values;
+                _partition->getPrefix(request.substr(1), &values);
+                for (const auto& [key, value] : values) {
+                    appendEntry(reply, MutationType::Put, key, value);
+                }
+                break;
+            }
+            case ForwardOp::ReadBarrier:
+                reply.push_back(_partition->readBarrier() ? 1 : 0);
+                break;
+            case ForwardOp::WriteBarrier:
+                reply.push_back(_partition->writeBarrier() ? 1 : 0);
+                break;
+            case ForwardOp::End:
+                ended++;
+                continue;
+        }
+
+        MPI_Send(reply.data(), reply.size(), MPI_BYTE, status.MPI_SOURCE, FORWARD_TAG_REPLY,
+                 _comm);
+    }
+
+    LOG(INFO) << "LSMIOStoreForward::_serveWriter: all leaders done." << std::endl;
+}
+
+}  // namespace lsmio
@@ -35,6 +35,7 @@
 #include <filesystem>
 #include <iostream>
 #include <lsmio/manager/store/store_ldb.hpp>
+#include <lsmio/manager/trace.hpp>
 
 namespace lsmio {
 
@@ -124,8 +125,8 @@ void LSMIOStoreLDB::close() {
 bool LSMIOStoreLDB::get(const std::string key, std::string *value) {
     leveldb::Status s;
 
-    LOG(INFO) << "LSMIOStoreLDB::get(): key: " << key << std::endl;
     s = _db->Get(_rOptions, key, value);
+    LSMIO_TRACE(StoreGet, value->size());
     return s.ok();
 }
 
@@ -133,7 +134,7 @@ bool LSMIOStoreLDB::getPrefix(const std::string key,
                               std::vector<std::tuple<std::string, std::string>> *values) {
     leveldb::Status s;
 
-    LOG(INFO) << "LSMIOStoreLDB::getPrefix(): key: " << key << std::endl;
+    LSMIO_TRACE(StoreGetPrefix, key.size());
     leveldb::Iterator *it = _db->NewIterator(_rOptions);
 
     it->Seek(key);
@@ -157,15 +158,11 @@ bool LSMIOStoreLDB::_batchMutation(MutationType mType, const std::string key,
     const unsigned int futureSize = _batchSize + 1;
     const unsigned int futureBytes = _batchBytes + value.size();
 
-    LOG(INFO) << "LSMIOStoreLDB::_batchMutation: key: " << key << " flush: " << flush
-              << " size: " << value.size() << " futureSize: " << futureSize
-              << " futureBytes: " << futureBytes << std::endl;
+    LSMIO_TRACE2(StoreMutation, value.size(), static_cast<uint32_t>(mType));
 
     if (flush || value.size() >= _maxBatchSize) {
         if (_batch) stopBatch();
 
-        LOG(INFO) << "LSMIOStoreLDB::_batchMutation: mutation: " << getMutationType(mType)
-                  << std::endl;
         if (mType == MutationType::Put) {
             s = _db->Put(_wOptions, key, value);
         } else if (mType == MutationType::Del) {
@@ -180,8 +177,6 @@ bool LSMIOStoreLDB::_batchMutation(MutationType mType, const std::string key,
             stopBatch();
         }
 
-        LOG(INFO) << "LSMIOStoreLDB::_batchMutation: mutation: batch::" << getMutationType(mType)
-                  << std::endl;
         {
             std::lock_guard<std::mutex> lg(_batchMutex);
 
@@ -196,7 +191,6 @@ bool LSMIOStoreLDB::_batchMutation(MutationType mType, const std::string key,
             }
         }
 
-        LOG(INFO) << "LSMIOStoreLDB::_batchMutation: mutation: update counters: " << std::endl;
         _batchSize++;
         _batchBytes.fetch_add(value.size());
 
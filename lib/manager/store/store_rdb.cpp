@@ -40,6 +40,7 @@
 #include <filesystem>
 #include <iostream>
 #include <lsmio/manager/store/store_rdb.hpp>
+#include <lsmio/manager/trace.hpp>
 
 namespace lsmio {
 
@@ -153,8 +154,8 @@ void LSMIOStoreRDB::close() {
 bool LSMIOStoreRDB::get(const std::string key, std::string* value) {
     rocksdb::Status s;
 
-    LOG(INFO) << "LSMIOStoreRDB::get(): key: " << key << std::endl;
     s = _db->Get(_rOptions, key, value);
+    LSMIO_TRACE(StoreGet, value->size());
     return s.ok();
 }
 
@@ -162,7 +163,7 @@ bool LSMIOStoreRDB::getPrefix(const std::string key,
                               std::vector<std::tuple<std::string, std::string>>* values) {
     rocksdb::Status s;
 
-    LOG(INFO) << "LSMIOStoreRDB::getPrefix(): key: " << key << std::endl;
+    LSMIO_TRACE(StoreGetPrefix, key.size());
     rocksdb::Iterator* it = _db->NewIterator(_rOptions);
 
     it->Seek(key);
@@ -182,14 +183,8 @@ bool LSMIOStoreRDB::_batchMutation(MutationType mType, const std::string key,
     rocksdb::Status s;
     bool retValue;
 
-    const unsigned int futureSize = _batchSize + 1;
-    const unsigned int futureBytes = _batchBytes + value.size();
+    LSMIO_TRACE2(StoreMutation, value.size(), static_cast<uint32_t>(mType));
 
-    LOG(INFO) << "LSMIOStoreRDB::_batchMutation: key: " << key
-              << " flush (not-applicable): " << flush << " size: " << value.size()
-              << " futureSize: " << futureSize << " futureBytes: " << futureBytes << std::endl;
-
-    LOG(INFO) << "LSMIOStoreRDB::_batchMutation: mutation: " << getMutationType(mType) << std::endl;
     if (mType == MutationType::Put) {
         s = _db->Put(_wOptions, key, value);
     } else if (mType == MutationType::Del) {
@@ -0,0 +1,177 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cctype>
+#include <future>
+#include <iostream>
+#include <lsmio/manager/store/store_sharded.hpp>
+#include <lsmio/manager/trace.hpp>
+#include <map>
+#include <stdexcept>
+
+namespace lsmio {
+
+LSMIOStoreSharded::LSMIOStoreSharded(const std::string& dbPath, std::vector<LSMIOStore*> shards,
+                                     bool byRank)
+    : LSMIOStore(dbPath, false) {
+    if (shards.empty()) {
+        throw std::invalid_argument("ERROR: LSMIOStoreSharded::LSMIOStoreSharded: no shards.");
+    }
+
+    _shards = std::move(shards);
+    _byRank = byRank;
+
+    LOG(INFO) << "LSMIOStoreSharded::LSMIOStoreSharded: " << _dbPath << " shards: "
+              << _shards.size() << " byRank: " << _byRank << std::endl;
+}
+
+LSMIOStoreSharded::~LSMIOStoreSharded() {
+    close();
+}
+
+void LSMIOStoreSharded::close() {
+    LOG(INFO) << "LSMIOStoreSharded::close(): cleaning up." << std::endl;
+    _forAll([](LSMIOStore* shard) {
+        shard->close();
+        return true;
+    });
+
+    for (LSMIOStore* shard : _shards) {
+        delete shard;
+    }
+    _shards.clear();
+}
+
+template <typename F>
+bool LSMIOStoreSharded::_forAll(F func) {
+    if (_shards.size() == 1) return func(_shards[0]);
+
+    // shards flush independently, so wait on all of them at once
+    std::vector<std::future<bool>> results;
+    for (LSMIOStore* shard : _shards) {
+        results.push_back(std::async(std::launch::async, func, shard));
+    }
+
+    bool retValue = true;
+    for (auto& result : results) {
+        retValue &= result.get();
+    }
+    return retValue;
+}
+
+LSMIOStore* LSMIOStoreSharded::_shardOf(const std::string& key) const {
+    if (_byRank) {
+        size_t pos = key.compare(0, _metaPrefix.length(), _metaPrefix) ? 0 : _metaPrefix.length();
+        size_t sep = key.find("::", pos);
+
+        if (sep != std::string::npos && sep > pos && std::isdigit(key[pos])) {
+            return _shards[std::stoul(key.substr(pos, sep - pos)) % _shards.size()];
+        }
+    }
+
+    return _shards[hashStoreKey(key) % _shards.size()];
+}
+
+bool LSMIOStoreSharded::startBatch() {
+    return true;
+}
+
+bool LSMIOStoreSharded::stopBatch() {
+    return true;
+}
+
+bool LSMIOStoreSharded::_batchMutation(MutationType mType, const std::string key,
+                                       const std::string value, bool flush) {
+    LSMIOStore* shard = _shardOf(key);
+
+    if (mType == MutationType::Del) {
+        return shard->del(key, flush);
+    }
+    return shard->put(key, value, flush);
+}
+
+bool LSMIOStoreSharded::dbCleanup() {
+    // the shards clean themselves up on open
+    return true;
+}
+
+bool LSMIOStoreSharded::get(const std::string key, std::string* value) {
+    return _shardOf(key)->get(key, value);
+}
+
+bool LSMIOStoreSharded::getPrefix(const std::string key,
+                                  std::vector<std::tuple<std::string, std::string>>* values) {
+    std::map<std::string, std::string> results;
+
+    LSMIO_TRACE(StoreGetPrefix, key.size());
+    for (LSMIOStore* shard : _shards) {
+        std::vector<std::tuple<std::string, std::string>> shardValues;
+        shard->getPrefix(key, &shardValues);
+
+        for (auto& [sKey, sValue] : shardValues) {
+            results[sKey] = std::move(sValue);
+        }
+    }
+
+    for (auto& [rKey, rValue] : results) {
+        values->emplace_back(rKey, std::move(rValue));
+    }
+
+    return true;
+}
+
+bool LSMIOStoreSharded::readBarrier() {
+    LOG(INFO) << "LSMIOStoreSharded::readBarrier: " << std::endl;
+    return _forAll([](LSMIOStore* shard) { return shard->readBarrier(); });
+}
+
+bool LSMIOStoreSharded::writeBarrier() {
+    LOG(INFO) << "LSMIOStoreSharded::writeBarrier: " << std::endl;
+    return _forAll([](LSMIOStore* shard) { return shard->writeBarrier(); });
+}
+
+bool LSMIOStoreSharded::waitForCapacity() {
+    return _forAll([](LSMIOStore* shard) { return shard->waitForCapacity(); });
+}
+
+bool LSMIOStoreSharded::refresh() {
+    return _forAll([](LSMIOStore* shard) { return shard->refresh(); });
+}
+
+void LSMIOStoreSharded::setStats(LSMIOStats* stats) {
+    _stats = stats;
+    for (auto shard : _shards) shard->setStats(stats);
+}
+
+void LSMIOStoreSharded::addGauges(LSMIOStoreGauges* gauges) {
+    for (auto shard : _shards) shard->addGauges(gauges);
+}
+
+}  // namespace lsmio
@@ -0,0 +1,323 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <lsmio/manager/trace.hpp>
+
+namespace lsmio {
+
+namespace {
+
+uint64_t clockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// raw timestamp: the TSC where available, otherwise steady clock nanoseconds
+uint64_t ticksNow() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return clockNs();
+#endif
+}
+
+struct SpanBuffer {
+    std::mutex mutex;
+    std::vector<SpanRecord> spans;
+    uint64_t dropped = 0;
+    uint64_t thread;
+
+    explicit SpanBuffer(uint64_t t) : thread(t) {}
+};
+
+struct TraceRegistry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<LSMIOTraceRing>> rings;
+    std::vector<std::shared_ptr<SpanBuffer>> spanBuffers;
+    std::atomic<uint64_t> nextThread{0};
+    int rank = 0;
+    // reference point mapping ticks to steady clock nanoseconds
+    uint64_t baseTicks = ticksNow();
+    uint64_t baseNs = clockNs();
+};
+
+TraceRegistry &registry() {
+    static TraceRegistry *reg = new TraceRegistry();
+    return *reg;
+}
+
+// same index for a thread's ring and span buffer
+uint64_t threadIndex() {
+    thread_local uint64_t index = registry().nextThread.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+LSMIOTraceRing &threadRing() {
+    // the registry keeps the ring alive after its thread exits so it can still be dumped
+    thread_local std::shared_ptr<LSMIOTraceRing> ring = [] {
+        TraceRegistry &reg = registry();
+        auto r = std::make_shared<LSMIOTraceRing>(threadIndex());
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.rings.push_back(r);
+        return r;
+    }();
+    return *ring;
+}
+
+SpanBuffer &threadSpans() {
+    thread_local std::shared_ptr<SpanBuffer> buffer = [] {
+        TraceRegistry &reg = registry();
+        auto b = std::make_shared<SpanBuffer>(threadIndex());
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.spanBuffers.push_back(b);
+        return b;
+    }();
+    return *buffer;
+}
+
+std::vector<std::shared_ptr<SpanBuffer>> allSpanBuffers() {
+    TraceRegistry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    return reg.spanBuffers;
+}
+
+// Chrome trace timestamps are microseconds
+void writeMicros(std::ostream &os, uint64_t ns) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%llu.%03llu", static_cast<unsigned long long>(ns / 1000),
+                  static_cast<unsigned long long>(ns % 1000));
+    os << buf;
+}
+
+}  // namespace
+
+size_t LSMIOTraceRing::snapshot(TraceRecord *records) const {
+    uint64_t head = _head.load(std::memory_order_acquire);
+    uint64_t first = head > CAPACITY ? head - CAPACITY : 0;
+
+    for (uint64_t i = first; i < head; i++) {
+        records[i - first] = _records[i & (CAPACITY - 1)];
+    }
+    return head - first;
+}
+
+void LSMIOTrace::record(TraceEvent event, uint64_t arg, uint32_t aux) {
+    threadRing().record(event, arg, aux, ticksNow());
+}
+
+void LSMIOTrace::dump(std::ostream &os) {
+    TraceRegistry &reg = registry();
+    std::vector<std::shared_ptr<LSMIOTraceRing>> rings;
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        rings = reg.rings;
+    }
+
+    // scale ticks to nanoseconds from the span between registry creation and now
+    uint64_t spanTicks = ticksNow() - reg.baseTicks;
+    uint64_t spanNs = clockNs() - reg.baseNs;
+    double nsPerTick = spanTicks ? static_cast<double>(spanNs) / spanTicks : 1.0;
+
+    std::unique_ptr<TraceRecord[]> records(new TraceRecord[LSMIOTraceRing::CAPACITY]);
+    for (const auto &ring : rings) {
+        size_t count = ring->snapshot(records.get());
+        for (size_t i = 0; i < count; i++) {
+            const TraceRecord &r = records[i];
+            double elapsed = static_cast<double>(r.ticks - reg.baseTicks) * nsPerTick;
+            uint64_t ns = reg.baseNs + static_cast<uint64_t>(elapsed);
+            os << ns << " " << ring->thread() << " " << to_string(r.event) << " " << r.arg << " "
+               << r.aux << "\n";
+        }
+    }
+    os.flush();
+}
+
+bool LSMIOTrace::dump(const std::string &filePath) {
+    std::ofstream os(filePath, std::ios::out | std::ios::trunc);
+    if (!os) return false;
+
+    dump(os);
+    return os.good();
+}
+
+std::atomic<bool> LSMIOTrace::_spansEnabled{false};
+
+uint64_t LSMIOTrace::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+void LSMIOTrace::enableSpans(int rank) {
+    registry().rank = rank;
+    _spansEnabled.store(true, std::memory_order_relaxed);
+}
+
+void LSMIOTrace::disableSpans() {
+    _spansEnabled.store(false, std::memory_order_relaxed);
+}
+
+void LSMIOTrace::addSpan(const char *name, uint64_t startNs, uint64_t durationNs, uint64_t arg) {
+    SpanBuffer &buffer = threadSpans();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+
+    if (buffer.spans.size() >= MAX_SPANS) {
+        buffer.dropped++;
+        return;
+    }
+    buffer.spans.push_back(SpanRecord{name, startNs, durationNs, arg});
+}
+
+bool LSMIOTrace::writeSpans(const std::string &filePath) {
+    std::ofstream os(filePath, std::ios::out | std::ios::trunc);
+    if (!os) return false;
+
+    int rank = registry().rank;
+    uint64_t dropped = 0;
+
+    os << "{\"traceEvents\":[\n";
+    os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+       << ",\"args\":{\"name\":\"rank " << rank << "\"}}";
+
+    for (const auto &buffer : allSpanBuffers()) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+
+        for (const SpanRecord &span : buffer->spans) {
+            os << ",\n{\"name\":\"" << span.name << "\",\"cat\":\"lsmio\",\"ph\":\"X\",\"ts\":";
+            writeMicros(os, span.startNs);
+            os << ",\"dur\":";
+            writeMicros(os, span.durationNs);
+            os << ",\"pid\":" << rank << ",\"tid\":" << buffer->thread
+               << ",\"args\":{\"rank\":" << rank << ",\"size\":" << span.arg << "}}";
+        }
+        dropped += buffer->dropped;
+        buffer->spans.clear();
+        buffer->dropped = 0;
+    }
+
+    os << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"rank\":" << rank
+       << ",\"droppedSpans\":" << dropped << "}}\n";
+    os.close();
+
+    return !os.fail();
+}
+
+void LSMIOTrace::clearSpans() {
+    for (const auto &buffer : allSpanBuffers()) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        buffer->spans.clear();
+        buffer->dropped = 0;
+    }
+}
+
+std::string to_string(const TraceEvent v) {
+    std::string sVal;
+
+    switch (v) {
+        case TraceEvent::Put:
+            sVal = "put";
+            break;
+        case TraceEvent::PutBatch:
+            sVal = "putBatch";
+            break;
+        case TraceEvent::Get:
+            sVal = "get";
+            break;
+        case TraceEvent::GetBatch:
+            sVal = "getBatch";
+            break;
+        case TraceEvent::Del:
+            sVal = "del";
+            break;
+        case TraceEvent::MetaPut:
+            sVal = "metaPut";
+            break;
+        case TraceEvent::MetaGet:
+            sVal = "metaGet";
+            break;
+        case TraceEvent::MetaGetAll:
+            sVal = "metaGetAll";
+            break;
+        case TraceEvent::IPut:
+            sVal = "iput";
+            break;
+        case TraceEvent::IGet:
+            sVal = "iget";
+            break;
+        case TraceEvent::ReadBarrier:
+            sVal = "readBarrier";
+            break;
+        case TraceEvent::WriteBarrier:
+            sVal = "writeBarrier";
+            break;
+        case TraceEvent::Serialize:
+            sVal = "serialize";
+            break;
+        case TraceEvent::Deserialize:
+            sVal = "deserialize";
+            break;
+        case TraceEvent::Send:
+            sVal = "send";
+            break;
+        case TraceEvent::Recv:
+            sVal = "recv";
+            break;
+        case TraceEvent::ServerCommand:
+            sVal = "serverCommand";
+            break;
+        case TraceEvent::StoreGet:
+            sVal = "storeGet";
+            break;
+        case TraceEvent::StoreGetPrefix:
+            sVal = "storeGetPrefix";
+            break;
+        case TraceEvent::StoreMutation:
+            sVal = "storeMutation";
+            break;
+        case TraceEvent::Count:
+            break;
+    }
+
+    return sVal;
+}
+
+}  // namespace lsmio
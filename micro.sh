@@ -8,6 +8,8 @@ RUN_PLUGIN=false
 RUN_ROCKSDB=false
 RUN_LEVELDB=false
 RUN_NATIVE=false
+RUN_HIERARCHICAL=false
+NP=8
 TARGETS_SELECTED=false
 
 # Parse arguments
@@ -38,13 +40,22 @@ while [[ $# -gt 0 ]]; do
             TARGETS_SELECTED=true
             shift
             ;;
+        hierarchical)
+            RUN_HIERARCHICAL=true
+            TARGETS_SELECTED=true
+            shift
+            ;;
+        -n|--ranks)
+            NP="$2"
+            shift 2
+            ;;
         -i|--iterations)
             ITER="$2"
             shift 2
             ;;
         *)
             echo "Unknown argument: $1"
-            echo "Usage: $0 [adios] [plugin] [rocksdb] [leveldb] [native] [-i iterations]"
+            echo "Usage: $0 [adios] [plugin] [rocksdb] [leveldb] [native] [hierarchical] [-i iterations] [-n ranks]"
             exit 1
             ;;
     esac
@@ -52,7 +63,7 @@ done
 
 if [ "$TARGETS_SELECTED" = false ]; then
     echo "No benchmarks selected."
-    echo "Usage: $0 [adios] [plugin] [rocksdb] [leveldb] [native] [-i iterations]"
+    echo "Usage: $0 [adios] [plugin] [rocksdb] [leveldb] [native] [hierarchical] [-i iterations] [-n ranks]"
     exit 1
 fi
 
@@ -109,3 +120,25 @@ if [ "$RUN_NATIVE" = true ]; then
         -v -g -o ${BM_DIR}/lsmio-native-m.db \
         --lsmio-ts 1024 --lsmio-bs 1024 --key-count 2048 -i "$ITER"
 fi
+
+if [ "$RUN_HIERARCHICAL" = true ]; then
+    # 2048 x 16K puts per rank through Entire, then Shared and Hierarchical per pseudo-node count
+    echo "Running Manager aggregation benchmark (Entire) on ${NP} ranks..."
+    mpirun -np "$NP" ~/src/usr/bin/bm_manager \
+        -c -w -v -g -o ${BM_DIR}/lsmio-manager-entire.db \
+        --key-count 2048 --value-size 16384 -i "$ITER"
+
+    for NODES in 2 4 8; do
+        echo "Running Manager aggregation benchmark (Shared, ${NODES} nodes) on ${NP} ranks..."
+        mpirun -np "$NP" ~/src/usr/bin/bm_manager \
+            -c -v -g -o ${BM_DIR}/lsmio-manager-shared-${NODES}.db \
+            --lsmio-emulated-nodes "$NODES" \
+            --key-count 2048 --value-size 16384 -i "$ITER"
+
+        echo "Running Manager aggregation benchmark (Hierarchical, ${NODES} nodes) on ${NP} ranks..."
+        mpirun -np "$NP" ~/src/usr/bin/bm_manager \
+            -c -v -g -o ${BM_DIR}/lsmio-manager-hierarchical-${NODES}.db \
+            --lsmio-hierarchical --lsmio-global-writers 1 --lsmio-emulated-nodes "$NODES" \
+            --key-count 2048 --value-size 16384 -i "$ITER"
+    done
+fi
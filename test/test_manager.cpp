@@ -30,6 +30,7 @@
 
 #include <gtest/gtest.h>
 
+#include <filesystem>
 #include <iostream>
 #include <lsmio/manager/manager.hpp>
 
@@ -195,6 +196,36 @@ TEST(lsmioManager, ReOpen_Read) {
     }
 }
 
+TEST(lsmioManager, Sharded) {
+    bool success = true;
+    std::string value;
+
+    std::string dbName = "test-mgr-store-sharded.db";
+    lsmio::gConfigLSMIO.storeShards = 3;
+
+    for (int i = 0; i < 2; i++) {
+        lsmio::LSMIOManager lm(dbName, TEST_DIR_MGR, i == 0);
+
+        for (int k = 0; k < 16; k++) {
+            std::string key = "key-" + std::to_string(k);
+            if (i == 0) {
+                success = lm.put(key, "value-" + std::to_string(k), false);
+                EXPECT_EQ(success, true);
+            } else {
+                success = lm.get(key, &value);
+                EXPECT_EQ(success, true);
+                EXPECT_EQ(value, "value-" + std::to_string(k));
+            }
+        }
+
+        success = lm.writeBarrier();
+        EXPECT_EQ(success, true);
+    }
+
+    EXPECT_TRUE(std::filesystem::exists(dbName + ".2"));
+    lsmio::gConfigLSMIO.storeShards = 1;
+}
+
 int main(int argc, char **argv) {
     lsmio::initLSMIODebug(argv[0]);
     ::testing::InitGoogleTest(&argc, argv);
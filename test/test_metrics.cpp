@@ -0,0 +1,107 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <lsmio/manager/metrics.hpp>
+#include <lsmio/manager/store/native/store_native.hpp>
+#include <sstream>
+#include <thread>
+
+using namespace lsmio;
+
+namespace {
+
+std::string readFile(const std::string &path) {
+    std::ifstream file(path);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+}  // namespace
+
+TEST(MetricsTest, WriteMetric) {
+    std::stringstream ss;
+    LSMIOMetricsExporter::writeMetric(ss, "lsmio_test_total", "counter", "Test counter.",
+                                      "rank=\"0\"", uint64_t{12345678901234});
+    EXPECT_EQ(ss.str(),
+              "# HELP lsmio_test_total Test counter.\n"
+              "# TYPE lsmio_test_total counter\n"
+              "lsmio_test_total{rank=\"0\"} 12345678901234\n");
+
+    EXPECT_EQ(LSMIOMetricsExporter::labelValue("a\"b\\c\nd"), "\"a\\\"b\\\\c\\nd\"");
+}
+
+TEST(MetricsTest, PeriodicExport) {
+    const std::string path = "test-metrics.prom";
+    std::filesystem::remove(path);
+    std::atomic<int> samples{0};
+
+    LSMIOMetricsExporter exporter(path, 10, [&](std::ostream &os) {
+        LSMIOMetricsExporter::writeMetric(os, "lsmio_samples", "gauge", "Samples.", "",
+                                          uint64_t(++samples));
+    });
+
+    while (samples < 3) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    exporter.stop();
+
+    // the final sample is written on stop and the file is always complete
+    int last = samples;
+    EXPECT_EQ(readFile(path), "# HELP lsmio_samples Samples.\n# TYPE lsmio_samples gauge\n"
+                              "lsmio_samples " + std::to_string(last) + "\n");
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+}
+
+TEST(MetricsTest, NativeGauges) {
+    LSMIOStoreNative store("test-metrics-native.db", true);
+
+    LSMIOStoreGauges gauges;
+    store.addGauges(&gauges);
+    EXPECT_EQ(gauges.memtableBytes, 0);
+    EXPECT_EQ(gauges.sstables, 0);
+
+    EXPECT_TRUE(store.put("key", std::string(1000, 'x'), false));
+    gauges = LSMIOStoreGauges();
+    store.addGauges(&gauges);
+    EXPECT_GE(gauges.memtableBytes, 1000);
+
+    EXPECT_TRUE(store.writeBarrier());
+    gauges = LSMIOStoreGauges();
+    store.addGauges(&gauges);
+    EXPECT_EQ(gauges.memtableBytes, 0);
+    EXPECT_EQ(gauges.immutableMemtables, 0);
+    EXPECT_EQ(gauges.sstables, 1);
+
+    store.close();
+}
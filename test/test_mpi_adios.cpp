@@ -179,6 +179,185 @@ TEST_P(adiosMPITests, ReadWrite) {
     EXPECT_EQ(msgWritten, msgRead);
 }
 
+TEST_P(adiosMPITests, GlobalArray) {
+    AdiosEngine engine = std::get<0>(GetParam());
+    MPIWorld worldSize = std::get<1>(GetParam());
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int numProcesses, worldRank;
+    MPI_Comm_size(MPI_COMM_WORLD, &numProcesses);
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    // each rank writes its rows, then reads the rows of every rank
+    const bool isSelf = (worldSize == MPIWorld::Self);
+    const size_t ranks = isSelf ? 1 : numProcesses;
+    const size_t rank = isSelf ? 0 : worldRank;
+    const size_t rows = 8, cols = 16;
+    const std::string m_file = "global-" + getAdiosFile(AdiosEngine::BP5, worldSize, worldRank);
+
+    std::vector<double> values(rows * cols), readValues(ranks * rows * cols);
+    for (size_t i = 0; i < values.size(); i++) values[i] = rank * rows * cols + i;
+
+    adios2::ADIOS adios(isSelf ? MPI_COMM_SELF : MPI_COMM_WORLD);
+    adios2::Params params = genAdiosParams(engine, worldSize, worldRank);
+    if (engine == AdiosEngine::Plugin) params["FileName"] = "global-" + params["FileName"];
+
+    adios2::IO wio = adios.DeclareIO("test-mpi-adios-global-writer");
+    if (engine == AdiosEngine::Plugin) wio.SetEngine("Plugin");
+    wio.SetParameters(params);
+    adios2::Variable<double> wVar =
+        wio.DefineVariable<double>("field", {ranks * rows, cols}, {rank * rows, 0}, {rows, cols});
+    adios2::Engine writer = wio.Open(m_file, adios2::Mode::Write);
+    writer.BeginStep();
+    writer.Put(wVar, values.data());
+    writer.EndStep();
+    writer.Close();
+
+    adios2::IO rio = adios.DeclareIO("test-mpi-adios-global-reader");
+    if (engine == AdiosEngine::Plugin) rio.SetEngine("Plugin");
+    rio.SetParameters(params);
+    adios2::Engine reader = rio.Open(m_file, adios2::Mode::Read);
+    reader.BeginStep();
+    adios2::Variable<double> rVar = rio.InquireVariable<double>("field");
+    ASSERT_TRUE(rVar);
+    rVar.SetSelection({{0, 0}, {ranks * rows, cols}});
+    reader.Get(rVar, readValues.data(), adios2::Mode::Sync);
+    reader.EndStep();
+    reader.Close();
+
+    for (size_t i = 0; i < readValues.size(); i++) {
+        EXPECT_EQ(readValues[i], static_cast<double>(i));
+    }
+}
+
+TEST_P(adiosMPITests, StreamReader) {
+    AdiosEngine engine = std::get<0>(GetParam());
+    MPIWorld worldSize = std::get<1>(GetParam());
+    if (engine != AdiosEngine::Plugin) GTEST_SKIP();
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    const bool isSelf = (worldSize == MPIWorld::Self);
+    const size_t steps = 3, count = 64;
+    const std::string m_file = "stream-" + getAdiosFile(AdiosEngine::BP5, worldSize, worldRank);
+
+    adios2::ADIOS adios(isSelf ? MPI_COMM_SELF : MPI_COMM_WORLD);
+    adios2::Params params = genAdiosParams(engine, worldSize, worldRank);
+    params["FileName"] = "stream-" + params["FileName"];
+
+    adios2::IO wio = adios.DeclareIO("test-mpi-adios-stream-writer");
+    wio.SetEngine("Plugin");
+    params["StreamWriter"] = "true";
+    wio.SetParameters(params);
+    adios2::Variable<int32_t> wVar = wio.DefineVariable<int32_t>("field", {}, {}, {count});
+    adios2::Engine writer = wio.Open(m_file, adios2::Mode::Write);
+
+    // the reader consumes every step as soon as the writer ends it
+    params["StreamReader"] = "true";
+    params["BeginStepPollingFrequencySecs"] = "0.05";
+    adios2::IO rio = adios.DeclareIO("test-mpi-adios-stream-reader");
+    rio.SetEngine("Plugin");
+    rio.SetParameters(params);
+    adios2::Engine reader = rio.Open(m_file, adios2::Mode::Read);
+    EXPECT_EQ(reader.BeginStep(adios2::StepMode::Read, 0.0f), adios2::StepStatus::NotReady);
+
+    for (size_t step = 0; step < steps; step++) {
+        std::vector<int32_t> values(count, static_cast<int32_t>(step * 100 + worldRank));
+        std::vector<int32_t> readValues(count);
+        writer.BeginStep();
+        writer.Put(wVar, values.data());
+        writer.EndStep();
+
+        ASSERT_EQ(reader.BeginStep(adios2::StepMode::Read, 10.0f), adios2::StepStatus::OK);
+        EXPECT_EQ(reader.CurrentStep(), step);
+        adios2::Variable<int32_t> rVar = rio.InquireVariable<int32_t>("field");
+        ASSERT_TRUE(rVar);
+        reader.Get(rVar, readValues.data());
+        reader.EndStep();
+        EXPECT_EQ(values, readValues);
+    }
+
+    writer.Close();
+    EXPECT_EQ(reader.BeginStep(adios2::StepMode::Read, 10.0f), adios2::StepStatus::EndOfStream);
+    reader.Close();
+}
+
+TEST_P(adiosMPITests, RestartRead) {
+    AdiosEngine engine = std::get<0>(GetParam());
+    MPIWorld worldSize = std::get<1>(GetParam());
+    if (engine != AdiosEngine::Plugin || worldSize == MPIWorld::Self) GTEST_SKIP();
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int numProcesses, worldRank;
+    MPI_Comm_size(MPI_COMM_WORLD, &numProcesses);
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    const size_t ranks = numProcesses, rank = worldRank, count = 256;
+    const std::string m_file = "restart-" + getAdiosFile(AdiosEngine::BP5, worldSize, worldRank);
+
+    adios2::Params params = genAdiosParams(engine, worldSize, worldRank);
+    params["FileName"] = "restart-" + params["FileName"];
+
+    {
+        std::vector<double> values(count);
+        for (size_t i = 0; i < count; i++) values[i] = rank * count + i;
+
+        adios2::ADIOS adios(MPI_COMM_WORLD);
+        adios2::IO wio = adios.DeclareIO("test-mpi-adios-restart-writer");
+        wio.SetEngine("Plugin");
+        wio.SetParameters(params);
+        adios2::Variable<double> wVar =
+            wio.DefineVariable<double>("field", {ranks * count}, {rank * count}, {count});
+        adios2::Engine writer = wio.Open(m_file, adios2::Mode::Write);
+        writer.Put(wVar, values.data());
+        writer.Close();
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    // every rank alone reads what all writers wrote
+    {
+        std::vector<double> readValues(ranks * count);
+        adios2::ADIOS adios(MPI_COMM_SELF);
+        adios2::IO rio = adios.DeclareIO("test-mpi-adios-restart-self");
+        rio.SetEngine("Plugin");
+        rio.SetParameters(params);
+        adios2::Engine reader = rio.Open(m_file, adios2::Mode::Read);
+        adios2::Variable<double> rVar = rio.InquireVariable<double>("field");
+        ASSERT_TRUE(rVar);
+        rVar.SetSelection({{0}, {ranks * count}});
+        reader.Get(rVar, readValues.data(), adios2::Mode::Sync);
+        reader.Close();
+
+        for (size_t i = 0; i < readValues.size(); i++) {
+            EXPECT_EQ(readValues[i], static_cast<double>(i));
+        }
+    }
+
+    // all ranks read again with another aggregator ratio, each the block of its neighbour
+    {
+        const size_t from = ((rank + 1) % ranks) * count;
+        std::vector<double> readValues(count);
+        params["AggregationType"] = "EveryoneWrites";
+        params["AggregatorRatio"] = "3";
+
+        adios2::ADIOS adios(MPI_COMM_WORLD);
+        adios2::IO rio = adios.DeclareIO("test-mpi-adios-restart-world");
+        rio.SetEngine("Plugin");
+        rio.SetParameters(params);
+        adios2::Engine reader = rio.Open(m_file, adios2::Mode::Read);
+        adios2::Variable<double> rVar = rio.InquireVariable<double>("field");
+        ASSERT_TRUE(rVar);
+        rVar.SetSelection({{from}, {count}});
+        reader.Get(rVar, readValues.data(), adios2::Mode::Sync);
+        reader.Close();
+
+        for (size_t i = 0; i < readValues.size(); i++) {
+            EXPECT_EQ(readValues[i], static_cast<double>(from + i));
+        }
+    }
+}
 
 auto adiosTV = ::testing::Values(std::make_tuple(AdiosEngine::BP5, MPIWorld::Shared),
                                  std::make_tuple(AdiosEngine::BP5, MPIWorld::Entire),
@@ -31,8 +31,10 @@
 #include <gtest/gtest.h>
 #include <mpi.h>
 
+#include <fstream>
 #include <iostream>
 #include <lsmio/manager/manager.hpp>
+#include <sstream>
 #include <stdexcept>
 #include <vector>
 
@@ -118,6 +120,879 @@ TEST_P(managerMPITests, Flush) {
     delete lm;
 }
 
+TEST_P(managerMPITests, NonBlocking) {
+    UseComm comm = std::get<0>(GetParam());
+    MPIWorld worldSize = std::get<1>(GetParam());
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    std::string prefix = genPreFix((comm == UseComm::CommWorld), worldSize);
+    std::string dbFile = getDBFile(prefix + "-nb", comm, worldRank);
+    lsmio::LSMIOManager *lm = nullptr;
+
+    if (comm == UseComm::CommWorld) {
+        lsmio::gConfigLSMIO.mpiAggType = translateAggType(worldSize);
+        lm = new lsmio::LSMIOManager(dbFile, TEST_DIR_MGR, true, MPI_COMM_WORLD);
+    } else
+        lm = new lsmio::LSMIOManager(dbFile, TEST_DIR_MGR, true, MPI_COMM_SELF);
+
+    const int count = 16;
+    bool success = true;
+    std::vector<lsmio::LSMIORequest> requests(count);
+
+    for (int i = 0; i < count; i++) {
+        std::string value = generateRankString(worldRank) + ":" + std::to_string(i);
+        success = lm->iput("key-" + std::to_string(i), value, &requests[i]);
+        EXPECT_EQ(success, true);
+    }
+
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+
+    std::vector<std::string> values(count);
+    for (int i = 0; i < count; i++) {
+        success = lm->iget("key-" + std::to_string(i), &values[i], &requests[i]);
+        EXPECT_EQ(success, true);
+    }
+
+    while (!lm->test(requests[0], &success)) {
+    }
+    EXPECT_EQ(success, true);
+
+    success = lm->waitAll();
+    EXPECT_EQ(success, true);
+
+    for (int i = 0; i < count; i++) {
+        EXPECT_EQ(values[i], generateRankString(worldRank) + ":" + std::to_string(i));
+    }
+
+    delete lm;
+}
+
+TEST_P(managerMPITests, PutBatch) {
+    UseComm comm = std::get<0>(GetParam());
+    MPIWorld worldSize = std::get<1>(GetParam());
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    std::string prefix = genPreFix((comm == UseComm::CommWorld), worldSize);
+    std::string dbFile = getDBFile(prefix + "-batch", comm, worldRank);
+    lsmio::LSMIOManager *lm = nullptr;
+
+    if (comm == UseComm::CommWorld) {
+        lsmio::gConfigLSMIO.mpiAggType = translateAggType(worldSize);
+        lm = new lsmio::LSMIOManager(dbFile, TEST_DIR_MGR, true, MPI_COMM_WORLD);
+    } else
+        lm = new lsmio::LSMIOManager(dbFile, TEST_DIR_MGR, true, MPI_COMM_SELF);
+
+    // ranks hold different amounts of data, and small transfers make the transport send the
+    // larger batches in fragments; every rank still sends one command per batch
+    const int savedTransferSize = lsmio::gConfigLSMIO.transferSize;
+    lsmio::gConfigLSMIO.transferSize = 256;
+
+    const int count = 16 * (worldRank + 1);
+    std::vector<std::tuple<std::string, std::string>> values, metaValues;
+    for (int i = 0; i < count; i++) {
+        std::string value = generateRankString(worldRank) + ":" + std::to_string(i);
+        values.emplace_back("batch-" + std::to_string(i), value + std::string(64, 'x'));
+    }
+    metaValues.emplace_back("batch-meta", generateRankString(worldRank));
+
+    bool success = lm->putBatch(values, metaValues, false);
+    EXPECT_EQ(success, true);
+
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+
+    std::string value;
+    for (const auto &[key, expected] : values) {
+        success = lm->get(key, &value);
+        EXPECT_EQ(success, true);
+        EXPECT_EQ(value, expected);
+    }
+
+    success = lm->metaGet("batch-meta", &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, generateRankString(worldRank));
+
+    lsmio::gConfigLSMIO.transferSize = savedTransferSize;
+    delete lm;
+}
+
+TEST_P(managerMPITests, GetBatch) {
+    UseComm comm = std::get<0>(GetParam());
+    MPIWorld worldSize = std::get<1>(GetParam());
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    std::string prefix = genPreFix((comm == UseComm::CommWorld), worldSize);
+    std::string dbFile = getDBFile(prefix + "-getbatch", comm, worldRank);
+    lsmio::LSMIOManager *lm = nullptr;
+
+    if (comm == UseComm::CommWorld) {
+        lsmio::gConfigLSMIO.mpiAggType = translateAggType(worldSize);
+        lm = new lsmio::LSMIOManager(dbFile, TEST_DIR_MGR, true, MPI_COMM_WORLD);
+    } else
+        lm = new lsmio::LSMIOManager(dbFile, TEST_DIR_MGR, true, MPI_COMM_SELF);
+
+    // ranks look up different numbers of keys, one of them none at all
+    const int count = 5 * worldRank;
+    std::vector<std::string> keys;
+    for (int i = 0; i < count; i++) {
+        keys.push_back("getbatch-" + std::to_string(i));
+        std::string value = generateRankString(worldRank) + std::to_string(i);
+        bool success = lm->put(keys.back(), value, false);
+        EXPECT_EQ(success, true);
+    }
+    keys.push_back("getbatch-missing");
+
+    bool success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+
+    std::vector<std::string> values;
+    success = lm->getBatch(keys, &values);
+    ASSERT_EQ(values.size(), keys.size());
+    for (int i = 0; i < count; i++) {
+        EXPECT_EQ(values[i], generateRankString(worldRank) + std::to_string(i));
+    }
+    EXPECT_TRUE(values[count].empty());
+
+    success = lm->getBatch({}, &values);
+    EXPECT_EQ(success, true);
+    EXPECT_TRUE(values.empty());
+
+    delete lm;
+}
+
+TEST_P(managerMPITests, MetaGetAllCollective) {
+    UseComm comm = std::get<0>(GetParam());
+    MPIWorld worldSize = std::get<1>(GetParam());
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    std::string prefix = genPreFix((comm == UseComm::CommWorld), worldSize);
+    std::string dbFile = getDBFile(prefix + "-meta", comm, worldRank);
+    lsmio::LSMIOManager *lm = nullptr;
+
+    if (comm == UseComm::CommWorld) {
+        lsmio::gConfigLSMIO.mpiAggType = translateAggType(worldSize);
+        lm = new lsmio::LSMIOManager(dbFile, TEST_DIR_MGR, true, MPI_COMM_WORLD);
+    } else
+        lm = new lsmio::LSMIOManager(dbFile, TEST_DIR_MGR, true, MPI_COMM_SELF);
+
+    const int count = 8;
+    bool success = true;
+
+    for (int i = 0; i < count; i++) {
+        // separators of the text serialization must survive the binary one
+        std::string value = generateRankString(worldRank) + "|" + std::to_string(i) + "\n;";
+        success = lm->metaPut("var-" + std::to_string(i), value, false);
+        EXPECT_EQ(success, true);
+    }
+
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+
+    std::vector<std::tuple<std::string, std::string>> values;
+    success = lm->metaGetAllCollective(&values);
+    EXPECT_EQ(success, true);
+    EXPECT_GE(values.size(), count);
+
+    for (int i = 0; i < count; i++) {
+        std::string value = generateRankString(worldRank) + "|" + std::to_string(i) + "\n;";
+        bool found = false;
+        for (const auto &tup : values) found |= (std::get<1>(tup) == value);
+        EXPECT_EQ(found, true);
+    }
+
+    delete lm;
+}
+
+TEST_P(managerMPITests, MetaGetAllCollectiveUneven) {
+    UseComm comm = std::get<0>(GetParam());
+    MPIWorld worldSize = std::get<1>(GetParam());
+    // clients of an aggregator only
+    if (comm == UseComm::CommSelf) GTEST_SKIP();
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    std::string prefix = genPreFix(true, worldSize);
+    std::string dbFile = getDBFile(prefix + "-meta-uneven", comm, worldRank);
+    lsmio::gConfigLSMIO.mpiAggType = translateAggType(worldSize);
+    lsmio::LSMIOManager *lm =
+        new lsmio::LSMIOManager(dbFile, TEST_DIR_MGR, true, MPI_COMM_WORLD);
+
+    // only odd ranks leave writes pending, the others come in with nothing to flush
+    const std::string value = generateRankString(worldRank);
+    if (worldRank % 2 == 1) EXPECT_EQ(lm->metaPut("var", value, false), true);
+
+    std::vector<std::tuple<std::string, std::string>> values;
+    bool success = lm->metaGetAllCollective(&values);
+    // an aggregator alone in its group has nothing to return
+    if (worldRank % 2 == 1) EXPECT_EQ(success, true);
+
+    bool found = false;
+    for (const auto &tup : values) found |= (std::get<1>(tup) == value);
+    EXPECT_EQ(found, worldRank % 2 == 1);
+
+    delete lm;
+}
+
+TEST(managerMPIReadCache, Flush) {
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Entire;
+    lsmio::gConfigLSMIO.readCacheData = true;
+
+    lsmio::LSMIOManager *lm =
+        new lsmio::LSMIOManager("test-mpi-mgr-cache.db", TEST_DIR_MGR, true, MPI_COMM_WORLD);
+
+    bool success = true;
+    std::string value;
+    std::string rankString = generateRankString(worldRank);
+
+    success = lm->put("key", rankString + "-1");
+    EXPECT_EQ(success, true);
+    success = lm->metaPut("meta", rankString + "-1", false);
+    EXPECT_EQ(success, true);
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+
+    for (int i = 0; i < 2; i++) {
+        success = lm->get("key", &value);
+        EXPECT_EQ(success, true);
+        EXPECT_EQ(value, rankString + "-1");
+
+        success = lm->metaGet("meta", &value);
+        EXPECT_EQ(success, true);
+        EXPECT_EQ(value, rankString + "-1");
+    }
+
+    // own writes must not be shadowed by cached values
+    success = lm->put("key", rankString + "-2");
+    EXPECT_EQ(success, true);
+    success = lm->metaPut("meta", rankString + "-2", false);
+    EXPECT_EQ(success, true);
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+
+    success = lm->get("key", &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, rankString + "-2");
+
+    success = lm->metaGet("meta", &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, rankString + "-2");
+
+    delete lm;
+
+    lsmio::gConfigLSMIO.readCacheData = false;
+}
+
+TEST(managerMPIReadCache, UnevenHits) {
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Entire;
+    lsmio::gConfigLSMIO.readCacheData = true;
+
+    lsmio::LSMIOManager *lm = new lsmio::LSMIOManager("test-mpi-mgr-cache-uneven.db",
+                                                      TEST_DIR_MGR, true, MPI_COMM_WORLD);
+
+    std::string value;
+    std::string rankString = generateRankString(worldRank);
+    EXPECT_EQ(lm->put("key", rankString), true);
+    EXPECT_EQ(lm->writeBarrier(), true);
+
+    // clients read a different number of times, so they hit the cache a different number
+    // of times and send the aggregator a different number of commands
+    for (int i = 0; i <= worldRank; i++) {
+        EXPECT_EQ(lm->get("key", &value), true);
+        EXPECT_EQ(value, rankString);
+    }
+
+    delete lm;
+
+    lsmio::gConfigLSMIO.readCacheData = false;
+}
+
+TEST(managerMPICredits, Flush) {
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Entire;
+    lsmio::gConfigLSMIO.creditBytes = 256;  // force clients to wait for credits
+    lsmio::gConfigLSMIO.creditMessages = 2;
+
+    lsmio::LSMIOManager *lm =
+        new lsmio::LSMIOManager("test-mpi-mgr-credits.db", TEST_DIR_MGR, true, MPI_COMM_WORLD);
+
+    const int count = 64;
+    bool success = true;
+    std::string value;
+
+    for (int i = 0; i < count; i++) {
+        std::string pValue = generateRankString(worldRank) + std::string(i * 8, 'c');
+        success = lm->put("key-" + std::to_string(i), pValue);
+        EXPECT_EQ(success, true);
+    }
+
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+
+    for (int i = 0; i < count; i++) {
+        success = lm->get("key-" + std::to_string(i), &value);
+        EXPECT_EQ(success, true);
+        EXPECT_EQ(value, generateRankString(worldRank) + std::string(i * 8, 'c'));
+    }
+
+    delete lm;
+
+    lsmio::gConfigLSMIO.creditBytes = 0;
+    lsmio::gConfigLSMIO.creditMessages = 0;
+}
+
+TEST(managerMPISharedMemory, Flush) {
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Shared;
+    lsmio::gConfigLSMIO.clientTransport = lsmio::ClientTransport::SharedMemory;
+    lsmio::gConfigLSMIO.shmRingSize = 64;  // force records to wrap around the ring
+
+    lsmio::LSMIOManager *lm =
+        new lsmio::LSMIOManager("test-mpi-mgr-shm.db", TEST_DIR_MGR, true, MPI_COMM_WORLD);
+
+    bool success = true;
+    std::string value;
+
+    std::string key1 = "serdar";
+    std::string value1 = generateRankString(worldRank);
+    std::string key2 = "bulut";
+    std::string value2(1024, 'b');
+
+    success = lm->put(key1, value1);
+    EXPECT_EQ(success, true);
+
+    success = lm->put(key2, value2);
+    EXPECT_EQ(success, true);
+
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+
+    success = lm->get(key1, &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, value1);
+
+    success = lm->get(key2, &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, value2);
+
+    delete lm;
+
+    lsmio::gConfigLSMIO.clientTransport = lsmio::ClientTransport::MPI;
+    lsmio::gConfigLSMIO.shmRingSize = 4 * 1024 * 1024;
+}
+
+TEST(managerMPIAdios, Flush) {
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Entire;
+    lsmio::gConfigLSMIO.clientTransport = lsmio::ClientTransport::Adios;
+
+    lsmio::LSMIOManager *lm =
+        new lsmio::LSMIOManager("test-mpi-mgr-adios.db", TEST_DIR_MGR, true, MPI_COMM_WORLD);
+
+    const int count = 8;
+    bool success = true;
+    std::string value;
+    std::vector<lsmio::LSMIORequest> requests(count);
+
+    for (int i = 0; i < count; i++) {
+        std::string pValue = generateRankString(worldRank) + ":" + std::to_string(i);
+        success = lm->iput("key-" + std::to_string(i), pValue, &requests[i]);
+        EXPECT_EQ(success, true);
+    }
+
+    success = lm->put("large", std::string(100000, 'a' + worldRank % 26));
+    EXPECT_EQ(success, true);
+    success = lm->metaPut("meta", generateRankString(worldRank), false);
+    EXPECT_EQ(success, true);
+
+    success = lm->waitAll();
+    EXPECT_EQ(success, true);
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+
+    std::vector<std::string> values(count);
+    for (int i = 0; i < count; i++) {
+        success = lm->iget("key-" + std::to_string(i), &values[i], &requests[i]);
+        EXPECT_EQ(success, true);
+    }
+
+    success = lm->waitAll();
+    EXPECT_EQ(success, true);
+
+    for (int i = 0; i < count; i++) {
+        EXPECT_EQ(values[i], generateRankString(worldRank) + ":" + std::to_string(i));
+    }
+
+    success = lm->get("large", &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, std::string(100000, 'a' + worldRank % 26));
+
+    success = lm->metaGet("meta", &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, generateRankString(worldRank));
+
+    delete lm;
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Shared;
+    lsmio::gConfigLSMIO.clientTransport = lsmio::ClientTransport::MPI;
+}
+
+TEST(managerMPITrace, Spans) {
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Entire;
+    lsmio::gConfigLSMIO.traceDir = "test-mpi-mgr-trace";
+
+    lsmio::LSMIOManager *lm =
+        new lsmio::LSMIOManager("test-mpi-mgr-trace.db", TEST_DIR_MGR, true, MPI_COMM_WORLD);
+
+    bool success = lm->put("key", generateRankString(worldRank));
+    EXPECT_EQ(success, true);
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+
+    delete lm;
+
+    std::ifstream file("test-mpi-mgr-trace/test-mpi-mgr-trace.db.trace." +
+                       std::to_string(worldRank) + ".json");
+    ASSERT_TRUE(file.good());
+    std::stringstream trace;
+    trace << file.rdbuf();
+
+    EXPECT_NE(trace.str().find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(trace.str().find("\"pid\":" + std::to_string(worldRank) + ","), std::string::npos);
+    EXPECT_NE(trace.str().find("\"manager.put\""), std::string::npos);
+    EXPECT_NE(trace.str().find("\"manager.writeBarrier\""), std::string::npos);
+    if (worldRank == 0) {
+        EXPECT_NE(trace.str().find("\"native.batchMutation\""), std::string::npos);
+        int worldSize;
+        MPI_Comm_size(MPI_COMM_WORLD, &worldSize);
+        if (worldSize > 1) {
+            EXPECT_NE(trace.str().find("\"aggregator.command\""), std::string::npos);
+        }
+    } else {
+        EXPECT_NE(trace.str().find("\"transport.send\""), std::string::npos);
+    }
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Shared;
+    lsmio::gConfigLSMIO.traceDir = "";
+}
+
+TEST(managerMPIMetrics, Export) {
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Entire;
+    lsmio::gConfigLSMIO.metricsDir = "test-mpi-mgr-metrics";
+    lsmio::gConfigLSMIO.metricsIntervalMs = 10;
+
+    lsmio::LSMIOManager *lm =
+        new lsmio::LSMIOManager("test-mpi-mgr-metrics.db", TEST_DIR_MGR, true, MPI_COMM_WORLD);
+
+    bool success = lm->put("key", std::string(1000, 'a' + worldRank % 26));
+    EXPECT_EQ(success, true);
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+
+    delete lm;
+
+    std::ifstream file("test-mpi-mgr-metrics/lsmio_test-mpi-mgr-metrics.db_" +
+                       std::to_string(worldRank) + ".prom");
+    ASSERT_TRUE(file.good());
+    std::stringstream metrics;
+    metrics << file.rdbuf();
+
+    std::string labels =
+        "{rank=\"" + std::to_string(worldRank) + "\",db=\"test-mpi-mgr-metrics.db\"}";
+    EXPECT_NE(metrics.str().find("lsmio_write_bytes_total" + labels + " 1000\n"),
+              std::string::npos);
+    EXPECT_NE(metrics.str().find("# TYPE lsmio_aggregator_queue_depth gauge"), std::string::npos);
+    if (worldRank == 0) {
+        // each client barrier flushes what has arrived so far, so only a lower bound holds
+        EXPECT_EQ(metrics.str().find("lsmio_sstables" + labels + " 0\n"), std::string::npos);
+        EXPECT_NE(metrics.str().find("lsmio_sstables" + labels + " "), std::string::npos);
+    } else {
+        EXPECT_NE(metrics.str().find("lsmio_sstables" + labels + " 0\n"), std::string::npos);
+    }
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Shared;
+    lsmio::gConfigLSMIO.metricsDir = "";
+    lsmio::gConfigLSMIO.metricsIntervalMs = 1000;
+}
+
+TEST(managerMPIAggregatorRatio, Flush) {
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Shared;
+    lsmio::gConfigLSMIO.ranksPerAggregator = 1;  // every rank aggregates for itself
+
+    lsmio::LSMIOManager *lm =
+        new lsmio::LSMIOManager("test-mpi-mgr-ratio.db", TEST_DIR_MGR, true, MPI_COMM_WORLD);
+
+    bool success = true;
+    std::string value;
+
+    std::string key1 = "serdar";
+    std::string value1 = generateRankString(worldRank);
+
+    success = lm->put(key1, value1);
+    EXPECT_EQ(success, true);
+
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+
+    success = lm->get(key1, &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, value1);
+
+    EXPECT_NE(lm->getDbPath().find("agg/" + std::to_string(worldRank)), std::string::npos);
+
+    delete lm;
+
+    lsmio::gConfigLSMIO.ranksPerAggregator = 0;
+}
+
+TEST(managerMPINumaAware, Flush) {
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Shared;
+    lsmio::gConfigLSMIO.numaAwareAggregation = true;  // falls back to nodes when unavailable
+
+    lsmio::LSMIOManager *lm =
+        new lsmio::LSMIOManager("test-mpi-mgr-numa.db", TEST_DIR_MGR, true, MPI_COMM_WORLD);
+
+    bool success = true;
+    std::string value;
+
+    std::string key1 = "serdar-" + std::to_string(worldRank);
+    std::string value1 = generateRankString(worldRank);
+
+    success = lm->put(key1, value1);
+    EXPECT_EQ(success, true);
+
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+
+    success = lm->get(key1, &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, value1);
+
+    delete lm;
+
+    lsmio::gConfigLSMIO.numaAwareAggregation = false;
+}
+
+TEST(managerMPIHierarchical, Flush) {
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Hierarchical;
+    lsmio::gConfigLSMIO.emulatedNodes = 2;
+    lsmio::gConfigLSMIO.globalWriters = 2;
+    lsmio::gConfigLSMIO.forwardBatchBytes = 256;  // force runs out before the barrier
+
+    lsmio::LSMIOManager *lm =
+        new lsmio::LSMIOManager("test-mpi-mgr-hier.db", TEST_DIR_MGR, true, MPI_COMM_WORLD);
+
+    const int count = 32;
+    bool success = true;
+    std::string value;
+
+    for (int i = 0; i < count; i++) {
+        std::string pValue = generateRankString(worldRank) + std::to_string(i);
+        success = lm->put("key-" + std::to_string(i), pValue);
+        EXPECT_EQ(success, true);
+    }
+
+    success = lm->del("key-0");
+    EXPECT_EQ(success, true);
+
+    success = lm->metaPut("meta", generateRankString(worldRank), false);
+    EXPECT_EQ(success, true);
+
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+
+    for (int i = 1; i < count; i++) {
+        success = lm->get("key-" + std::to_string(i), &value);
+        EXPECT_EQ(success, true);
+        EXPECT_EQ(value, generateRankString(worldRank) + std::to_string(i));
+    }
+
+    value.clear();
+    lm->get("key-0", &value);  // remote gets report transport success only
+    EXPECT_EQ(value, "");
+
+    success = lm->metaGet("meta", &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, generateRankString(worldRank));
+
+    delete lm;
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Shared;
+    lsmio::gConfigLSMIO.emulatedNodes = 0;
+    lsmio::gConfigLSMIO.globalWriters = 1;
+    lsmio::gConfigLSMIO.forwardBatchBytes = 8 * 1024 * 1024;
+}
+
+TEST(managerMPIRestart, NToM) {
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank, worldSize;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &worldSize);
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Split;
+    lsmio::gConfigLSMIO.ranksPerAggregator = 2;
+    lsmio::gConfigLSMIO.writeRestartIndex = true;
+
+    std::string dbName = "test-mpi-mgr-restart.db";
+    lsmio::LSMIOManager *lm = new lsmio::LSMIOManager(dbName, TEST_DIR_MGR, true, MPI_COMM_WORLD);
+
+    bool success = true;
+    std::string value;
+
+    success = lm->put("block", generateRankString(worldRank));
+    EXPECT_EQ(success, true);
+    success = lm->put("scratch", generateRankString(worldRank));
+    EXPECT_EQ(success, true);
+    success = lm->del("scratch");
+    EXPECT_EQ(success, true);
+    success = lm->metaPut("meta", std::to_string(worldRank), false);
+    EXPECT_EQ(success, true);
+
+    delete lm;
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    // read back as a single rank that does not know the writer's layout
+    lsmio::LSMIORestartReader reader(dbName, TEST_DIR_MGR);
+    EXPECT_EQ(reader.writers().size(), worldSize);
+    EXPECT_EQ(reader.sharedReads(), true);
+
+    int writer = (worldRank + 1) % worldSize;
+    std::vector<std::string> keys;
+    success = reader.keys(writer, &keys);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(keys, std::vector<std::string>{"block"});
+
+    success = reader.get(writer, "block", &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, generateRankString(writer));
+
+    success = reader.metaGet(writer, "meta", &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, std::to_string(writer));
+
+    success = reader.get(writer, "scratch", &value);
+    EXPECT_EQ(success, false);
+
+    std::vector<std::string> values;
+    success = reader.getBatch({{writer, "block"}, {worldRank, "block"}}, &values);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(values, (std::vector<std::string>{generateRankString(writer),
+                                                generateRankString(worldRank)}));
+
+    success = reader.getBatch({{writer, "scratch"}, {writer, "block"}}, &values);
+    EXPECT_EQ(success, false);
+    EXPECT_EQ(values[0], "");
+    EXPECT_EQ(values[1], generateRankString(writer));
+
+    reader.close();
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Shared;
+    lsmio::gConfigLSMIO.ranksPerAggregator = 0;
+    lsmio::gConfigLSMIO.writeRestartIndex = false;
+}
+
+TEST(managerMPIRestart, Publish) {
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank, worldSize;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &worldSize);
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Split;
+    lsmio::gConfigLSMIO.ranksPerAggregator = 2;
+    lsmio::gConfigLSMIO.writeRestartIndex = true;
+
+    std::string dbName = "test-mpi-mgr-publish.db";
+    lsmio::LSMIOManager *lm = new lsmio::LSMIOManager(dbName, TEST_DIR_MGR, true, MPI_COMM_WORLD);
+
+    bool success = true;
+    std::string value;
+    int writer = (worldRank + 1) % worldSize;
+
+    // data of a step is readable by any rank once every aggregator published its index
+    success = lm->put("step0", generateRankString(worldRank));
+    EXPECT_EQ(success, true);
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+    MPI_Barrier(MPI_COMM_WORLD);
+    success = lm->publishRestartIndex();
+    EXPECT_EQ(success, true);
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    lsmio::LSMIORestartReader reader(dbName, TEST_DIR_MGR);
+    success = reader.get(writer, "step0", &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, generateRankString(writer));
+    success = reader.get(writer, "step1", &value);
+    EXPECT_EQ(success, false);
+
+    success = lm->put("step1", generateRankString(worldRank) + "1");
+    EXPECT_EQ(success, true);
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+    MPI_Barrier(MPI_COMM_WORLD);
+    success = lm->publishRestartIndex();
+    EXPECT_EQ(success, true);
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    reader.refresh();
+    success = reader.get(writer, "step1", &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, generateRankString(writer) + "1");
+
+    // deletions are published too
+    success = lm->del("step0");
+    EXPECT_EQ(success, true);
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+    MPI_Barrier(MPI_COMM_WORLD);
+    success = lm->publishRestartIndex();
+    EXPECT_EQ(success, true);
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    reader.refresh();
+    success = reader.get(writer, "step0", &value);
+    EXPECT_EQ(success, false);
+    std::vector<std::string> keys;
+    success = reader.keys(writer, &keys);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(keys, std::vector<std::string>{"step1"});
+
+    reader.close();
+    delete lm;
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    // the final index replaces the published updates
+    lsmio::LSMIORestartReader closed(dbName, TEST_DIR_MGR);
+    success = closed.get(writer, "step1", &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, generateRankString(writer) + "1");
+    success = closed.get(writer, "step0", &value);
+    EXPECT_EQ(success, false);
+    closed.close();
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Shared;
+    lsmio::gConfigLSMIO.ranksPerAggregator = 0;
+    lsmio::gConfigLSMIO.writeRestartIndex = false;
+}
+
+TEST(managerMPIFragments, Flush) {
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int worldRank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Entire;
+    int transferSize = lsmio::gConfigLSMIO.transferSize;
+    lsmio::gConfigLSMIO.transferSize = 1000;  // send values in fragments
+
+    lsmio::LSMIOManager *lm =
+        new lsmio::LSMIOManager("test-mpi-mgr-frag.db", TEST_DIR_MGR, true, MPI_COMM_WORLD);
+
+    const int count = 4;
+    bool success = true;
+    std::string value;
+    std::vector<lsmio::LSMIORequest> requests(count);
+
+    auto largeValue = [worldRank](int i) {
+        std::string v;
+        while (v.size() < 10000 + 777 * i) v += generateRankString(worldRank) + std::to_string(i);
+        return v;
+    };
+
+    success = lm->put("key", largeValue(0));
+    EXPECT_EQ(success, true);
+
+    for (int i = 0; i < count; i++) {
+        success = lm->iput("key-" + std::to_string(i), largeValue(i), &requests[i]);
+        EXPECT_EQ(success, true);
+    }
+
+    success = lm->waitAll();
+    EXPECT_EQ(success, true);
+    success = lm->writeBarrier();
+    EXPECT_EQ(success, true);
+
+    success = lm->get("key", &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, largeValue(0));
+
+    for (int i = 0; i < count; i++) {
+        success = lm->get("key-" + std::to_string(i), &value);
+        EXPECT_EQ(success, true);
+        EXPECT_EQ(value, largeValue(i));
+    }
+
+    delete lm;
+
+    lsmio::gConfigLSMIO.mpiAggType = lsmio::MPIAggType::Shared;
+    lsmio::gConfigLSMIO.transferSize = transferSize;
+}
+
 
 auto managerTV = ::testing::Values(std::make_tuple(UseComm::CommSelf, MPIWorld::Shared),
                                    std::make_tuple(UseComm::CommWorld, MPIWorld::Shared),
@@ -159,6 +159,46 @@ TEST(lsmioNative, Deferred) {  // Changed from lsmioRocksDB
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
 }
 
+TEST(lsmioNative, ReadOnly) {
+    bool success = true;
+    std::string value;
+
+    std::string dbName = "test-native-store-readonly.db";
+    std::string dbPath = TEST_DIR_NATIVE.empty() ? dbName : TEST_DIR_NATIVE + "/" + dbName;
+
+    {
+        lsmio::LSMIOStoreNative lc(dbPath, true);
+        success = lc.put("serdar", "alpino");
+        EXPECT_EQ(success, true);
+        success = lc.metaPut("bulut", "teomos");
+        EXPECT_EQ(success, true);
+        lc.close();
+    }
+
+    // two readers of the same database at once
+    lsmio::LSMIOStoreNative reader1(dbPath, false, true);
+    lsmio::LSMIOStoreNative reader2(dbPath, false, true);
+
+    success = reader1.get("serdar", &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, "alpino");
+
+    success = reader2.metaGet("bulut", &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, "teomos");
+
+    success = reader1.put("serdar", "changed");
+    EXPECT_EQ(success, false);
+
+    reader1.close();
+    reader2.close();
+
+    lsmio::LSMIOStoreNative lc(dbPath, false);
+    success = lc.get("serdar", &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, "alpino");
+}
+
 int main(int argc, char** argv) {
     lsmio::initLSMIODebug(argv[0]);
     ::testing::InitGoogleTest(&argc, argv);
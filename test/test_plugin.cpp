@@ -34,6 +34,7 @@
 #include <iostream>
 #include <lsmio/lsmio.hpp>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 void testPluginWriter(adios2::ADIOS &adios, const std::string &testKey,
@@ -110,3 +111,318 @@ TEST(ADIOS, Plugin) {
         EXPECT_EQ(testValue, messages[i]);
     }
 }
+
+TEST(ADIOS, PluginDoubleArray) {
+    const size_t count = 4096;
+    std::vector<double> values(count), readValues(count);
+    for (size_t i = 0; i < count; i++) values[i] = 1.0 / (i + 1);
+
+    try {
+        adios2::ADIOS adios;
+        adios2::Params params;
+        params["PluginName"] = "LSMIOPlugin";
+        params["PluginLibrary"] = "liblsmio_adios";
+        params["FileName"] = "test-plugin-array.db";
+
+        adios2::IO wio = adios.DeclareIO("test-plugin-array-writer");
+        wio.SetEngine("Plugin");
+        wio.SetParameters(params);
+        adios2::Engine writer = wio.Open("test-plugin-array.db", adios2::Mode::Write);
+        adios2::Variable<double> wVar = wio.DefineVariable<double>("field", {}, {}, {count});
+        writer.Put(wVar, values.data(), adios2::Mode::Sync);
+        writer.Close();
+
+        adios2::IO rio = adios.DeclareIO("test-plugin-array-reader");
+        rio.SetEngine("Plugin");
+        rio.SetParameters(params);
+        adios2::Engine reader = rio.Open("test-plugin-array.db", adios2::Mode::Read);
+        adios2::Variable<double> rVar = rio.InquireVariable<double>("field");
+        ASSERT_TRUE(rVar);
+        reader.Get(rVar, readValues.data(), adios2::Mode::Sync);
+        reader.Close();
+    } catch (const std::exception &e) {
+        FAIL() << "Adios throws an exception: " << e.what() << ".";
+    }
+
+    // binary blocks round-trip exactly, the old text encoding lost precision
+    EXPECT_EQ(values, readValues);
+}
+
+TEST(ADIOS, PluginDeferredArrays) {
+    const size_t count = 1024;
+    std::vector<float> first(count, 1.5f), second(count, 2.5f);
+    std::vector<float> readFirst(count), readSecond(count);
+
+    try {
+        adios2::ADIOS adios;
+        adios2::Params params;
+        params["PluginName"] = "LSMIOPlugin";
+        params["PluginLibrary"] = "liblsmio_adios";
+        params["FileName"] = "test-plugin-deferred.db";
+
+        adios2::IO wio = adios.DeclareIO("test-plugin-deferred-writer");
+        wio.SetEngine("Plugin");
+        wio.SetParameters(params);
+        adios2::Engine writer = wio.Open("test-plugin-deferred.db", adios2::Mode::Write);
+        adios2::Variable<float> wFirst = wio.DefineVariable<float>("first", {}, {}, {count});
+        adios2::Variable<float> wSecond = wio.DefineVariable<float>("second", {}, {}, {count});
+        writer.Put(wFirst, first.data());
+        writer.Put(wSecond, second.data());
+        // deferred puts read the buffers in PerformPuts
+        first[0] = 7.0f;
+        writer.PerformPuts();
+        writer.Close();
+
+        adios2::IO rio = adios.DeclareIO("test-plugin-deferred-reader");
+        rio.SetEngine("Plugin");
+        rio.SetParameters(params);
+        adios2::Engine reader = rio.Open("test-plugin-deferred.db", adios2::Mode::Read);
+        reader.Get(rio.InquireVariable<float>("first"), readFirst.data(), adios2::Mode::Sync);
+        reader.Get(rio.InquireVariable<float>("second"), readSecond.data(), adios2::Mode::Sync);
+        reader.Close();
+    } catch (const std::exception &e) {
+        FAIL() << "Adios throws an exception: " << e.what() << ".";
+    }
+
+    EXPECT_EQ(first, readFirst);
+    EXPECT_EQ(second, readSecond);
+}
+
+TEST(ADIOS, PluginSteps) {
+    const size_t count = 16;
+    const int steps = 3;
+    std::vector<int32_t> readValues(count * 2);
+    int readSteps = 0;
+
+    try {
+        adios2::ADIOS adios;
+        adios2::Params params;
+        params["PluginName"] = "LSMIOPlugin";
+        params["PluginLibrary"] = "liblsmio_adios";
+        params["FileName"] = "test-plugin-steps.db";
+
+        adios2::IO wio = adios.DeclareIO("test-plugin-steps-writer");
+        wio.SetEngine("Plugin");
+        wio.SetParameters(params);
+        adios2::Engine writer = wio.Open("test-plugin-steps.db", adios2::Mode::Write);
+        adios2::Variable<int32_t> wVar = wio.DefineVariable<int32_t>("field", {}, {}, {count});
+        for (int step = 0; step < steps; step++) {
+            std::vector<int32_t> values(count, step);
+            writer.BeginStep();
+            writer.Put(wVar, values.data());
+            writer.EndStep();
+        }
+        writer.Close();
+
+        adios2::IO rio = adios.DeclareIO("test-plugin-steps-reader");
+        rio.SetEngine("Plugin");
+        rio.SetParameters(params);
+        adios2::Engine reader = rio.Open("test-plugin-steps.db", adios2::Mode::Read);
+        while (reader.BeginStep() == adios2::StepStatus::OK) {
+            adios2::Variable<int32_t> rVar = rio.InquireVariable<int32_t>("field");
+            reader.Get(rVar, readValues.data(), adios2::Mode::Sync);
+            EXPECT_EQ(readValues[0], readSteps);
+            reader.EndStep();
+            readSteps++;
+        }
+        reader.Close();
+
+        // random access to the last two steps
+        adios2::IO aio = adios.DeclareIO("test-plugin-steps-random");
+        aio.SetEngine("Plugin");
+        aio.SetParameters(params);
+        adios2::Engine random = aio.Open("test-plugin-steps.db", adios2::Mode::ReadRandomAccess);
+        adios2::Variable<int32_t> aVar = aio.InquireVariable<int32_t>("field");
+        EXPECT_EQ(aVar.Steps(), steps);
+        aVar.SetStepSelection({1, 2});
+        random.Get(aVar, readValues.data(), adios2::Mode::Sync);
+        random.Close();
+    } catch (const std::exception &e) {
+        FAIL() << "Adios throws an exception: " << e.what() << ".";
+    }
+
+    EXPECT_EQ(readSteps, steps);
+    EXPECT_EQ(readValues[0], 1);
+    EXPECT_EQ(readValues[count], 2);
+}
+
+TEST(ADIOS, PluginChunkedSelection) {
+    const size_t rows = 64, cols = 32;
+    std::vector<double> values(rows * cols);
+    for (size_t i = 0; i < values.size(); i++) values[i] = static_cast<double>(i);
+
+    const adios2::Dims start = {10, 4}, count = {20, 8};
+    std::vector<double> readValues(count[0] * count[1]);
+
+    try {
+        adios2::ADIOS adios;
+        adios2::Params params;
+        params["PluginName"] = "LSMIOPlugin";
+        params["PluginLibrary"] = "liblsmio_adios";
+        params["FileName"] = "test-plugin-chunks.db";
+        // four rows per chunk
+        params["ChunkSize"] = std::to_string(4 * cols * sizeof(double));
+
+        adios2::IO wio = adios.DeclareIO("test-plugin-chunks-writer");
+        wio.SetEngine("Plugin");
+        wio.SetParameters(params);
+        adios2::Engine writer = wio.Open("test-plugin-chunks.db", adios2::Mode::Write);
+        adios2::Variable<double> wVar =
+            wio.DefineVariable<double>("field", {rows, cols}, {0, 0}, {rows, cols});
+        writer.Put(wVar, values.data(), adios2::Mode::Sync);
+        writer.Close();
+
+        adios2::IO rio = adios.DeclareIO("test-plugin-chunks-reader");
+        rio.SetEngine("Plugin");
+        rio.SetParameters(params);
+        adios2::Engine reader = rio.Open("test-plugin-chunks.db", adios2::Mode::Read);
+        adios2::Variable<double> rVar = rio.InquireVariable<double>("field");
+        ASSERT_TRUE(rVar);
+        rVar.SetSelection({start, count});
+        reader.Get(rVar, readValues.data(), adios2::Mode::Sync);
+        reader.Close();
+    } catch (const std::exception &e) {
+        FAIL() << "Adios throws an exception: " << e.what() << ".";
+    }
+
+    for (size_t r = 0; r < count[0]; r++) {
+        for (size_t c = 0; c < count[1]; c++) {
+            EXPECT_EQ(readValues[r * count[1] + c], values[(start[0] + r) * cols + start[1] + c]);
+        }
+    }
+}
+
+TEST(ADIOS, PluginMinMaxRange) {
+    const size_t elements = 1024;
+    std::vector<double> values(elements);
+    for (size_t i = 0; i < values.size(); i++) values[i] = static_cast<double>(i);
+
+    std::vector<double> readValues(elements, -1.0);
+    std::pair<double, double> minMax;
+
+    try {
+        adios2::ADIOS adios;
+        adios2::Params params;
+        params["PluginName"] = "LSMIOPlugin";
+        params["PluginLibrary"] = "liblsmio_adios";
+        params["FileName"] = "test-plugin-minmax.db";
+        // 128 values per chunk
+        params["ChunkSize"] = std::to_string(128 * sizeof(double));
+
+        adios2::IO wio = adios.DeclareIO("test-plugin-minmax-writer");
+        wio.SetEngine("Plugin");
+        wio.SetParameters(params);
+        adios2::Engine writer = wio.Open("test-plugin-minmax.db", adios2::Mode::Write);
+        adios2::Variable<double> wVar =
+            wio.DefineVariable<double>("field", {elements}, {0}, {elements});
+        writer.Put(wVar, values.data(), adios2::Mode::Sync);
+        writer.Close();
+
+        // only the chunk holding [128, 255] can match
+        params["ValueRange.field"] = "200:210";
+        adios2::IO rio = adios.DeclareIO("test-plugin-minmax-reader");
+        rio.SetEngine("Plugin");
+        rio.SetParameters(params);
+        adios2::Engine reader = rio.Open("test-plugin-minmax.db", adios2::Mode::Read);
+        adios2::Variable<double> rVar = rio.InquireVariable<double>("field");
+        ASSERT_TRUE(rVar);
+        minMax = rVar.MinMax();
+        reader.Get(rVar, readValues.data(), adios2::Mode::Sync);
+        reader.Close();
+    } catch (const std::exception &e) {
+        FAIL() << "Adios throws an exception: " << e.what() << ".";
+    }
+
+    EXPECT_EQ(minMax.first, 0.0);
+    EXPECT_EQ(minMax.second, static_cast<double>(elements - 1));
+    for (size_t i = 0; i < elements; i++) {
+        EXPECT_EQ(readValues[i], (i >= 128 && i < 256) ? values[i] : -1.0);
+    }
+}
+
+TEST(ADIOS, PluginSpan) {
+    const size_t elements = 256;
+    std::vector<double> readValues(elements);
+
+    try {
+        adios2::ADIOS adios;
+        adios2::Params params;
+        params["PluginName"] = "LSMIOPlugin";
+        params["PluginLibrary"] = "liblsmio_adios";
+        params["FileName"] = "test-plugin-span.db";
+
+        adios2::IO wio = adios.DeclareIO("test-plugin-span-writer");
+        wio.SetEngine("Plugin");
+        wio.SetParameters(params);
+        adios2::Engine writer = wio.Open("test-plugin-span.db", adios2::Mode::Write);
+        adios2::Variable<double> wVar = wio.DefineVariable<double>("field", {}, {}, {elements});
+        writer.BeginStep();
+        adios2::Variable<double>::Span span = writer.Put(wVar);
+        for (size_t i = 0; i < span.size(); i++) span[i] = static_cast<double>(i) / 2;
+        writer.EndStep();
+        writer.Close();
+
+        adios2::IO rio = adios.DeclareIO("test-plugin-span-reader");
+        rio.SetEngine("Plugin");
+        rio.SetParameters(params);
+        adios2::Engine reader = rio.Open("test-plugin-span.db", adios2::Mode::Read);
+        adios2::Variable<double> rVar = rio.InquireVariable<double>("field");
+        ASSERT_TRUE(rVar);
+        reader.Get(rVar, readValues.data(), adios2::Mode::Sync);
+        reader.Close();
+    } catch (const std::exception &e) {
+        FAIL() << "Adios throws an exception: " << e.what() << ".";
+    }
+
+    for (size_t i = 0; i < elements; i++) {
+        EXPECT_EQ(readValues[i], static_cast<double>(i) / 2);
+    }
+}
+
+TEST(ADIOS, PluginDeferredGets) {
+    const size_t variables = 8, count = 4096;
+    std::vector<std::vector<int32_t>> values(variables), readValues(variables);
+    for (size_t v = 0; v < variables; v++) {
+        values[v].assign(count, static_cast<int32_t>(v));
+        readValues[v].resize(count);
+    }
+
+    try {
+        adios2::ADIOS adios;
+        adios2::Params params;
+        params["PluginName"] = "LSMIOPlugin";
+        params["PluginLibrary"] = "liblsmio_adios";
+        params["FileName"] = "test-plugin-deferred-gets.db";
+        params["ChunkSize"] = "1024";
+        params["DecodeThreads"] = "2";
+
+        adios2::IO wio = adios.DeclareIO("test-plugin-deferred-gets-writer");
+        wio.SetEngine("Plugin");
+        wio.SetParameters(params);
+        adios2::Engine writer = wio.Open("test-plugin-deferred-gets.db", adios2::Mode::Write);
+        for (size_t v = 0; v < variables; v++) {
+            adios2::Variable<int32_t> wVar =
+                wio.DefineVariable<int32_t>("field" + std::to_string(v), {}, {}, {count});
+            writer.Put(wVar, values[v].data());
+        }
+        writer.Close();
+
+        adios2::IO rio = adios.DeclareIO("test-plugin-deferred-gets-reader");
+        rio.SetEngine("Plugin");
+        rio.SetParameters(params);
+        adios2::Engine reader = rio.Open("test-plugin-deferred-gets.db", adios2::Mode::Read);
+        // the chunks of every variable are fetched and decoded together
+        for (size_t v = 0; v < variables; v++) {
+            adios2::Variable<int32_t> rVar =
+                rio.InquireVariable<int32_t>("field" + std::to_string(v));
+            ASSERT_TRUE(rVar);
+            reader.Get(rVar, readValues[v].data());
+        }
+        reader.PerformGets();
+        reader.Close();
+    } catch (const std::exception &e) {
+        FAIL() << "Adios throws an exception: " << e.what() << ".";
+    }
+
+    EXPECT_EQ(values, readValues);
+}
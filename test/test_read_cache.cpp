@@ -0,0 +1,96 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <lsmio/manager/read_cache.hpp>
+
+using namespace lsmio;
+
+TEST(ReadCacheTest, GetPut) {
+    LSMIOReadCache cache(1024);
+    std::string value;
+
+    EXPECT_FALSE(cache.get("key1", &value));
+    EXPECT_EQ(cache.misses(), 1);
+
+    cache.put("key1", "value1");
+    EXPECT_TRUE(cache.get("key1", &value));
+    EXPECT_EQ(value, "value1");
+    EXPECT_EQ(cache.hits(), 1);
+
+    cache.put("key1", "value2");
+    EXPECT_TRUE(cache.get("key1", &value));
+    EXPECT_EQ(value, "value2");
+    EXPECT_EQ(cache.sizeBytes(), 10);
+}
+
+TEST(ReadCacheTest, Erase) {
+    LSMIOReadCache cache(1024);
+    std::string value;
+
+    cache.put("key1", "value1");
+    cache.put("key2", "value2");
+    cache.erase("key1");
+    cache.erase("missing");
+
+    EXPECT_FALSE(cache.get("key1", &value));
+    EXPECT_TRUE(cache.get("key2", &value));
+
+    cache.clear();
+    EXPECT_FALSE(cache.get("key2", &value));
+    EXPECT_EQ(cache.sizeBytes(), 0);
+}
+
+TEST(ReadCacheTest, EvictLeastRecentlyUsed) {
+    LSMIOReadCache cache(30);  // room for three 10-byte entries
+    std::string value;
+
+    cache.put("key1", "value1");
+    cache.put("key2", "value2");
+    cache.put("key3", "value3");
+    EXPECT_TRUE(cache.get("key1", &value));  // key2 is now the oldest
+
+    cache.put("key4", "value4");
+    EXPECT_FALSE(cache.get("key2", &value));
+    EXPECT_TRUE(cache.get("key1", &value));
+    EXPECT_TRUE(cache.get("key3", &value));
+    EXPECT_TRUE(cache.get("key4", &value));
+    EXPECT_LE(cache.sizeBytes(), 30);
+}
+
+TEST(ReadCacheTest, OversizedValue) {
+    LSMIOReadCache cache(16);
+    std::string value;
+
+    cache.put("key1", std::string(64, 'x'));
+    EXPECT_FALSE(cache.get("key1", &value));
+    EXPECT_EQ(cache.sizeBytes(), 0);
+}
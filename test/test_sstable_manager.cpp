@@ -31,6 +31,7 @@
 #include <gtest/gtest.h>
 
 #include <filesystem>
+#include <fstream>
 #include <lsmio/manager/store/native/memtable.hpp>
 #include <lsmio/manager/store/native/sstable_manager.hpp>
 
@@ -99,6 +100,76 @@ TEST_F(SSTableManagerTest, Recovery) {
     EXPECT_EQ(val, "val1");
 }
 
+TEST_F(SSTableManagerTest, ReadOnlyRefresh) {
+    std::vector<char> buf(1024);
+    Memtable m1;
+    m1.add("key1", "val1");
+    ASSERT_TRUE(mgr->flushMemtable(m1, buf));
+
+    // a reader of the store while it is still being written
+    SSTableManager reader(dbPath, 0, 0, true);
+    std::string val;
+    EXPECT_TRUE(reader.get("key1", val));
+    EXPECT_EQ(val, "val1");
+
+    Memtable m2;
+    m2.add("key1", "val1b");
+    m2.add("key2", "val2");
+    ASSERT_TRUE(mgr->flushMemtable(m2, buf));
+    EXPECT_FALSE(reader.get("key2", val));
+
+    ASSERT_TRUE(reader.refresh());
+    EXPECT_TRUE(reader.get("key2", val));
+    EXPECT_EQ(val, "val2");
+    EXPECT_TRUE(reader.get("key1", val));
+    EXPECT_EQ(val, "val1b");
+}
+
+TEST_F(SSTableManagerTest, PreAllocatedRefresh) {
+    mgr = std::make_unique<SSTableManager>(dbPath, 1, 4096);
+
+    std::vector<char> buf(1024);
+    Memtable m;
+    m.add("key1", "val1");
+    m.add("key2", "val2");
+    ASSERT_TRUE(mgr->flushMemtable(m, buf));
+    mgr.reset();
+
+    // the table as a reader finds it while it is being flushed: all records, but not yet its
+    // first key length, and zeros up to the pre-allocated size
+    // the pool keeps pre-allocated files ahead, the table is the oldest
+    std::string path;
+    for (const auto& entry : std::filesystem::directory_iterator(dbPath)) {
+        if (path.empty() || entry.path().string() < path) path = entry.path().string();
+    }
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(std::filesystem::file_size(path), 4096u);
+
+    uint32_t key_len = 0;
+    std::fstream table(path, std::ios::binary | std::ios::in | std::ios::out);
+    table.read(reinterpret_cast<char*>(&key_len), sizeof(key_len));
+    EXPECT_EQ(key_len, 4u);
+    const uint32_t unwritten = 0;
+    table.seekp(0);
+    table.write(reinterpret_cast<const char*>(&unwritten), sizeof(unwritten));
+    table.flush();
+
+    SSTableManager reader(dbPath, 0, 0, true);
+    std::string val;
+    EXPECT_FALSE(reader.get("key1", val));
+    EXPECT_FALSE(reader.get("key2", val));
+
+    table.seekp(0);
+    table.write(reinterpret_cast<const char*>(&key_len), sizeof(key_len));
+    table.flush();
+
+    ASSERT_TRUE(reader.refresh());
+    EXPECT_TRUE(reader.get("key1", val));
+    EXPECT_EQ(val, "val1");
+    EXPECT_TRUE(reader.get("key2", val));
+    EXPECT_EQ(val, "val2");
+}
+
 TEST_F(SSTableManagerTest, Tombstone) {
     Memtable m;
     m.add("key1", MEMTABLE_TOMBSTONE);
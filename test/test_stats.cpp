@@ -0,0 +1,114 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <lsmio/manager/manager.hpp>
+#include <lsmio/manager/stats.hpp>
+#include <thread>
+#include <vector>
+
+using namespace lsmio;
+
+TEST(StatsTest, Buckets) {
+    for (uint64_t ns : {0ull, 3ull, 4ull, 7ull, 8ull, 1000ull, 123456789ull}) {
+        size_t bucket = LSMIOStats::bucketOf(ns);
+        EXPECT_GE(LSMIOStats::bucketUpperBound(bucket), ns);
+        if (bucket > 0) EXPECT_LT(LSMIOStats::bucketUpperBound(bucket - 1), ns);
+    }
+    EXPECT_LT(LSMIOStats::bucketOf(UINT64_MAX), LSMIOStats::BUCKETS);
+}
+
+TEST(StatsTest, Percentiles) {
+    LSMIOStats stats;
+
+    for (uint64_t i = 1; i <= 1000; i++) stats.record(StatOp::Put, i * 1000);
+
+    LSMIOStatsSnapshot snap = stats.snapshot();
+    const LSMIOLatency &put = snap[StatOp::Put];
+    EXPECT_EQ(put.count, 1000);
+    EXPECT_EQ(put.maxNs, 1000000);
+    EXPECT_EQ(put.meanNs, 500500);
+    EXPECT_EQ(put.totalNs, 500500000);
+
+    // bucket bounds are at most 25% above the true percentile
+    EXPECT_GE(put.p50Ns, 500000);
+    EXPECT_LE(put.p50Ns, 625000);
+    EXPECT_GE(put.p99Ns, 990000);
+    EXPECT_LE(put.p999Ns, 1000000);
+
+    EXPECT_EQ(snap[StatOp::Get].count, 0);
+
+    stats.reset();
+    EXPECT_EQ(stats.snapshot()[StatOp::Put].count, 0);
+}
+
+TEST(StatsTest, Threads) {
+    LSMIOStats stats;
+    const int threads = 4;
+    const int count = 10000;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&stats]() {
+            for (int i = 0; i < count; i++) {
+                stats.addWrite(2);
+                stats.addRead(1);
+            }
+        });
+    }
+    for (auto &worker : workers) worker.join();
+
+    LSMIOStatsSnapshot snap = stats.snapshot();
+    EXPECT_EQ(snap.writeOps, threads * count);
+    EXPECT_EQ(snap.writeBytes, 2 * threads * count);
+    EXPECT_EQ(snap.readOps, threads * count);
+    EXPECT_EQ(snap.readBytes, threads * count);
+}
+
+TEST(StatsTest, Manager) {
+    LSMIOManager lm("test-stats-manager.db", "", true);
+    std::string value;
+
+    for (int i = 0; i < 16; i++) lm.put("key-" + std::to_string(i), "value");
+    lm.writeBarrier();
+    lm.get("key-0", &value);
+
+    LSMIOStatsSnapshot snap = lm.getStats();
+    EXPECT_EQ(snap.writeOps, 16);
+    EXPECT_EQ(snap.readOps, 1);
+    EXPECT_EQ(snap[StatOp::Put].count, 16);
+    EXPECT_EQ(snap[StatOp::Get].count, 1);
+    EXPECT_EQ(snap[StatOp::Barrier].count, 1);
+    EXPECT_EQ(snap[StatOp::Flush].count, 1);
+
+    lm.resetStats();
+    EXPECT_EQ(lm.getStats().writeOps, 0);
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <lsmio/manager/store/native/store_native.hpp>
+#include <lsmio/manager/store/store_sharded.hpp>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+std::vector<lsmio::LSMIOStore *> openShards(const std::string &dbPath, int count) {
+    std::vector<lsmio::LSMIOStore *> shards;
+    for (int i = 0; i < count; i++) {
+        shards.push_back(new lsmio::LSMIOStoreNative(dbPath + "." + std::to_string(i), true));
+    }
+    return shards;
+}
+
+}  // namespace
+
+TEST(lsmioSharded, Flush) {
+    bool success = true;
+    std::string value;
+
+    lsmio::LSMIOStoreSharded lc("test-sharded-store.db", openShards("test-sharded-store.db", 4));
+    EXPECT_EQ(lc.shardCount(), 4);
+
+    const int count = 64;
+    for (int i = 0; i < count; i++) {
+        success = lc.put("key-" + std::to_string(i), "value-" + std::to_string(i), false);
+        EXPECT_EQ(success, true);
+    }
+
+    success = lc.metaPut("serdar", "alpino", false);
+    EXPECT_EQ(success, true);
+
+    success = lc.del("key-0", false);
+    EXPECT_EQ(success, true);
+
+    success = lc.writeBarrier();
+    EXPECT_EQ(success, true);
+
+    for (int i = 1; i < count; i++) {
+        success = lc.get("key-" + std::to_string(i), &value);
+        EXPECT_EQ(success, true);
+        EXPECT_EQ(value, "value-" + std::to_string(i));
+    }
+
+    success = lc.get("key-0", &value);
+    EXPECT_EQ(success, false);
+
+    success = lc.metaGet("serdar", &value);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(value, "alpino");
+
+    // keys are spread over the shards, the scan has to merge them in order
+    std::vector<std::tuple<std::string, std::string>> values;
+    success = lc.getPrefix("key-", &values);
+    EXPECT_EQ(success, true);
+    EXPECT_EQ(values.size(), count - 1);
+    for (size_t i = 1; i < values.size(); i++) {
+        EXPECT_LT(std::get<0>(values[i - 1]), std::get<0>(values[i]));
+    }
+
+    values.clear();
+    success = lc.metaGetAll(&values);
+    EXPECT_EQ(values.size(), 1);
+}
+
+TEST(lsmioSharded, ByRank) {
+    bool success = true;
+    std::string value;
+
+    lsmio::LSMIOStoreSharded lc("test-sharded-rank.db", openShards("test-sharded-rank.db", 2),
+                                true);
+
+    for (int rank = 0; rank < 4; rank++) {
+        std::string key = std::to_string(rank) + "::key";
+        success = lc.put(key, "value-" + std::to_string(rank));
+        EXPECT_EQ(success, true);
+
+        success = lc.metaPut(key, "meta-" + std::to_string(rank));
+        EXPECT_EQ(success, true);
+    }
+
+    success = lc.writeBarrier();
+    EXPECT_EQ(success, true);
+
+    for (int rank = 0; rank < 4; rank++) {
+        std::string key = std::to_string(rank) + "::key";
+        success = lc.get(key, &value);
+        EXPECT_EQ(success, true);
+        EXPECT_EQ(value, "value-" + std::to_string(rank));
+
+        success = lc.metaGet(key, &value);
+        EXPECT_EQ(success, true);
+        EXPECT_EQ(value, "meta-" + std::to_string(rank));
+    }
+
+    std::vector<std::tuple<std::string, std::string>> values;
+    success = lc.metaGetAll(&values, "3::");
+    EXPECT_EQ(values.size(), 1);
+}
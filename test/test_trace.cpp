@@ -0,0 +1,152 @@
+/*
+ * Copyright 2023 Serdar Bulut
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <lsmio/manager/store/native/store_native.hpp>
+#include <lsmio/manager/trace.hpp>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace lsmio;
+
+TEST(TraceTest, RingWraps) {
+    auto ring = std::make_unique<LSMIOTraceRing>(7);
+    std::vector<TraceRecord> records(LSMIOTraceRing::CAPACITY);
+
+    for (uint64_t i = 0; i < 10; i++) ring->record(TraceEvent::Put, i, 1, i);
+    ASSERT_EQ(ring->snapshot(records.data()), 10);
+    EXPECT_EQ(records[0].arg, 0);
+    EXPECT_EQ(records[9].arg, 9);
+    EXPECT_EQ(ring->thread(), 7);
+
+    // only the most recent CAPACITY events survive, oldest first
+    uint64_t total = LSMIOTraceRing::CAPACITY + 10;
+    for (uint64_t i = 10; i < total; i++) ring->record(TraceEvent::Get, i, 2, i);
+    ASSERT_EQ(ring->snapshot(records.data()), LSMIOTraceRing::CAPACITY);
+    EXPECT_EQ(records.front().arg, 10);
+    EXPECT_EQ(records.back().arg, total - 1);
+}
+
+TEST(TraceTest, DumpAllThreads) {
+    const uint64_t marker = 0x7ace;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 100; i++) LSMIOTrace::record(TraceEvent::Send, marker, t);
+        });
+    }
+    for (auto &thread : threads) thread.join();
+
+    // rings outlive their threads
+    std::stringstream ss;
+    LSMIOTrace::dump(ss);
+
+    std::string line;
+    int count = 0;
+    while (std::getline(ss, line)) {
+        if (line.find(" send " + std::to_string(marker) + " ") != std::string::npos) count++;
+    }
+    EXPECT_EQ(count, 400);
+}
+
+TEST(TraceTest, MacroElision) {
+    int evaluated = 0;
+    LSMIO_TRACE(Put, ++evaluated);
+    LSMIO_TRACE2(Get, ++evaluated, 0);
+
+#ifdef LSMIO_ENABLE_TRACE
+    EXPECT_EQ(evaluated, 2);
+#else
+    EXPECT_EQ(evaluated, 0);
+#endif
+}
+
+class TraceSpansTest : public ::testing::Test {
+  protected:
+    std::string test_dir = "test_trace_dir";
+    void SetUp() override {
+        if (std::filesystem::exists(test_dir)) std::filesystem::remove_all(test_dir);
+        std::filesystem::create_directory(test_dir);
+    }
+    void TearDown() override {
+        if (std::filesystem::exists(test_dir)) std::filesystem::remove_all(test_dir);
+    }
+};
+
+TEST_F(TraceSpansTest, Disabled) {
+    const std::string path = test_dir + "/test-trace-disabled.json";
+    LSMIOTrace::clearSpans();
+    { LSMIOSpan span("test.disabled"); }
+
+    ASSERT_TRUE(LSMIOTrace::writeSpans(path));
+    std::ifstream file(path);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    EXPECT_EQ(ss.str().find("test.disabled"), std::string::npos);
+}
+
+TEST_F(TraceSpansTest, ChromeJson) {
+    const std::string path = test_dir + "/test-trace-spans.json";
+    LSMIOTrace::clearSpans();
+    LSMIOTrace::enableSpans(3);
+    {
+        LSMIOStoreNative store(test_dir + "/test-trace-native.db", true);
+        EXPECT_TRUE(store.put("key", std::string(100, 'x'), false));
+        EXPECT_TRUE(store.writeBarrier());
+        store.close();
+    }
+    std::thread([] { LSMIOSpan span("test.thread", 42); }).join();
+    LSMIOTrace::disableSpans();
+
+    ASSERT_TRUE(LSMIOTrace::writeSpans(path));
+    std::ifstream file(path);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    const std::string json = ss.str();
+
+    EXPECT_EQ(json.find("{\"traceEvents\":["), 0);
+    EXPECT_NE(json.find("\"name\":\"rank 3\""), std::string::npos);
+    EXPECT_NE(json.find("\"native.batchMutation\""), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"size\":42"), std::string::npos);
+    EXPECT_NE(json.find("\"droppedSpans\":0"), std::string::npos);
+
+    // written spans are cleared
+    ASSERT_TRUE(LSMIOTrace::writeSpans(path));
+    std::ifstream again(path);
+    std::stringstream ss2;
+    ss2 << again.rdbuf();
+    EXPECT_EQ(ss2.str().find("native.batchMutation"), std::string::npos);
+}